@@ -0,0 +1,123 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "allocationcounter.h"
+
+#include <cstdlib>
+#include <new>
+
+// These are updated from any thread, and must not allocate themselves
+static qint64 allocationCount = 0;
+static qint64 allocationBytes = 0;
+
+static inline void countAllocation(size_t size)
+{
+#ifdef __GNUC__
+    __sync_fetch_and_add(&allocationCount, 1);
+    __sync_fetch_and_add(&allocationBytes, (qint64)size);
+#else
+    allocationCount++;
+    allocationBytes += size;
+#endif
+}
+
+
+#ifdef __GLIBC__
+
+// Replacing malloc() in the executable also catches the allocations made inside the Qt libraries
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+
+void *malloc(size_t size)
+{
+    countAllocation(size);
+    return __libc_malloc(size);
+}
+
+
+void *calloc(size_t count, size_t size)
+{
+    countAllocation(count * size);
+    return __libc_calloc(count, size);
+}
+
+
+void *realloc(void *ptr, size_t size)
+{
+    countAllocation(size);
+    return __libc_realloc(ptr, size);
+}
+}
+
+#else
+
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+    countAllocation(size);
+    void *ptr = std::malloc(size ? size : 1);
+    if (!ptr)
+        throw std::bad_alloc();
+    return ptr;
+}
+
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+    return operator new(size);
+}
+
+
+void operator delete(void *ptr) throw()
+{
+    std::free(ptr);
+}
+
+
+void operator delete[](void *ptr) throw()
+{
+    std::free(ptr);
+}
+
+#endif
+
+
+AllocationCounter::Count AllocationCounter::Count::operator-(const Count &other) const
+{
+    Count result;
+    result.allocations = allocations - other.allocations;
+    result.bytes = bytes - other.bytes;
+    return result;
+}
+
+
+AllocationCounter::Count AllocationCounter::current()
+{
+    Count count;
+#ifdef __GNUC__
+    count.allocations = __sync_fetch_and_add(&allocationCount, 0);
+    count.bytes = __sync_fetch_and_add(&allocationBytes, 0);
+#else
+    count.allocations = allocationCount;
+    count.bytes = allocationBytes;
+#endif
+    return count;
+}
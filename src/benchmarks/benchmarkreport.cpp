@@ -0,0 +1,102 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "benchmarkreport.h"
+
+#include <QStringList>
+#include <QTextStream>
+
+#include <cstdio>
+
+BenchmarkReport::BenchmarkReport()
+{
+    Metrics::enable();
+}
+
+
+void BenchmarkReport::start()
+{
+    _allocations = AllocationCounter::current();
+    _timer = Metrics::Timer();
+}
+
+
+qint64 BenchmarkReport::finish(const QString &stage, qint64 items)
+{
+    qint64 usecs = _timer.elapsed();
+    AllocationCounter::Count allocations = AllocationCounter::current() - _allocations;
+    add(stage, items, usecs, allocations.allocations, allocations.bytes);
+    return usecs;
+}
+
+
+void BenchmarkReport::add(const QString &stage, qint64 items, qint64 usecs, qint64 allocations, qint64 bytes)
+{
+    Row row;
+    row.stage = stage;
+    row.items = items;
+    row.usecs = usecs;
+    row.allocations = allocations;
+    row.bytes = bytes;
+    _rows << row;
+}
+
+
+void BenchmarkReport::addValue(const QString &name, const QString &value)
+{
+    _values << qMakePair(name, value);
+}
+
+
+QString BenchmarkReport::toString() const
+{
+    QString report = "stage\titems\tmsecs\titems/s\tallocs\tallocs/item\tKiB allocated\n";
+    foreach(const Row &row, _rows) {
+        QStringList columns;
+        columns << row.stage
+                << QString::number(row.items)
+                << QString::number(row.usecs / 1000.0, 'f', 1)
+                << (row.items > 0 && row.usecs > 0 ? QString::number(row.items * 1000000 / row.usecs) : QString("-"));
+        if (row.allocations >= 0) {
+            columns << QString::number(row.allocations)
+                    << (row.items > 0 ? QString::number((double)row.allocations / row.items, 'f', 1) : QString("-"))
+                    << QString::number(row.bytes / 1024);
+        }
+        else {
+            columns << "-" << "-" << "-";
+        }
+        report += columns.join("\t") + '\n';
+    }
+
+    if (!_values.isEmpty()) {
+        report += '\n';
+        for (int i = 0; i < _values.count(); i++)
+            report += _values.at(i).first + '\t' + _values.at(i).second + '\n';
+    }
+    return report;
+}
+
+
+void BenchmarkReport::print() const
+{
+    QTextStream out(stdout);
+    out << toString();
+    out.flush();
+}
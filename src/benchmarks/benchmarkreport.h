@@ -0,0 +1,82 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef BENCHMARKREPORT_H
+#define BENCHMARKREPORT_H
+
+#include <QList>
+#include <QPair>
+#include <QString>
+
+#include "allocationcounter.h"
+#include "metrics.h"
+
+//! Collects the results of a benchmark run, one row per measured stage
+/** A stage is either measured directly between start() and finish(), or added with numbers that
+ *  were measured elsewhere (e.g. taken from Metrics). The report is printed as tab-separated
+ *  columns, so that it can be compared between runs with the usual tools.
+ *
+ *  Creating a report enables Metrics, which provides the timers and the per-stage numbers.
+ */
+class BenchmarkReport
+{
+public:
+    BenchmarkReport();
+
+    //! Starts measuring time and allocations for the next stage
+    void start();
+
+    //! Finishes the stage begun with start()
+    /** \param items  The number of items (lines, messages, buffers...) processed in the stage
+     *  \return The duration of the stage in microseconds
+     */
+    qint64 finish(const QString &stage, qint64 items);
+
+    //! Adds a stage measured elsewhere
+    /** Negative allocation values are shown as unknown, as are the rates of stages without items.
+     */
+    void add(const QString &stage, qint64 items, qint64 usecs, qint64 allocations = -1, qint64 bytes = -1);
+
+    //! Adds a value that is not a timing, like a size on disk
+    void addValue(const QString &name, const QString &value);
+
+    QString toString() const;
+
+    //! Prints the report to stdout
+    void print() const;
+
+private:
+    struct Row {
+        QString stage;
+        qint64 items;
+        qint64 usecs;
+        qint64 allocations;
+        qint64 bytes;
+    };
+
+    QList<Row> _rows;
+    QList<QPair<QString, QString> > _values;
+
+    Metrics::Timer _timer;
+    AllocationCounter::Count _allocations;
+};
+
+
+#endif
@@ -0,0 +1,51 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "benchmarkui.h"
+
+#include "chatlinemodel.h"
+#include "contextmenuactionprovider.h"
+#include "qtuimessageprocessor.h"
+#include "qtuistyle.h"
+
+BenchmarkUi::BenchmarkUi(QObject *parent)
+    : GraphicalUi(parent)
+{
+    setContextMenuActionProvider(new ContextMenuActionProvider(this));
+    setUiStyle(new QtUiStyle(this));
+}
+
+
+void BenchmarkUi::init()
+{
+    // no main widget to set up
+}
+
+
+MessageModel *BenchmarkUi::createMessageModel(QObject *parent)
+{
+    return new ChatLineModel(parent);
+}
+
+
+AbstractMessageProcessor *BenchmarkUi::createMessageProcessor(QObject *parent)
+{
+    return new QtUiMessageProcessor(parent);
+}
@@ -0,0 +1,43 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef BENCHMARKUI_H
+#define BENCHMARKUI_H
+
+#include "graphicalui.h"
+
+//! A GraphicalUi without any windows, for running the client's models and views headless
+/** It provides what QtUi provides to the chat views, i.e. the QtUiStyle and the ChatLineModel and
+ *  QtUiMessageProcessor, but neither creates a MainWin nor connects to a core.
+ */
+class BenchmarkUi : public GraphicalUi
+{
+    Q_OBJECT
+
+public:
+    BenchmarkUi(QObject *parent = 0);
+
+    void init();
+    MessageModel *createMessageModel(QObject *parent);
+    AbstractMessageProcessor *createMessageProcessor(QObject *parent);
+};
+
+
+#endif
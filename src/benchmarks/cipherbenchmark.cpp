@@ -0,0 +1,158 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "cipherbenchmark.h"
+
+#include <QDebug>
+
+#include "benchmarkreport.h"
+#include "cipher.h"
+
+// what CoreUserInputHandler::lastParamMaxLength() guesses for a PRIVMSG to #channel before we know our own prefix
+static const int maxLineLength = 480 - 7 - 9 - 2;
+static const char *splitter = " .,-";
+
+CipherBenchmark::CipherBenchmark(BenchmarkReport *report)
+    : _report(report)
+{
+}
+
+
+void CipherBenchmark::run(int messageCount, int messageLength)
+{
+    static const QByteArray text("Lorem ipsum dolor sit amet, consectetur adipisici elit, sed eiusmod tempor incidunt ut labore et dolore magna aliqua. ");
+
+    QList<QByteArray> messages;
+    QList<QByteArray> longMessages;
+    for (int i = 0; i < messageCount; i++) {
+        QByteArray message = QByteArray::number(i) + ' ';
+        while (message.count() < 5 * messageLength)
+            message += text;
+        messages << message.left(messageLength);
+        longMessages << message.left(5 * messageLength);
+    }
+
+    runCipher("ecb", "benchmark key", messages, longMessages);
+    runCipher("cbc", "cbc:benchmark key", messages, longMessages);
+}
+
+
+void CipherBenchmark::runCipher(const QString &name, const QByteArray &key, const QList<QByteArray> &messages, const QList<QByteArray> &longMessages)
+{
+    Cipher cipher(key);
+
+    QList<QByteArray> encrypted;
+    _report->start();
+    foreach(QByteArray message, messages) {
+        cipher.encrypt(message);
+        encrypted << message;
+    }
+    _report->finish(name + ": encrypt", messages.count());
+
+    int failed = 0;
+    _report->start();
+    for (int i = 0; i < encrypted.count(); i++) {
+        // decrypt() appends " \n" to the message, like the legacy FiSH code did
+        if (!cipher.decrypt(encrypted.at(i)).startsWith(messages.at(i)))
+            failed++;
+    }
+    _report->finish(name + ": decrypt", encrypted.count());
+    if (failed)
+        qWarning() << "Decrypting" << failed << "of" << encrypted.count() << name << "messages did not give the original message";
+
+    int predictedLines = 0;
+    _report->start();
+    foreach(const QByteArray &message, longMessages)
+        predictedLines += splitPredicted(message, &cipher).count();
+    _report->finish(name + ": split, predicted", longMessages.count());
+
+    int trialLines = 0;
+    _report->start();
+    foreach(const QByteArray &message, longMessages)
+        trialLines += splitByTrial(message, &cipher).count();
+    _report->finish(name + ": split, trial encryption", longMessages.count());
+
+    _report->addValue(name + ": lines per long message, predicted", QString::number((double)predictedLines / longMessages.count(), 'f', 2));
+    _report->addValue(name + ": lines per long message, trial encryption", QString::number((double)trialLines / longMessages.count(), 'f', 2));
+}
+
+
+// the split of CoreUserInputHandler::putPrivmsg()
+QList<QByteArray> CipherBenchmark::splitPredicted(const QByteArray &message, Cipher *cipher) const
+{
+    QList<QByteArray> lines;
+    QByteArray rest = message;
+    int maxSplitPos = cipher->maxPlainLength(rest, maxLineLength);
+    while (!rest.isEmpty() && maxSplitPos > 0) {
+        int splitPos = rest.count();
+        if (splitPos > maxSplitPos) {
+            splitPos = -1;
+            for (const char *splitChar = splitter; *splitChar != 0; splitChar++) {
+                splitPos = qMax(splitPos, rest.lastIndexOf(*splitChar, maxSplitPos - 1) + 1); // keep split char on old line
+            }
+            if (splitPos <= 0)
+                splitPos = maxSplitPos;
+        }
+
+        QByteArray line = rest.left(splitPos);
+        if (!cipher->encrypt(line))
+            break;
+        lines << line;
+        rest = rest.mid(splitPos);
+    }
+    return lines;
+}
+
+
+// the split putPrivmsg() did before Cipher could predict the length of the encrypted line
+QList<QByteArray> CipherBenchmark::splitByTrial(const QByteArray &message, Cipher *cipher) const
+{
+    QList<QByteArray> lines;
+    QByteArray rest = message;
+    while (!rest.isEmpty()) {
+        int maxSplitPos = rest.count();
+        int splitPos = maxSplitPos;
+        forever {
+            QByteArray crypted = rest.left(splitPos);
+            if (!cipher->encrypt(crypted))
+                return lines;
+
+            int overrun = qMax(crypted.count() - maxLineLength, 0);
+            if (overrun) {
+                splitPos = -1;
+                for (const char *splitChar = splitter; *splitChar != 0; splitChar++) {
+                    splitPos = qMax(splitPos, rest.lastIndexOf(*splitChar, maxSplitPos) + 1); // keep split char on old line
+                }
+                if (splitPos <= 0 || splitPos > maxSplitPos)
+                    splitPos = maxSplitPos;
+
+                maxSplitPos = splitPos - 1;
+                if (maxSplitPos <= 0)
+                    return lines;
+                continue;
+            }
+
+            lines << crypted;
+            rest = rest.mid(splitPos);
+            break;
+        }
+    }
+    return lines;
+}
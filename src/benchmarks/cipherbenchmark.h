@@ -0,0 +1,55 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef CIPHERBENCHMARK_H
+#define CIPHERBENCHMARK_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+class BenchmarkReport;
+class Cipher;
+
+//! Measures the FiSH/mircryption en- and decryption done by Cipher
+/** Messages are en- and decrypted in ECB and in CBC mode, as for an encrypted channel. For messages
+ *  that are too long for one line, the report also compares finding the split positions with
+ *  Cipher::maxPlainLength(), as CoreUserInputHandler::putPrivmsg() does, with the loop it replaced,
+ *  which encrypted shorter and shorter prefixes until the line fit.
+ */
+class CipherBenchmark
+{
+public:
+    CipherBenchmark(BenchmarkReport *report);
+
+    //! En- and decrypts \p messageCount messages of \p messageLength bytes, and splits as many messages five times as long
+    void run(int messageCount, int messageLength);
+
+private:
+    void runCipher(const QString &name, const QByteArray &key, const QList<QByteArray> &messages, const QList<QByteArray> &longMessages);
+
+    QList<QByteArray> splitPredicted(const QByteArray &message, Cipher *cipher) const;
+    QList<QByteArray> splitByTrial(const QByteArray &message, Cipher *cipher) const;
+
+    BenchmarkReport *_report;
+};
+
+
+#endif
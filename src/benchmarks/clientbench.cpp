@@ -0,0 +1,93 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include <cstdlib>
+
+#include "benchmarkreport.h"
+#include "clientbenchmark.h"
+#include "clientbenchmarkapplication.h"
+#include "cliparser.h"
+#include "quassel.h"
+#include "scratchdir.h"
+
+// Runs the client's models and chat views on synthetic data and prints how long each stage took
+int main(int argc, char **argv)
+{
+    Quassel::setupBuildInfo();
+    QCoreApplication::setApplicationName("quasselbench-client");
+    QCoreApplication::setOrganizationName(Quassel::buildInfo().organizationName);
+    QCoreApplication::setOrganizationDomain(Quassel::buildInfo().organizationDomain);
+
+#if QT_VERSION >= 0x050000
+    // no display needed, so this runs on build servers as well
+    if (qgetenv("QT_QPA_PLATFORM").isEmpty())
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+#endif
+
+    Q_INIT_RESOURCE(pics);
+#ifdef EMBED_DATA
+    Q_INIT_RESOURCE(data);
+#endif
+
+    CliParser *cliParser = new CliParser();
+    Quassel::setCliParser(cliParser);
+    cliParser->addSwitch("debug", 'd', "Enable debug output");
+    cliParser->addSwitch("help", 'h', "Display this help and exit");
+    cliParser->addSwitch("version", 'v', "Display version information");
+    cliParser->addOption("configdir <path>", 'c', "Set by the benchmark");
+    cliParser->addOption("datadir <path>", 0, "DEPRECATED - Use --configdir instead");
+    cliParser->addOption("qss <file.qss>", 0, "Load a custom application stylesheet");
+    cliParser->addSwitch("debugbufferswitches", 0, "Enables debugging for bufferswitches");
+    cliParser->addSwitch("debugmodel", 0, "Enables debugging for models");
+    cliParser->addOption("messages <count>", 0, "Number of messages to render", QString("10000"));
+    cliParser->addOption("networks <count>", 0, "Number of networks the buffers are spread over", QString("10"));
+    cliParser->addOption("buffers <count>", 0, "Number of buffers in the network model and buffer view", QString("5000"));
+    cliParser->addOption("cache-buffers <count>", 0, "Number of buffers loaded on connect with a cold and a warm backlog cache", QString("500"));
+    cliParser->addOption("backlog <count>", 0, "Number of messages shown per buffer on connect", QString("100"));
+
+    // don't pick up the settings of the user running this
+    ScratchDir configDir("quasselbench-client");
+    if (!configDir.isValid())
+        return EXIT_FAILURE;
+
+    int exitCode = EXIT_FAILURE;
+    {
+        ClientBenchmarkApplication app(argc, argv);
+
+        QStringList args = app.arguments();
+        args << "--configdir=" + configDir.path();
+        if (cliParser->init(args) && app.init()) {
+            BenchmarkReport report;
+            ClientBenchmark benchmark(&report);
+            benchmark.runRendering(Quassel::optionValue("messages").toInt());
+            int networks = qMax(1, Quassel::optionValue("networks").toInt());
+            int buffers = Quassel::optionValue("buffers").toInt();
+            benchmark.runNetworkModel(networks, buffers);
+            benchmark.runBufferViews(networks, buffers);
+            benchmark.runBacklogCache(Quassel::optionValue("cache-buffers").toInt(), qMax(1, Quassel::optionValue("backlog").toInt()));
+            report.print();
+            exitCode = EXIT_SUCCESS;
+        }
+        else if (Quassel::isOptionSet("help")) {
+            exitCode = EXIT_SUCCESS;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,313 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "clientbenchmark.h"
+
+#include <QDataStream>
+
+#include "backlogcache.h"
+#include "benchmarkreport.h"
+#include "buffermodel.h"
+#include "bufferviewconfig.h"
+#include "bufferviewfilter.h"
+#include "chatlinemodel.h"
+#include "chatlinemodelitem.h"
+#include "chatscene.h"
+#include "chatview.h"
+#include "chatviewsearchcontroller.h"
+#include "client.h"
+#include "messagefilter.h"
+#include "networkmodel.h"
+#include "uistyle.h"
+
+ClientBenchmark::ClientBenchmark(BenchmarkReport *report)
+    : _report(report)
+{
+}
+
+
+QList<Message> ClientBenchmark::createMessages(int count)
+{
+    BufferInfo bufferInfo(BufferId(-1), NetworkId(-1), BufferInfo::ChannelBuffer, 0, "#benchmark");
+
+    // plain, heavily mIRC-colored, URL-dense and very long messages
+    QStringList contents;
+    contents << "Lorem ipsum dolor sit amet, consectetur adipisici elit, sed eiusmod tempor incidunt ut labore et dolore magna aliqua.";
+    contents << "\x02" "bold" "\x02 \x03" "4red\x03 \x03" "3,1green on black\x03 \x1f" "underlined\x1f \x16reversed\x16 \x1d" "italic\x1d "
+                "\x03" "12b\x03" "13l\x03" "7u\x03" "8r\x03" "9p\x03" "10!\x0f plain again";
+    contents << "see http://quassel-irc.org/ and https://bugs.quassel-irc.org/projects/quassel-irc/issues?set_filter=1, "
+                "www.example.com/a/b/c, ftp://ftp.example.org/pub/file.tar.gz or mailto:someone@example.com";
+    contents << QString("This is a very long line which needs to be wrapped many times. ").repeated(20);
+
+    QList<Message> messages;
+    for (int i = 0; i < count; i++) {
+        Message msg(bufferInfo, Message::Plain, contents.at(i % contents.count()), QString("nick%1!user@host.example.com").arg(i % 50));
+        msg.setMsgId(MsgId(i + 1));
+        messages << msg;
+    }
+    return messages;
+}
+
+
+QList<BufferInfo> ClientBenchmark::createBuffers(int networkCount, int bufferCount)
+{
+    // a status buffer per network, then mostly channels with every fifth buffer a query
+    QList<BufferInfo> buffers;
+    for (int i = 0; i < bufferCount; i++) {
+        NetworkId networkId(i % networkCount + 1);
+        BufferId bufferId(i + 1);
+        if (i < networkCount)
+            buffers << BufferInfo(bufferId, networkId, BufferInfo::StatusBuffer);
+        else if (i % 5 == 0)
+            buffers << BufferInfo(bufferId, networkId, BufferInfo::QueryBuffer, 0, QString("nick%1").arg(i));
+        else
+            buffers << BufferInfo(bufferId, networkId, BufferInfo::ChannelBuffer, 0, QString("#channel%1").arg(i));
+    }
+    return buffers;
+}
+
+
+int ClientBenchmark::countRows(const QAbstractItemModel *model, const QModelIndex &parent)
+{
+    // asking a proxy for its rows makes it filter them
+    int rows = model->rowCount(parent);
+    int count = rows;
+    for (int row = 0; row < rows; row++)
+        count += countRows(model, model->index(row, 0, parent));
+    return count;
+}
+
+
+void ClientBenchmark::runRendering(int messageCount)
+{
+    QList<Message> messages = createMessages(messageCount);
+
+    _report->start();
+    foreach(const Message &msg, messages) {
+        UiStyle::StyledMessage styledMsg(msg);
+        styledMsg.plainContents();
+    }
+    _report->finish("style", messageCount);
+
+    _report->start();
+    foreach(const Message &msg, messages) {
+        ChatLineModelItem item(msg);
+        item.data(ChatLineModel::ContentsColumn, ChatLineModel::WrapListRole);
+    }
+    _report->finish("wraplist", messageCount);
+
+    ChatLineModel model;
+    _report->start();
+    model.insertMessages(messages);
+    _report->finish("insert", messageCount);
+
+    _report->start();
+    MessageFilter filter(&model, QList<BufferId>() << messages.first().bufferId());
+    int rows = filter.rowCount();
+    _report->finish("filter", rows);
+
+    _report->start();
+    ChatView view(&filter);
+    ChatScene *scene = view.scene();
+    scene->setWidth(800);
+    _report->finish("scene", rows);
+
+    _report->start();
+    scene->setWidth(400);
+    _report->finish("relayout", rows);
+
+    ChatViewSearchController searchController;
+    searchController.setScene(scene);
+    _report->start();
+    searchController.setSearchString("http");
+    _report->finish("search", rows);
+}
+
+
+void ClientBenchmark::runNetworkModel(int networkCount, int bufferCount)
+{
+    NetworkModel *model = Client::networkModel();
+    QList<BufferInfo> buffers = createBuffers(networkCount, bufferCount);
+
+    _report->start();
+    foreach(const BufferInfo &bufferInfo, buffers)
+        model->bufferUpdated(bufferInfo);
+    _report->finish("networkmodel: add", bufferCount);
+
+    // ten messages for every buffer, as they arrive interleaved
+    QList<Message> messages;
+    for (int i = 0; i < 10 * bufferCount; i++) {
+        Message msg(buffers.at(i % bufferCount), Message::Plain, "Lorem ipsum dolor sit amet", QString("nick%1!user@host.example.com").arg(i % 50));
+        msg.setMsgId(MsgId(i + 1));
+        messages << msg;
+    }
+    _report->start();
+    for (int i = 0; i < messages.count(); i++)
+        model->updateBufferActivity(messages[i]);
+    _report->finish("networkmodel: activity", messages.count());
+
+    _report->start();
+    model->allBufferIdsSorted();
+    _report->finish("networkmodel: sort", bufferCount);
+
+    _report->start();
+    foreach(const BufferInfo &bufferInfo, buffers)
+        model->bufferId(bufferInfo.networkId(), bufferInfo.bufferName());
+    _report->finish("networkmodel: find by name", bufferCount);
+
+    _report->start();
+    foreach(const BufferInfo &bufferInfo, buffers)
+        model->removeBuffer(bufferInfo.bufferId());
+    _report->finish("networkmodel: remove", bufferCount);
+}
+
+
+void ClientBenchmark::runBufferViews(int networkCount, int bufferCount)
+{
+    NetworkModel *model = Client::networkModel();
+    QList<BufferInfo> buffers = createBuffers(networkCount, bufferCount);
+    foreach(const BufferInfo &bufferInfo, buffers)
+        model->bufferUpdated(bufferInfo);
+
+    BufferViewConfig config(1);
+    config.setBufferViewName("All Chats");
+    config.setInitialized();
+
+    _report->start();
+    foreach(const BufferInfo &bufferInfo, buffers)
+        config.addBuffer(bufferInfo.bufferId(), config.bufferList().count());
+    _report->finish("bufferview: add", bufferCount);
+
+    _report->start();
+    foreach(const BufferInfo &bufferInfo, buffers)
+        config.containsBuffer(bufferInfo.bufferId());
+    _report->finish("bufferview: contains", bufferCount);
+
+    // dragging every tenth buffer to the top
+    _report->start();
+    for (int i = 0; i < bufferCount; i += 10)
+        config.moveBuffer(buffers.at(i).bufferId(), 0);
+    _report->finish("bufferview: move", (bufferCount + 9) / 10);
+
+    _report->start();
+    BufferViewFilter *filter = new BufferViewFilter(Client::bufferModel(), &config);
+    int rows = countRows(filter);
+    _report->finish("bufferview: filter", rows);
+
+    // every change of the config filters the whole view again
+    const int removals = qMin(bufferCount, 100);
+    _report->start();
+    for (int i = 0; i < removals; i++) {
+        config.removeBuffer(buffers.at(bufferCount - 1 - i).bufferId());
+        countRows(filter);
+    }
+    _report->finish("bufferview: remove and refilter", removals);
+
+    delete filter;
+    foreach(const BufferInfo &bufferInfo, buffers)
+        model->removeBuffer(bufferInfo.bufferId());
+}
+
+
+int ClientBenchmark::connectToCore(AccountId accountId, const QHash<BufferId, MessageList> &stored, int limit, qint64 *bytes)
+{
+    // a new cache instance, as every session opens its own
+    BacklogCache cache(accountId, (qint64)1024 * 1024 * 1024, limit);
+    ChatLineModel model;
+
+    int shown = 0;
+    *bytes = 0;
+    QHash<BufferId, MessageList>::const_iterator iter;
+    for (iter = stored.constBegin(); iter != stored.constEnd(); ++iter) {
+        // what the core replies to the request of BacklogRequester::addRequest(), as it goes over the wire
+        MsgId cachedMsgId = cache.lastMsgId(iter.key());
+        QVariantList reply;
+        for (int i = iter->count() - 1; i >= 0 && reply.count() < limit; i--) {
+            if (cachedMsgId.isValid() && iter->at(i).msgId() <= cachedMsgId)
+                break;
+            reply.prepend(qVariantFromValue(iter->at(i)));
+        }
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_4_2);
+        out << reply;
+        *bytes += data.size();
+
+        // the client's part, see ClientBacklogManager::processBacklog()
+        QDataStream in(data);
+        in.setVersion(QDataStream::Qt_4_2);
+        QVariantList received;
+        in >> received;
+        MessageList msglist;
+        foreach(const QVariant &v, received)
+            msglist << v.value<Message>();
+
+        MessageList shownList;
+        if (cachedMsgId.isValid() && msglist.count() < limit)
+            shownList = cache.messages(iter.key(), limit - msglist.count());
+        else
+            cache.remove(iter.key());
+        cache.append(msglist);
+        shownList += msglist;
+
+        model.insertMessages(shownList);
+        shown += shownList.count();
+    }
+    return shown;
+}
+
+
+void ClientBenchmark::runBacklogCache(int bufferCount, int limit)
+{
+    QList<BufferInfo> buffers = createBuffers(1, bufferCount);
+
+    // a page for every buffer, then a tenth of that arriving while the client is away, all interleaved
+    const int awayMessages = qMax(1, limit / 10);
+    QHash<BufferId, MessageList> stored;
+    int msgId = 0;
+    for (int i = 0; i < limit; i++) {
+        foreach(const BufferInfo &bufferInfo, buffers) {
+            Message msg(bufferInfo, Message::Plain, "Lorem ipsum dolor sit amet, consectetur adipisici elit", QString("nick%1!user@host.example.com").arg(i % 50));
+            msg.setMsgId(MsgId(++msgId));
+            stored[bufferInfo.bufferId()] << msg;
+        }
+    }
+    QHash<BufferId, MessageList> later = stored;
+    for (int i = 0; i < awayMessages; i++) {
+        foreach(const BufferInfo &bufferInfo, buffers) {
+            Message msg(bufferInfo, Message::Plain, "Lorem ipsum dolor sit amet, consectetur adipisici elit", QString("nick%1!user@host.example.com").arg(i % 50));
+            msg.setMsgId(MsgId(++msgId));
+            later[bufferInfo.bufferId()] << msg;
+        }
+    }
+
+    // both connects see the same backlog, but only the second account has been connected before
+    qint64 bytes;
+    _report->start();
+    int shown = connectToCore(AccountId(1), later, limit, &bytes);
+    _report->finish("backlog connect: cold cache", shown);
+    _report->addValue("backlog connect: cold cache bytes received", QString::number(bytes));
+
+    connectToCore(AccountId(2), stored, limit, &bytes);
+    _report->start();
+    shown = connectToCore(AccountId(2), later, limit, &bytes);
+    _report->finish("backlog connect: warm cache", shown);
+    _report->addValue("backlog connect: warm cache bytes received", QString::number(bytes));
+}
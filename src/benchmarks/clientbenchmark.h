@@ -0,0 +1,76 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef CLIENTBENCHMARK_H
+#define CLIENTBENCHMARK_H
+
+#include <QAbstractItemModel>
+#include <QHash>
+#include <QList>
+
+#include "message.h"
+#include "types.h"
+
+class BenchmarkReport;
+
+//! Measures the client's models and message rendering pipeline on synthetic data
+/** Everything goes through the same classes as real data (styling, wrap lists, ChatLineModel,
+ *  MessageFilter, ChatScene, search, the NetworkModel and BufferViewFilter), so the client must have
+ *  been initialized, e.g. by a ClientBenchmarkApplication. The chat pipeline runs on private
+ *  instances, the buffers are added to the client's NetworkModel.
+ */
+class ClientBenchmark
+{
+public:
+    ClientBenchmark(BenchmarkReport *report);
+
+    //! Styles, wraps, inserts, filters, lays out and searches \p messageCount messages
+    void runRendering(int messageCount);
+
+    //! Adds \p bufferCount buffers on \p networkCount networks to the NetworkModel and updates them
+    void runNetworkModel(int networkCount, int bufferCount);
+
+    //! Fills a BufferViewConfig with \p bufferCount buffers and filters the NetworkModel through it
+    void runBufferViews(int networkCount, int bufferCount);
+
+    //! Loads the backlog of \p bufferCount buffers on connect, with an empty and with a filled BacklogCache
+    /** \param limit The number of messages shown per buffer, as set for the fixed backlog requester
+     */
+    void runBacklogCache(int bufferCount, int limit);
+
+private:
+    //! Receives the backlog of the buffers like on connect, using the BacklogCache of the given account
+    /** The core sends the newest \p limit messages of each buffer, but only those newer than the cached ones.
+     *  The rest is read from the cache, everything received is appended to it.
+     *  \param stored  The messages the core has stored, per buffer in ascending order
+     *  \param bytes   Set to the number of bytes the core sent
+     *  \return The number of messages shown
+     */
+    static int connectToCore(AccountId accountId, const QHash<BufferId, MessageList> &stored, int limit, qint64 *bytes);
+
+    static QList<Message> createMessages(int count);
+    static QList<BufferInfo> createBuffers(int networkCount, int bufferCount);
+    static int countRows(const QAbstractItemModel *model, const QModelIndex &parent = QModelIndex());
+
+    BenchmarkReport *_report;
+};
+
+
+#endif
@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "clientbenchmarkapplication.h"
+
+#include "benchmarkui.h"
+#include "client.h"
+
+ClientBenchmarkApplication::ClientBenchmarkApplication(int &argc, char **argv)
+    : QApplication(argc, argv),
+    Quassel()
+{
+    setDataDirPaths(findDataDirPaths());
+    setRunMode(Quassel::ClientOnly);
+}
+
+
+ClientBenchmarkApplication::~ClientBenchmarkApplication()
+{
+    Client::destroy();
+}
+
+
+bool ClientBenchmarkApplication::init()
+{
+    if (!Quassel::init())
+        return false;
+
+    BenchmarkUi *ui = new BenchmarkUi();
+    Client::init(ui);
+    ui->init();
+    return true;
+}
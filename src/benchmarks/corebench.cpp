@@ -0,0 +1,147 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include <cstdlib>
+
+#include <QDebug>
+
+#include "benchmarkreport.h"
+#include "cipherbenchmark.h"
+#include "cliparser.h"
+#include "core.h"
+#include "coreapplication.h"
+#include "corebenchmark.h"
+#include "irccapture.h"
+#include "protocolbenchmark.h"
+#include "quassel.h"
+#include "scratchdir.h"
+
+// Replays the traffic of the chosen scenario into the core and adds the results to the report
+static bool runReplay(QCoreApplication *app, BenchmarkReport *report)
+{
+    CoreBenchmark benchmark(report);
+    bool ready = benchmark.init();
+    if (ready && Quassel::isOptionSet("capture")) {
+        QList<QByteArray> lines = IrcCapture::load(Quassel::optionValue("capture"), &ready);
+        benchmark.addPhase("capture", lines);
+    }
+    else if (ready && Quassel::optionValue("scenario") == "netsplit") {
+        // the split is reported once the core has sent its summaries, 10 seconds after the last quit
+        int channels = qMax(1, Quassel::optionValue("channels").toInt());
+        int users = Quassel::optionValue("split-users").toInt() / channels;
+        benchmark.addPhase("join", IrcCapture::channelJoins(CoreBenchmark::nick, channels, users), false);
+        benchmark.addPhase("netsplit quit", IrcCapture::netsplitQuits(channels, users));
+        benchmark.awaitMessages(Message::NetsplitQuit, channels);
+        benchmark.addPhase("netsplit join", IrcCapture::netsplitJoins(channels, users));
+        benchmark.awaitMessages(Message::NetsplitJoin, channels);
+    }
+    else if (ready && Quassel::optionValue("scenario") == "traffic") {
+        int channels = qMax(1, Quassel::optionValue("channels").toInt());
+        int users = qMax(1, Quassel::optionValue("users").toInt());
+        benchmark.addPhase("join", IrcCapture::channelJoins(CoreBenchmark::nick, channels, users), false);
+        benchmark.addPhase("traffic", IrcCapture::traffic(CoreBenchmark::nick, Quassel::optionValue("lines").toInt(), channels, users));
+    }
+    else if (ready) {
+        qWarning() << "Unknown scenario" << Quassel::optionValue("scenario");
+        ready = false;
+    }
+
+    if (!ready)
+        return false;
+
+    QObject::connect(&benchmark, SIGNAL(finished(bool)), app, SLOT(quit()));
+    benchmark.start();
+    app->exec();
+    if (!benchmark.success())
+        return false;
+
+    if (Quassel::optionValue("scenario") != "netsplit")
+        benchmark.measureStorage();
+    return true;
+}
+
+
+// Replays IRC traffic into a core and prints how long each processing stage took
+int main(int argc, char **argv)
+{
+    Quassel::setupBuildInfo();
+    QCoreApplication::setApplicationName("quasselbench-core");
+    QCoreApplication::setOrganizationName(Quassel::buildInfo().organizationName);
+    QCoreApplication::setOrganizationDomain(Quassel::buildInfo().organizationDomain);
+
+    Q_INIT_RESOURCE(sql);
+
+    CliParser *cliParser = new CliParser();
+    Quassel::setCliParser(cliParser);
+    cliParser->addSwitch("debug", 'd', "Enable debug output");
+    cliParser->addSwitch("help", 'h', "Display this help and exit");
+    cliParser->addSwitch("version", 'v', "Display version information");
+    cliParser->addOption("configdir <path>", 'c', "Set by the benchmark");
+    cliParser->addOption("datadir <path>", 0, "DEPRECATED - Use --configdir instead");
+    Core::addCliOptions(cliParser);
+    cliParser->addOption("scenario <name>", 0, "Synthetic traffic to replay: traffic|netsplit, or encodings to compare: protocol|cipher", QString("traffic"));
+    cliParser->addOption("capture <file>", 0, "Replay this file of raw IRC lines instead of synthetic traffic");
+    cliParser->addOption("lines <count>", 0, "Number of synthetic lines to replay, or messages to encode or encrypt", QString("100000"));
+    cliParser->addOption("channels <count>", 0, "Number of channels the synthetic traffic is spread over", QString("50"));
+    cliParser->addOption("users <count>", 0, "Number of users in each channel", QString("100"));
+    cliParser->addOption("split-users <count>", 0, "Number of users split off in the netsplit scenario, spread over the channels", QString("20000"));
+    cliParser->addOption("batch <count>", 0, "Number of messages per backlog reply in the protocol scenario", QString("500"));
+    cliParser->addOption("message-length <bytes>", 0, "Length of the messages to encrypt in the cipher scenario", QString("300"));
+
+    ScratchDir configDir("quasselbench-core");
+    if (!configDir.isValid())
+        return EXIT_FAILURE;
+
+    int exitCode = EXIT_FAILURE;
+    {
+        CoreApplication app(argc, argv);
+
+        // keep the output to the report, unless asked otherwise
+        QStringList args = app.arguments();
+        args.insert(1, "--loglevel=Warning");
+        args << "--configdir=" + configDir.path() << "--listen=127.0.0.1" << "--port=0" << "--norestore";
+        if (cliParser->init(args) && app.init()) {
+            BenchmarkReport report;
+            bool success = true;
+            if (!Quassel::isOptionSet("capture") && Quassel::optionValue("scenario") == "protocol") {
+                // no replay needed, the messages are only encoded
+                ProtocolBenchmark benchmark(&report);
+                benchmark.run(qMax(1, Quassel::optionValue("lines").toInt()), qMax(1, Quassel::optionValue("batch").toInt()),
+                    qMax(1, Quassel::optionValue("channels").toInt()));
+            }
+            else if (!Quassel::isOptionSet("capture") && Quassel::optionValue("scenario") == "cipher") {
+                CipherBenchmark benchmark(&report);
+                benchmark.run(qMax(1, Quassel::optionValue("lines").toInt()), qMax(1, Quassel::optionValue("message-length").toInt()));
+            }
+            else {
+                success = runReplay(&app, &report);
+            }
+
+            if (success) {
+                report.print();
+                exitCode = EXIT_SUCCESS;
+            }
+        }
+        else if (Quassel::isOptionSet("help")) {
+            exitCode = EXIT_SUCCESS;
+        }
+    }
+    return exitCode;
+}
@@ -0,0 +1,290 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "corebenchmark.h"
+
+#include <QDebug>
+#include <QDir>
+#include <QTimer>
+
+#include "benchmarkreport.h"
+#include "core.h"
+#include "coreidentity.h"
+#include "corenetwork.h"
+#include "coresession.h"
+#include "irccapture.h"
+#include "metrics.h"
+#include "quassel.h"
+
+const char *CoreBenchmark::nick = "quasselbench";
+
+CoreBenchmark::CoreBenchmark(BenchmarkReport *report, QObject *parent)
+    : QObject(parent),
+    _report(report),
+    _session(0),
+    _phaseCount(0),
+    _replayed(false),
+    _awaitedLeft(0),
+    _phaseUsecs(0),
+    _finished(false),
+    _success(false)
+{
+}
+
+
+bool CoreBenchmark::init()
+{
+    QString error = Core::setup("benchmark", "benchmark", "SQLite", QVariantMap());
+    if (!error.isEmpty()) {
+        qWarning() << "Could not set up the core:" << qPrintable(error);
+        return false;
+    }
+    _user = Core::validateUser("benchmark", "benchmark");
+
+    CoreIdentity identity(IdentityId(0));
+    identity.setIdentityName("Benchmark");
+    identity.setNicks(QStringList() << nick);
+    IdentityId identityId = Core::createIdentity(_user, identity);
+    if (!identityId.isValid()) {
+        qWarning() << "Could not create the identity";
+        return false;
+    }
+
+    if (!_server.listen())
+        return false;
+
+    NetworkInfo info;
+    info.networkName = "Benchmark";
+    info.identity = identityId;
+    info.serverList << Network::Server("127.0.0.1", _server.port(), QString(), false);
+    info.useAutoReconnect = false;
+    if (!Core::createNetwork(_user, info)) {
+        qWarning() << "Could not create the network";
+        return false;
+    }
+    _networkId = info.networkId;
+
+    _session = new CoreSession(_user, false, this);
+    return network() != 0;
+}
+
+
+CoreNetwork *CoreBenchmark::network() const
+{
+    return _session ? _session->network(_networkId) : 0;
+}
+
+
+void CoreBenchmark::addPhase(const QString &name, const QList<QByteArray> &lines, bool measured)
+{
+    Phase phase;
+    phase.name = name;
+    phase.lines = lines;
+    phase.measured = measured;
+    _phases << phase;
+}
+
+
+void CoreBenchmark::awaitMessages(Message::Type type, int count)
+{
+    Q_ASSERT(!_phases.isEmpty());
+    _phases.last().awaitedType = type;
+    _phases.last().awaitedCount = count;
+}
+
+
+void CoreBenchmark::start()
+{
+    connect(&_server, SIGNAL(clientRegistered(QByteArray)), SLOT(clientRegistered()));
+    connect(&_server, SIGNAL(clientDisconnected()), SLOT(clientDisconnected()));
+    connect(network(), SIGNAL(connectionError(QString)), SLOT(connectionError(QString)));
+    connect(_session, SIGNAL(displayMsg(Message)), SLOT(displayMsg(Message)));
+
+    network()->connectToIrc();
+}
+
+
+void CoreBenchmark::clientRegistered()
+{
+    Phase welcome;
+    welcome.name = "welcome";
+    welcome.lines = IrcCapture::welcome(nick);
+    _phases.prepend(welcome);
+    replayNextPhase();
+}
+
+
+void CoreBenchmark::replayNextPhase()
+{
+    if (_phases.isEmpty()) {
+        finish(true);
+        return;
+    }
+
+    _currentPhase = _phases.takeFirst();
+    // a notice to us is stored like any other message, and it's stored last
+    _endMarker = QString("End of replay %1").arg(++_phaseCount);
+    QList<QByteArray> lines = _currentPhase.lines;
+    lines << QByteArray(":") + IrcCapture::serverName + " NOTICE " + nick + " :" + _endMarker.toUtf8();
+    _replayed = false;
+    _awaitedLeft = _currentPhase.awaitedCount;
+
+    if (_currentPhase.measured) {
+        _stagesBefore = stageTimes();
+        _report->start();
+    }
+    _server.replay(lines);
+}
+
+
+void CoreBenchmark::displayMsg(const Message &msg)
+{
+    // processMessages() is still running, so let it finish before measuring
+    if (!_endMarker.isEmpty() && msg.contents() == _endMarker) {
+        _endMarker.clear();
+        QTimer::singleShot(0, this, SLOT(phaseReplayed()));
+    }
+    else if (_awaitedLeft > 0 && msg.type() == _currentPhase.awaitedType) {
+        if (--_awaitedLeft == 0 && _replayed)
+            QTimer::singleShot(0, this, SLOT(phaseProcessed()));
+    }
+}
+
+
+void CoreBenchmark::phaseReplayed()
+{
+    if (_currentPhase.measured)
+        _phaseUsecs = _report->finish(_currentPhase.name, _currentPhase.lines.count());
+    _replayed = true;
+    if (!_awaitedLeft)
+        phaseProcessed();
+}
+
+
+void CoreBenchmark::phaseProcessed()
+{
+    if (_currentPhase.measured)
+        reportStages();
+    _currentPhase = Phase();
+    replayNextPhase();
+}
+
+
+void CoreBenchmark::measureStorage()
+{
+    const int pageSize = 500;
+    int messageCount = 0;
+    _report->start();
+    foreach(const BufferInfo &bufferInfo, Core::requestBuffers(_user)) {
+        // newest first, each page ending with its oldest message
+        QList<Message> page;
+        MsgId last = -1;
+        do {
+            page = Core::requestMsgs(_user, bufferInfo.bufferId(), -1, last, pageSize);
+            messageCount += page.count();
+            if (!page.isEmpty())
+                last = page.last().msgId();
+        } while (page.count() == pageSize);
+    }
+    _report->finish("backlog read by buffer", messageCount);
+
+    _report->start();
+    int allCount = Core::requestAllMsgs(_user).count();
+    _report->finish("backlog read all", allCount);
+
+    // the database and its journal, if any
+    qint64 size = 0;
+    QDir configDir(Quassel::configDirPath());
+    foreach(const QFileInfo &fileInfo, configDir.entryInfoList(QStringList() << "quassel-storage.sqlite*", QDir::Files))
+        size += fileInfo.size();
+
+    _report->addValue("backlog compression", Quassel::isOptionSet("compress-backlog") ? "on" : "off");
+    _report->addValue("stored messages", QString::number(messageCount));
+    _report->addValue("database KiB", QString::number(size / 1024));
+    if (messageCount > 0)
+        _report->addValue("database bytes/message", QString::number(size / messageCount));
+}
+
+
+CoreBenchmark::StageTimes CoreBenchmark::stageTimes()
+{
+    StageTimes times;
+    QMap<QString, qint64> calls;
+    QMap<QString, qint64> usecs = Metrics::values("quassel_event_handler_seconds", &calls);
+    foreach(const QString &labels, usecs.keys()) {
+        QString handler = labels.section('"', 1, 1);
+        times.usecs[handler] += usecs.value(labels);
+        times.calls[handler] += calls.value(labels);
+    }
+
+    // for storing, the number of messages is more telling than the number of batches
+    const QString storeStage = "CoreSession::processMessages()";
+    usecs = Metrics::values("quassel_session_process_messages_seconds");
+    foreach(qint64 value, usecs)
+        times.usecs[storeStage] += value;
+    foreach(qint64 value, Metrics::values("quassel_session_messages_stored_total"))
+        times.calls[storeStage] += value;
+    return times;
+}
+
+
+void CoreBenchmark::reportStages()
+{
+    StageTimes after = stageTimes();
+    qint64 stagesUsecs = 0;
+    foreach(const QString &stage, after.usecs.keys()) {
+        qint64 usecs = after.usecs.value(stage) - _stagesBefore.usecs.value(stage);
+        qint64 calls = after.calls.value(stage) - _stagesBefore.calls.value(stage);
+        if (!calls)
+            continue;
+        _report->add("  " + stage, calls, usecs);
+        stagesUsecs += usecs;
+    }
+    // reading the socket, the event loop and the fake server itself; with awaited messages, the
+    // stages include work done after the phase's row ended, so there is nothing to compare
+    if (!_currentPhase.awaitedCount)
+        _report->add("  other", 0, _phaseUsecs - stagesUsecs);
+}
+
+
+void CoreBenchmark::connectionError(const QString &error)
+{
+    qWarning() << "Network connection failed:" << qPrintable(error);
+    finish(false);
+}
+
+
+void CoreBenchmark::clientDisconnected()
+{
+    if (!_finished)
+        qWarning() << "The network disconnected from the fake server";
+    finish(false);
+}
+
+
+void CoreBenchmark::finish(bool success)
+{
+    if (_finished)
+        return;
+
+    _finished = true;
+    _success = success;
+    emit finished(success);
+}
@@ -0,0 +1,139 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef COREBENCHMARK_H
+#define COREBENCHMARK_H
+
+#include <QList>
+#include <QMap>
+#include <QObject>
+
+#include "fakeircserver.h"
+#include "message.h"
+#include "types.h"
+
+class BenchmarkReport;
+class CoreNetwork;
+class CoreSession;
+
+//! Replays IRC traffic into a complete core session and measures how it is processed
+/** The core runs on a temporary SQLite storage in a scratch config directory, with one user and a
+ *  single network that connects to a FakeIrcServer on the loopback interface. Replayed lines thus
+ *  take the same path as on a live core: the network's socket, IrcParser, the event processors
+ *  (CoreSessionEventProcessor, CtcpParser, EventStringifier) and CoreSession::processMessages()
+ *  into the storage.
+ *
+ *  The traffic is replayed in phases. For each measured phase, the report gets a row with the
+ *  total time and allocations, followed by one row per processing stage as recorded by Metrics.
+ */
+class CoreBenchmark : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const char *nick;
+
+    CoreBenchmark(BenchmarkReport *report, QObject *parent = 0);
+
+    //! Sets up the storage, the user with its identity and network, and the session
+    /** The core must have been initialized with an empty config directory, see ScratchDir.
+     */
+    bool init();
+
+    //! Adds lines to replay once the network has registered
+    /** Each phase is sent only after all lines of the previous one have been stored. Unmeasured
+     *  phases prepare the state for the following ones, e.g. by joining channels.
+     */
+    void addPhase(const QString &name, const QList<QByteArray> &lines, bool measured = true);
+
+    //! Makes the last added phase also wait for \p count messages of \p type
+    /** This is for messages the core only stores after a timeout, like the summaries of a netsplit.
+     *  The phase's own row still ends with its last line, but its stages include the work done
+     *  until the awaited messages are stored.
+     */
+    void awaitMessages(Message::Type type, int count);
+
+    //! Reads the stored backlog back and reports the throughput and the size of the database
+    /** Run this after the replay, to compare the storage with and without --compress-backlog. The
+     *  backlog is read per buffer in pages like the client requests it, and all at once.
+     */
+    void measureStorage();
+
+    inline CoreSession *session() const { return _session; }
+    CoreNetwork *network() const;
+
+    //! Whether all phases have been replayed
+    inline bool success() const { return _success; }
+
+public slots:
+    void start();
+
+signals:
+    //! All phases have been replayed, or the benchmark failed
+    void finished(bool success);
+
+private slots:
+    void clientRegistered();
+    void displayMsg(const Message &msg);
+    void phaseReplayed();
+    void phaseProcessed();
+    void connectionError(const QString &error);
+    void clientDisconnected();
+
+private:
+    struct Phase {
+        QString name;
+        QList<QByteArray> lines;
+        bool measured;
+        Message::Type awaitedType;
+        int awaitedCount;
+        Phase() : measured(false), awaitedType(Message::Plain), awaitedCount(0) {}
+    };
+
+    struct StageTimes {
+        QMap<QString, qint64> usecs;
+        QMap<QString, qint64> calls;
+    };
+
+    void finish(bool success);
+    void replayNextPhase();
+    void reportStages();
+    static StageTimes stageTimes();
+
+    BenchmarkReport *_report;
+    FakeIrcServer _server;
+    UserId _user;
+    NetworkId _networkId;
+    CoreSession *_session;
+
+    QList<Phase> _phases;
+    Phase _currentPhase;
+    int _phaseCount;
+    QString _endMarker;
+    bool _replayed;
+    int _awaitedLeft;
+    qint64 _phaseUsecs;
+    bool _finished;
+    bool _success;
+    StageTimes _stagesBefore;
+};
+
+
+#endif
@@ -0,0 +1,111 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "fakeircserver.h"
+
+#include <QDebug>
+#include <QHostAddress>
+
+#include "irccapture.h"
+
+FakeIrcServer::FakeIrcServer(QObject *parent)
+    : QObject(parent),
+    _client(0)
+{
+    connect(&_server, SIGNAL(newConnection()), SLOT(newConnection()));
+}
+
+
+bool FakeIrcServer::listen()
+{
+    if (!_server.listen(QHostAddress::LocalHost)) {
+        qWarning() << "FakeIrcServer: could not listen -" << qPrintable(_server.errorString());
+        return false;
+    }
+    return true;
+}
+
+
+void FakeIrcServer::newConnection()
+{
+    QTcpSocket *socket = _server.nextPendingConnection();
+    if (_client) {
+        // we only ever serve one network
+        socket->abort();
+        socket->deleteLater();
+        return;
+    }
+
+    _client = socket;
+    connect(_client, SIGNAL(readyRead()), SLOT(readClient()));
+    connect(_client, SIGNAL(disconnected()), SIGNAL(clientDisconnected()));
+}
+
+
+void FakeIrcServer::readClient()
+{
+    while (_client->canReadLine()) {
+        QByteArray line = _client->readLine();
+        while (line.endsWith('\n') || line.endsWith('\r'))
+            line.chop(1);
+        handleLine(line);
+    }
+}
+
+
+void FakeIrcServer::handleLine(const QByteArray &line)
+{
+    QList<QByteArray> params = line.split(' ');
+    QByteArray command = params.first().toUpper();
+    QByteArray lastParam = line.mid(line.indexOf(' ') + 1);
+    if (lastParam.startsWith(':'))
+        lastParam = lastParam.mid(1);
+
+    if (command == "NICK") {
+        _nick = lastParam;
+    }
+    else if (command == "USER") {
+        emit clientRegistered(_nick);
+    }
+    else if (command == "PING") {
+        _client->write(QByteArray(":") + IrcCapture::serverName + " PONG " + IrcCapture::serverName + " :" + lastParam + "\r\n");
+    }
+}
+
+
+void FakeIrcServer::replay(const QList<QByteArray> &lines)
+{
+    if (!_client) {
+        qWarning() << "FakeIrcServer: no client to replay to!";
+        return;
+    }
+
+    int size = 0;
+    foreach(const QByteArray &line, lines)
+        size += line.size() + 2;
+
+    QByteArray data;
+    data.reserve(size);
+    foreach(const QByteArray &line, lines) {
+        data += line;
+        data += "\r\n";
+    }
+    _client->write(data);
+}
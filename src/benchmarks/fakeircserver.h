@@ -0,0 +1,63 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef FAKEIRCSERVER_H
+#define FAKEIRCSERVER_H
+
+#include <QList>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+//! Plays back IRC lines to a single client connected over the loopback interface
+/** The server doesn't implement any IRC semantics. It answers the client's PINGs, reports its
+ *  registration, and sends whatever it is told to replay.
+ */
+class FakeIrcServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    FakeIrcServer(QObject *parent = 0);
+
+    //! Starts listening on a free port of 127.0.0.1
+    bool listen();
+    inline quint16 port() const { return _server.serverPort(); }
+
+    void replay(const QList<QByteArray> &lines);
+
+signals:
+    //! The client has sent NICK and USER
+    void clientRegistered(const QByteArray &nick);
+    void clientDisconnected();
+
+private slots:
+    void newConnection();
+    void readClient();
+
+private:
+    void handleLine(const QByteArray &line);
+
+    QTcpServer _server;
+    QTcpSocket *_client;
+    QByteArray _nick;
+};
+
+
+#endif
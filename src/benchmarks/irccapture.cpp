@@ -0,0 +1,251 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "irccapture.h"
+
+#include <QDebug>
+#include <QFile>
+#include <QPair>
+
+const char *IrcCapture::serverName = "irc.benchmark.example";
+
+namespace {
+// a plain LCG is enough here, and unlike qrand() it doesn't depend on the seed set elsewhere
+class Random
+{
+public:
+    Random(quint32 seed) : _state(seed) {}
+    int next(int max)
+    {
+        _state = _state * 1103515245u + 12345u;
+        return (_state >> 8) % max;
+    }
+
+private:
+    quint32 _state;
+};
+
+const int namesPerLine = 30;
+const char *splitServers = "irc.hub.example irc.leaf.example";
+}
+
+QList<QByteArray> IrcCapture::load(const QString &fileName, bool *ok)
+{
+    QList<QByteArray> lines;
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open capture" << fileName << "-" << qPrintable(file.errorString());
+        if (ok)
+            *ok = false;
+        return lines;
+    }
+
+    while (!file.atEnd()) {
+        QByteArray line = file.readLine();
+        while (line.endsWith('\n') || line.endsWith('\r'))
+            line.chop(1);
+        if (!line.isEmpty())
+            lines << line;
+    }
+    if (ok)
+        *ok = true;
+    return lines;
+}
+
+
+QByteArray IrcCapture::channelName(int channel)
+{
+    return "#channel" + QByteArray::number(channel);
+}
+
+
+QByteArray IrcCapture::userPrefix(int user)
+{
+    QByteArray id = QByteArray::number(user);
+    return "user" + id + "!~ident" + id + "@host" + QByteArray::number(user % 500) + ".example.com";
+}
+
+
+QList<QByteArray> IrcCapture::welcome(const QByteArray &nick)
+{
+    QByteArray prefix = QByteArray(":") + serverName + ' ';
+    QList<QByteArray> lines;
+    lines << prefix + "001 " + nick + " :Welcome to the Benchmark IRC Network " + nick + "!~quassel@localhost"
+          << prefix + "002 " + nick + " :Your host is " + serverName + ", running version benchmark"
+          << prefix + "003 " + nick + " :This server was created today"
+          << prefix + "004 " + nick + ' ' + serverName + " benchmark iowghraAsORTVSxNCWqBzvdHtGpI lvhopsmntikrRcaqOALQbSeIKVfMCuzNTGjZ"
+          << prefix + "005 " + nick + " CHANTYPES=# EXCEPTS INVEX CHANMODES=eIbq,k,flj,CFLMPQScgimnprstz CHANLIMIT=#:120 "
+                                      "PREFIX=(ov)@+ MAXLIST=bqeI:100 MODES=4 NETWORK=Benchmark :are supported by this server"
+          << prefix + "005 " + nick + " CASEMAPPING=rfc1459 NICKLEN=16 CHANNELLEN=50 TOPICLEN=390 :are supported by this server"
+          << prefix + "375 " + nick + " :- " + serverName + " Message of the Day -"
+          << prefix + "372 " + nick + " :- This server only exists for benchmarking."
+          << prefix + "376 " + nick + " :End of /MOTD command.";
+    return lines;
+}
+
+
+QList<QByteArray> IrcCapture::channelJoins(const QByteArray &nick, int channelCount, int usersPerChannel)
+{
+    QByteArray prefix = QByteArray(":") + serverName + ' ';
+    QList<QByteArray> lines;
+    for (int c = 0; c < channelCount; c++) {
+        QByteArray channel = channelName(c);
+        lines << ':' + nick + "!~quassel@localhost JOIN " + channel;
+        lines << prefix + "332 " + nick + ' ' + channel + " :Topic of " + channel + " - see http://quassel-irc.org/";
+
+        QByteArray names = nick;
+        int namesInLine = 1;
+        for (int u = 0; u < usersPerChannel; u++) {
+            if (namesInLine == namesPerLine) {
+                lines << prefix + "353 " + nick + " = " + channel + " :" + names;
+                names.clear();
+                namesInLine = 0;
+            }
+            if (!names.isEmpty())
+                names += ' ';
+            if (u < 3)
+                names += '@';
+            else if (u < 10)
+                names += '+';
+            names += "user" + QByteArray::number(c * usersPerChannel + u);
+            namesInLine++;
+        }
+        lines << prefix + "353 " + nick + " = " + channel + " :" + names;
+        lines << prefix + "366 " + nick + ' ' + channel + " :End of /NAMES list.";
+    }
+    return lines;
+}
+
+
+QList<QByteArray> IrcCapture::traffic(const QByteArray &nick, int lineCount, int channelCount, int usersPerChannel)
+{
+    QList<QByteArray> contents;
+    contents << "Lorem ipsum dolor sit amet, consectetur adipisici elit, sed eiusmod tempor incidunt ut labore et dolore magna aliqua."
+             << "ok"
+             << "has anyone tried the new release yet? the changelog is at http://quassel-irc.org/node/123"
+             << "\x02" "bold" "\x02 \x03" "4red\x03 \x03" "3,1green on black\x03 \x1f" "underlined\x1f plain again"
+             << "see https://bugs.quassel-irc.org/projects/quassel-irc/issues?set_filter=1 and www.example.com/a/b/c"
+             << "I'm not sure, the logs say something different. Let me check again and get back to you later today."
+             // long lines, as pasted output or links, are what backlog compression is about
+             << "[2014-03-12 21:14:03] core: Error while connecting to database: unable to open database file (QSqlError: 14) "
+                "- retrying in 5 seconds, see http://bugs.quassel-irc.org/projects/quassel-irc/wiki/Database_Errors for details"
+             << "https://www.example.com/search?q=quassel+irc+client+core+backlog&source=web&ie=UTF-8&oe=UTF-8&start=10 "
+                "https://github.com/quassel/quassel/blob/master/src/core/sqlitestorage.cpp#L1700 and "
+                "https://github.com/quassel/quassel/blob/master/src/core/postgresqlstorage.cpp#L1600";
+
+    Random random(4242);
+    QList<QPair<int, QByteArray> > guests; // channel, nick of users that joined during the replay
+    int nextGuest = 0;
+
+    QList<QByteArray> lines;
+    while (lines.count() < lineCount) {
+        int c = random.next(channelCount);
+        QByteArray channel = channelName(c);
+        int userId = c * usersPerChannel + random.next(usersPerChannel);
+        QByteArray user = ':' + userPrefix(userId);
+        QByteArray text = contents.at(random.next(contents.count()));
+        int kind = random.next(100);
+
+        if (kind < 55) {
+            lines << user + " PRIVMSG " + channel + " :" + text;
+        }
+        else if (kind < 60) {
+            // highlights
+            lines << user + " PRIVMSG " + channel + " :" + nick + ": " + text;
+        }
+        else if (kind < 65) {
+            lines << user + " PRIVMSG " + channel + " :\x01" "ACTION " + text + '\x01';
+        }
+        else if (kind < 68) {
+            lines << user + " NOTICE " + channel + " :" + text;
+        }
+        else if (kind < 70) {
+            lines << user + " PRIVMSG " + nick + " :" + text;
+        }
+        else if (kind < 78) {
+            QByteArray guest = "guest" + QByteArray::number(nextGuest++);
+            lines << ':' + guest + "!~" + guest + "@guest.example.com JOIN " + channel;
+            guests << qMakePair(c, guest);
+        }
+        else if (!guests.isEmpty() && kind < 90) {
+            QPair<int, QByteArray> guest = guests.takeAt(random.next(guests.count()));
+            QByteArray guestPrefix = ':' + guest.second + "!~" + guest.second + "@guest.example.com";
+            if (kind < 83) {
+                lines << guestPrefix + " PART " + channelName(guest.first) + " :bye";
+            }
+            else if (kind < 87) {
+                lines << guestPrefix + " QUIT :Quit: " + text.left(40);
+            }
+            else {
+                QByteArray newNick = guest.second + "_";
+                lines << guestPrefix + " NICK :" + newNick;
+                guests << qMakePair(guest.first, newNick);
+            }
+        }
+        else if (kind < 96) {
+            QByteArray target = "user" + QByteArray::number(c * usersPerChannel + random.next(usersPerChannel));
+            lines << ':' + userPrefix(c * usersPerChannel) + " MODE " + channel + (kind % 2 ? " +o " : " -o ") + target;
+        }
+        else {
+            lines << user + " TOPIC " + channel + " :" + text;
+        }
+    }
+    return lines;
+}
+
+
+QList<QByteArray> IrcCapture::netsplitQuits(int channelCount, int usersPerChannel)
+{
+    QList<QByteArray> lines;
+    for (int user = 0; user < channelCount * usersPerChannel; user++)
+        lines << ':' + userPrefix(user) + " QUIT :" + splitServers;
+    return lines;
+}
+
+
+QList<QByteArray> IrcCapture::netsplitJoins(int channelCount, int usersPerChannel)
+{
+    QByteArray prefix = QByteArray(":") + serverName + ' ';
+    QList<QByteArray> lines;
+    for (int c = 0; c < channelCount; c++) {
+        QByteArray channel = channelName(c);
+        for (int u = 0; u < usersPerChannel; u++)
+            lines << ':' + userPrefix(c * usersPerChannel + u) + " JOIN " + channel;
+
+        // the same ops and voices as in channelJoins()
+        QByteArray ops = "+", opNicks;
+        QByteArray voices = "+", voiceNicks;
+        for (int u = 0; u < qMin(usersPerChannel, 10); u++) {
+            QByteArray user = " user" + QByteArray::number(c * usersPerChannel + u);
+            if (u < 3) {
+                ops += 'o';
+                opNicks += user;
+            }
+            else {
+                voices += 'v';
+                voiceNicks += user;
+            }
+        }
+        lines << prefix + "MODE " + channel + ' ' + ops + opNicks;
+        if (!voiceNicks.isEmpty())
+            lines << prefix + "MODE " + channel + ' ' + voices + voiceNicks;
+    }
+    return lines;
+}
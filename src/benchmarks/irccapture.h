@@ -0,0 +1,70 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef IRCCAPTURE_H
+#define IRCCAPTURE_H
+
+#include <QByteArray>
+#include <QList>
+#include <QString>
+
+//! Raw IRC traffic as a server sends it, for replaying it to a core
+/** Lines are stored without the trailing CR/LF. Synthetic traffic is generated from a fixed seed,
+ *  so that every run replays exactly the same lines.
+ */
+class IrcCapture
+{
+public:
+    static const char *serverName;
+
+    //! Reads a capture with one raw line per line, as logged by an ircd or bouncer
+    /** \param ok  Set to false if the file could not be read
+     */
+    static QList<QByteArray> load(const QString &fileName, bool *ok = 0);
+
+    //! The registration burst a server sends in reply to NICK and USER
+    static QList<QByteArray> welcome(const QByteArray &nick);
+
+    //! Joins \p nick to \p channelCount channels with \p usersPerChannel users each
+    /** Users are named user0, user1, ...; channel c has the users c * usersPerChannel and upwards,
+     *  so that the generated traffic can refer to them.
+     */
+    static QList<QByteArray> channelJoins(const QByteArray &nick, int channelCount, int usersPerChannel);
+
+    //! Generates the everyday traffic of the channels set up by channelJoins()
+    /** This is a mix of messages (some of them highlights, mIRC-colored or with URLs), actions,
+     *  notices, queries, joins, parts, quits, nick, mode and topic changes.
+     */
+    static QList<QByteArray> traffic(const QByteArray &nick, int lineCount, int channelCount, int usersPerChannel);
+
+    //! The quits of a netsplit that separates all users of the channels set up by channelJoins()
+    static QList<QByteArray> netsplitQuits(int channelCount, int usersPerChannel);
+
+    //! The joins when the servers split by netsplitQuits() are linked again
+    /** Like a real server, this also restores the users' channel modes after the joins.
+     */
+    static QList<QByteArray> netsplitJoins(int channelCount, int usersPerChannel);
+
+    static QByteArray channelName(int channel);
+    static QByteArray userPrefix(int user);
+};
+
+
+#endif
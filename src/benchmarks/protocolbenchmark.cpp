@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "protocolbenchmark.h"
+
+#include <QDataStream>
+#include <QTcpSocket>
+
+#include "benchmarkreport.h"
+#include "message.h"
+#include "protocols/datastream/datastreampeer.h"
+
+ProtocolBenchmark::ProtocolBenchmark(BenchmarkReport *report)
+    : _report(report)
+{
+}
+
+
+void ProtocolBenchmark::run(int messageCount, int batchSize, int bufferCount)
+{
+    QList<BufferInfo> buffers;
+    for (int i = 0; i < bufferCount; i++)
+        buffers << BufferInfo(BufferId(i + 1), NetworkId(1), BufferInfo::ChannelBuffer, 0, QString("#channel%1").arg(i));
+
+    // the parameters of receiveBacklogMulti(), as a reply to the initial backlog request
+    QList<QVariantList> replies;
+    QDateTime time = QDateTime::currentDateTime();
+    for (int first = 0; first < messageCount; first += batchSize) {
+        QVariantList msgs;
+        for (int i = first; i < qMin(first + batchSize, messageCount); i++) {
+            Message msg(time.addSecs(i), buffers.at(i % bufferCount), Message::Plain, "Lorem ipsum dolor sit amet, consectetur adipisici elit, sed eiusmod tempor incidunt",
+                QString("nick%1!~user%1@host%1.example.com").arg(i % 50));
+            msg.setMsgId(MsgId(i + 1));
+            msgs << qVariantFromValue(msg);
+        }
+        replies << (QVariantList() << QVariant(QVariantList()) << QVariant(msgs));
+    }
+
+    runEncoding("legacy", 0, replies, messageCount);
+    runEncoding("compact", DataStreamPeer::CompactMessages, replies, messageCount);
+}
+
+
+void ProtocolBenchmark::runEncoding(const QString &name, quint16 features, const QList<QVariantList> &replies, int messageCount)
+{
+    // separate peers, as each side keeps its own dictionary of BufferInfos
+    DataStreamPeer sender(0, new QTcpSocket(), features, Compressor::NoCompression);
+    DataStreamPeer receiver(0, new QTcpSocket(), features, Compressor::NoCompression);
+
+    QList<QByteArray> encoded;
+    _report->start();
+    foreach(const QVariantList &params, replies) {
+        QByteArray data;
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_4_2);
+        out << sender.encodeMessages(params);
+        encoded << data;
+    }
+    _report->finish(name + ": encode", messageCount);
+
+    _report->start();
+    foreach(const QByteArray &data, encoded) {
+        QDataStream in(data);
+        in.setVersion(QDataStream::Qt_4_2);
+        QVariantList params;
+        in >> params;
+        receiver.decodeMessages(params);
+    }
+    _report->finish(name + ": decode", messageCount);
+
+    qint64 bytes = 0;
+    qint64 compressedBytes = 0;
+    foreach(const QByteArray &data, encoded) {
+        bytes += data.size();
+        compressedBytes += qCompress(data).size();
+    }
+    _report->addValue(name + ": bytes per message", QString::number((double)bytes / messageCount, 'f', 1));
+    _report->addValue(name + ": zlib bytes per message", QString::number((double)compressedBytes / messageCount, 'f', 1));
+}
@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef PROTOCOLBENCHMARK_H
+#define PROTOCOLBENCHMARK_H
+
+#include <QList>
+#include <QString>
+#include <QVariantList>
+
+class BenchmarkReport;
+
+//! Compares the legacy and the compact wire encoding of backlog replies
+/** Both encodings go through a DataStreamPeer, once without and once with DataStreamPeer::CompactMessages,
+ *  and are serialized like RemotePeer writes them, only without the socket and its compression.
+ *  Since the connection is usually compressed, the report also shows the size after zlib.
+ */
+class ProtocolBenchmark
+{
+public:
+    ProtocolBenchmark(BenchmarkReport *report);
+
+    //! Encodes and decodes \p messageCount messages of \p bufferCount buffers, in replies of \p batchSize messages
+    void run(int messageCount, int batchSize, int bufferCount);
+
+private:
+    void runEncoding(const QString &name, quint16 features, const QList<QVariantList> &replies, int messageCount);
+
+    BenchmarkReport *_report;
+};
+
+
+#endif
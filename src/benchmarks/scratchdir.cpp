@@ -0,0 +1,56 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "scratchdir.h"
+
+#include <QCoreApplication>
+#include <QDebug>
+#include <QDir>
+
+ScratchDir::ScratchDir(const QString &name)
+{
+    QString path = QDir::temp().absoluteFilePath(QString("%1-%2").arg(name).arg(QCoreApplication::applicationPid()));
+    remove(path); // left over by a crashed run with the same pid
+    if (!QDir().mkpath(path)) {
+        qWarning() << "Could not create" << path;
+        return;
+    }
+    _path = path;
+}
+
+
+ScratchDir::~ScratchDir()
+{
+    if (isValid())
+        remove(_path);
+}
+
+
+void ScratchDir::remove(const QString &path)
+{
+    QDir dir(path);
+    if (!dir.exists())
+        return;
+
+    // Quassel only creates plain files in there
+    foreach(const QString &fileName, dir.entryList(QDir::Files | QDir::Hidden))
+        dir.remove(fileName);
+    QDir().rmdir(path);
+}
@@ -0,0 +1,45 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef SCRATCHDIR_H
+#define SCRATCHDIR_H
+
+#include <QString>
+
+//! A temporary directory for the configuration and storage of a benchmark run
+/** The directory is created empty and removed again, together with the files in it, on destruction.
+ */
+class ScratchDir
+{
+public:
+    ScratchDir(const QString &name);
+    ~ScratchDir();
+
+    inline bool isValid() const { return !_path.isEmpty(); }
+    inline QString path() const { return _path; }
+
+private:
+    static void remove(const QString &path);
+
+    QString _path;
+};
+
+
+#endif
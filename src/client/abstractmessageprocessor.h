@@ -33,10 +33,17 @@ public:
     AbstractMessageProcessor(QObject *parent);
     virtual void reset() = 0;
 
+    //! Whether messages passed to process() are still waiting to be inserted into the model
+    virtual bool hasPendingMessages() const { return false; }
+
 public slots:
     virtual void process(Message &msg) = 0;
     virtual void process(QList<Message> &msgs) = 0;
 
+signals:
+    //! Emitted when hasPendingMessages() becomes false again
+    void pendingMessagesInserted();
+
 protected:
     // updateBufferActivity also sets the Message::Redirected flag which is later used
     // to determine where a message should be displayed. therefore it's crucial that it
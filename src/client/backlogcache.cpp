@@ -0,0 +1,306 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "backlogcache.h"
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QFileInfo>
+#include <QMap>
+#include <QSet>
+
+#include "quassel.h"
+
+namespace {
+
+const quint32 indexMagic = 0x51424331; // "QBC1"
+const QDataStream::Version streamVersion = QDataStream::Qt_4_2;
+
+void writeRecord(QDataStream &out, const Message &msg)
+{
+    out << msg.msgId() << (quint32)msg.timestamp().toTime_t() << (quint32)msg.type() << (quint8)msg.flags()
+        << msg.bufferInfo() << msg.sender() << msg.contents();
+}
+
+
+Message readRecord(QDataStream &in)
+{
+    MsgId msgId;
+    quint32 timestamp, type;
+    quint8 flags;
+    BufferInfo bufferInfo;
+    QString sender, contents;
+    in >> msgId >> timestamp >> type >> flags >> bufferInfo >> sender >> contents;
+
+    Message msg(QDateTime::fromTime_t(timestamp), bufferInfo, (Message::Type)type, contents, sender, (Message::Flags)flags);
+    msg.setMsgId(msgId);
+    return msg;
+}
+
+}
+
+
+BacklogCache::BacklogCache(AccountId accountId, qint64 maxSize, int maxMessagesPerBuffer)
+    : _maxSize(maxSize),
+    _maxMessagesPerBuffer(maxMessagesPerBuffer),
+    _totalSize(0)
+{
+    QString path = Quassel::configDirPath() + QString("backlogcache/%1/").arg(accountId.toInt());
+    if (!QDir().mkpath(path))
+        qWarning() << "BacklogCache: could not create cache directory" << path;
+    _dir = QDir(path);
+
+    loadIndex();
+    enforceSizeLimit();
+}
+
+
+BacklogCache::~BacklogCache()
+{
+    saveIndex();
+}
+
+
+QString BacklogCache::segmentPath(BufferId bufferId) const
+{
+    return _dir.filePath(QString("%1.seg").arg(bufferId.toInt()));
+}
+
+
+MsgId BacklogCache::lastMsgId(BufferId bufferId) const
+{
+    return _segments.value(bufferId).last;
+}
+
+
+MessageList BacklogCache::messages(BufferId bufferId, int limit) const
+{
+    if (limit <= 0 || !_segments.contains(bufferId))
+        return MessageList();
+
+    // segments are append-only, so the same message may appear more than once
+    QMap<MsgId, Message> sorted;
+    foreach(const Message &msg, readSegment(bufferId)) {
+        sorted[msg.msgId()] = msg;
+    }
+
+    MessageList result = sorted.values();
+    if (result.count() > limit)
+        result = result.mid(result.count() - limit);
+    return result;
+}
+
+
+void BacklogCache::append(const MessageList &messages)
+{
+    QHash<BufferId, MessageList> buffers;
+    foreach(const Message &msg, messages) {
+        if (msg.msgId().isValid() && msg.bufferInfo().bufferId().isValid())
+            buffers[msg.bufferInfo().bufferId()] << msg;
+    }
+
+    QHash<BufferId, MessageList>::const_iterator iter = buffers.constBegin();
+    while (iter != buffers.constEnd()) {
+        if (writeSegment(iter.key(), iter.value(), false) && _segments[iter.key()].count > 2 * _maxMessagesPerBuffer)
+            compact(iter.key());
+        ++iter;
+    }
+
+    enforceSizeLimit();
+}
+
+
+void BacklogCache::remove(BufferId bufferId)
+{
+    if (!_segments.contains(bufferId))
+        return;
+
+    _totalSize -= _segments.take(bufferId).size;
+    QFile::remove(segmentPath(bufferId));
+}
+
+
+MessageList BacklogCache::readSegment(BufferId bufferId) const
+{
+    MessageList messages;
+
+    QFile file(segmentPath(bufferId));
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+        return messages;
+
+    uchar *data = file.map(0, file.size());
+    if (!data) {
+        qWarning() << "BacklogCache: could not map" << file.fileName() << file.errorString();
+        return messages;
+    }
+
+    QByteArray raw = QByteArray::fromRawData(reinterpret_cast<const char *>(data), file.size());
+    QDataStream in(raw);
+    in.setVersion(streamVersion);
+    while (!in.atEnd()) {
+        Message msg = readRecord(in);
+        if (in.status() != QDataStream::Ok)
+            break; // truncated by an interrupted write, the remaining records are still fine
+        messages << msg;
+    }
+
+    file.unmap(data);
+    return messages;
+}
+
+
+bool BacklogCache::writeSegment(BufferId bufferId, const MessageList &messages, bool truncate)
+{
+    QFile file(segmentPath(bufferId));
+    if (!file.open(truncate ? QIODevice::WriteOnly | QIODevice::Truncate : QIODevice::WriteOnly | QIODevice::Append)) {
+        qWarning() << "BacklogCache: could not write" << file.fileName() << file.errorString();
+        return false;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(streamVersion);
+    Segment &segment = _segments[bufferId];
+    if (truncate) {
+        _totalSize -= segment.size;
+        segment = Segment();
+    }
+    foreach(const Message &msg, messages) {
+        writeRecord(out, msg);
+        if (!segment.first.isValid() || msg.msgId() < segment.first)
+            segment.first = msg.msgId();
+        if (msg.msgId() > segment.last)
+            segment.last = msg.msgId();
+        segment.count++;
+    }
+    file.close();
+
+    _totalSize += file.size() - segment.size;
+    segment.size = file.size();
+    segment.lastWrite = QDateTime::currentDateTime().toTime_t();
+    return true;
+}
+
+
+void BacklogCache::scanSegment(BufferId bufferId)
+{
+    MessageList messages = readSegment(bufferId);
+    if (messages.isEmpty()) {
+        remove(bufferId);
+        QFile::remove(segmentPath(bufferId));
+        return;
+    }
+
+    Segment segment;
+    foreach(const Message &msg, messages) {
+        if (!segment.first.isValid() || msg.msgId() < segment.first)
+            segment.first = msg.msgId();
+        if (msg.msgId() > segment.last)
+            segment.last = msg.msgId();
+    }
+    segment.count = messages.count();
+    segment.size = QFileInfo(segmentPath(bufferId)).size();
+    segment.lastWrite = QFileInfo(segmentPath(bufferId)).lastModified().toTime_t();
+
+    _totalSize += segment.size - _segments.value(bufferId).size;
+    _segments[bufferId] = segment;
+}
+
+
+void BacklogCache::compact(BufferId bufferId)
+{
+    writeSegment(bufferId, messages(bufferId, _maxMessagesPerBuffer), true);
+}
+
+
+void BacklogCache::enforceSizeLimit()
+{
+    while (_totalSize > _maxSize && !_segments.isEmpty()) {
+        QHash<BufferId, Segment>::const_iterator oldest = _segments.constBegin();
+        for (QHash<BufferId, Segment>::const_iterator iter = _segments.constBegin(); iter != _segments.constEnd(); ++iter) {
+            if (iter->lastWrite < oldest->lastWrite)
+                oldest = iter;
+        }
+        remove(oldest.key());
+    }
+}
+
+
+void BacklogCache::loadIndex()
+{
+    QFile file(_dir.filePath("index"));
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream in(&file);
+        in.setVersion(streamVersion);
+        quint32 magic;
+        qint32 count;
+        in >> magic >> count;
+        if (magic == indexMagic) {
+            for (int i = 0; i < count && in.status() == QDataStream::Ok; i++) {
+                BufferId bufferId;
+                Segment segment;
+                in >> bufferId >> segment.first >> segment.last >> segment.count >> segment.size >> segment.lastWrite;
+                if (in.status() == QDataStream::Ok)
+                    _segments[bufferId] = segment;
+            }
+        }
+        file.close();
+    }
+
+    // check the index against the segments that are actually there
+    QSet<BufferId> found;
+    foreach(const QFileInfo &fileInfo, _dir.entryInfoList(QStringList() << "*.seg", QDir::Files)) {
+        BufferId bufferId = fileInfo.baseName().toInt();
+        if (!bufferId.isValid())
+            continue;
+        found << bufferId;
+        if (!_segments.contains(bufferId) || _segments[bufferId].size != fileInfo.size()) {
+            _segments.remove(bufferId);
+            scanSegment(bufferId);
+        }
+        else {
+            _totalSize += fileInfo.size();
+        }
+    }
+    foreach(BufferId bufferId, _segments.keys()) {
+        if (!found.contains(bufferId))
+            _segments.remove(bufferId);
+    }
+}
+
+
+void BacklogCache::saveIndex() const
+{
+    QFile file(_dir.filePath("index"));
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        qWarning() << "BacklogCache: could not write" << file.fileName() << file.errorString();
+        return;
+    }
+
+    QDataStream out(&file);
+    out.setVersion(streamVersion);
+    out << indexMagic << (qint32)_segments.count();
+    QHash<BufferId, Segment>::const_iterator iter = _segments.constBegin();
+    while (iter != _segments.constEnd()) {
+        out << iter.key() << iter->first << iter->last << iter->count << iter->size << iter->lastWrite;
+        ++iter;
+    }
+}
@@ -0,0 +1,84 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef BACKLOGCACHE_H
+#define BACKLOGCACHE_H
+
+#include <QDir>
+#include <QHash>
+
+#include "message.h"
+#include "types.h"
+
+//! On-disk cache of recently received messages, kept per core account
+/** Messages are appended to one segment file per buffer and read back through a memory mapping.
+ *  On connect, the backlog requester only asks the core for messages newer than lastMsgId() and
+ *  fills up the rest from the cache. Callers are responsible for keeping the cached range of a
+ *  buffer contiguous, i.e. remove() a buffer before appending messages that don't connect to it.
+ *
+ *  A segment may grow to twice the per-buffer limit before it is compacted to the newest messages.
+ *  If the whole cache exceeds its size limit, the least recently written segments are dropped.
+ *  The extent of each segment is kept in an index file; segments that don't match their index
+ *  entry (e.g. after a crash) are rescanned on startup.
+ */
+class BacklogCache
+{
+public:
+    BacklogCache(AccountId accountId, qint64 maxSize, int maxMessagesPerBuffer);
+    ~BacklogCache();
+
+    //! The id of the newest cached message of a buffer, or an invalid MsgId if nothing is cached
+    MsgId lastMsgId(BufferId bufferId) const;
+
+    //! Returns the newest \p limit cached messages of a buffer, in ascending order
+    MessageList messages(BufferId bufferId, int limit) const;
+
+    void append(const MessageList &messages);
+    void remove(BufferId bufferId);
+
+private:
+    struct Segment {
+        MsgId first;
+        MsgId last;
+        int count;
+        qint64 size;
+        uint lastWrite;
+        Segment() : count(0), size(0), lastWrite(0) {}
+    };
+
+    QString segmentPath(BufferId bufferId) const;
+    MessageList readSegment(BufferId bufferId) const;
+    bool writeSegment(BufferId bufferId, const MessageList &messages, bool truncate);
+    void scanSegment(BufferId bufferId);
+    void compact(BufferId bufferId);
+    void enforceSizeLimit();
+
+    void loadIndex();
+    void saveIndex() const;
+
+    QDir _dir;
+    qint64 _maxSize;
+    int _maxMessagesPerBuffer;
+    qint64 _totalSize;
+    QHash<BufferId, Segment> _segments;
+};
+
+
+#endif // BACKLOGCACHE_H
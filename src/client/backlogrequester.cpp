@@ -22,6 +22,7 @@
 
 #include <QObject>
 
+#include "backlogcache.h"
 #include "backlogsettings.h"
 #include "bufferviewoverlay.h"
 #include "clientbacklogmanager.h"
@@ -58,6 +59,39 @@ bool BacklogRequester::buffer(BufferId bufferId, const MessageList &messages)
 }
 
 
+void BacklogRequester::sendRequests(const QVariantList &requests)
+{
+    if (!(Client::coreFeatures() & Quassel::BacklogRequestMulti)) {
+        foreach(const QVariant &v, requests) {
+            QVariantList request = v.toList();
+            backlogManager->requestBacklog(request[0].value<BufferId>(), request[1].value<MsgId>(), request[2].value<MsgId>(), request[3].toInt(), request[4].toInt());
+        }
+        return;
+    }
+
+    // keep each reply well below the protocol's message size limit
+    for (int offset = 0; offset < requests.count(); offset += multiRequestSize) {
+        backlogManager->requestBacklogMulti(requests.mid(offset, multiRequestSize));
+    }
+}
+
+
+void BacklogRequester::addRequest(QVariantList &requests, BufferId bufferId, MsgId first, int limit, int additional)
+{
+    BacklogCache *cache = backlogManager->cache();
+    MsgId cachedMsgId = cache ? cache->lastMsgId(bufferId) : MsgId();
+    if (cachedMsgId.isValid() && cachedMsgId >= first && limit > 0) {
+        backlogManager->expectBacklog(bufferId, limit);
+        first = cachedMsgId.toInt() + 1;
+        additional = 0;
+    }
+    else {
+        backlogManager->expectBacklog(bufferId, -1);
+    }
+    requests << QVariant(QVariantList() << qVariantFromValue(bufferId) << qVariantFromValue(first) << qVariantFromValue(MsgId(-1)) << limit << additional);
+}
+
+
 BufferIdList BacklogRequester::allBufferIds() const
 {
     QSet<BufferId> bufferIds = Client::bufferViewOverlay()->bufferIds();
@@ -93,9 +127,11 @@ void FixedBacklogRequester::requestBacklog(const BufferIdList &bufferIds)
 {
     setWaitingBuffers(bufferIds);
     backlogManager->emitMessagesRequested(QObject::tr("Requesting a total of up to %1 backlog messages for %2 buffers").arg(_backlogCount * bufferIds.count()).arg(bufferIds.count()));
+    QVariantList requests;
     foreach(BufferId bufferId, bufferIds) {
-        backlogManager->requestBacklog(bufferId, -1, -1, _backlogCount);
+        addRequest(requests, bufferId, -1, _backlogCount);
     }
+    sendRequests(requests);
 }
 
 
@@ -140,7 +176,9 @@ void PerBufferUnreadBacklogRequester::requestBacklog(const BufferIdList &bufferI
 {
     setWaitingBuffers(bufferIds);
     backlogManager->emitMessagesRequested(QObject::tr("Requesting a total of up to %1 unread backlog messages for %2 buffers").arg((_limit + _additional) * bufferIds.count()).arg(bufferIds.count()));
+    QVariantList requests;
     foreach(BufferId bufferId, bufferIds) {
-        backlogManager->requestBacklog(bufferId, Client::networkModel()->lastSeenMsgId(bufferId), -1, _limit, _additional);
+        addRequest(requests, bufferId, Client::networkModel()->lastSeenMsgId(bufferId), _limit, _additional);
     }
+    sendRequests(requests);
 }
@@ -63,9 +63,23 @@ protected:
     void setWaitingBuffers(const QSet<BufferId> &buffers);
     void addWaitingBuffer(BufferId buffer);
 
+    //! Sends a list of (BufferId, first, last, limit, additional) backlog requests
+    /** If the core supports Quassel::BacklogRequestMulti, the requests are sent batched,
+     *  otherwise one requestBacklog() call is made per buffer.
+     */
+    void sendRequests(const QVariantList &requests);
+
+    //! Adds a request for the given buffer to \p requests
+    /** If messages of the buffer are cached locally, only the messages newer than the cache are
+     *  requested; the rest is filled in from the cache once the reply arrives.
+     */
+    void addRequest(QVariantList &requests, BufferId bufferId, MsgId first, int limit, int additional = 0);
+
     ClientBacklogManager *backlogManager;
 
 private:
+    static const int multiRequestSize = 50;
+
     bool _isBuffering;
     RequesterType _requesterType;
     MessageList _bufferedMessages;
@@ -45,6 +45,14 @@ public:
     inline void setPerBufferUnreadBacklogLimit(int limit) { return setLocalValue("PerBufferUnreadBacklogLimit", limit); }
     inline int perBufferUnreadBacklogAdditional() { return localValue("PerBufferUnreadBacklogAdditional", 50).toInt(); }
     inline void setPerBufferUnreadBacklogAdditional(int Additional) { return setLocalValue("PerBufferUnreadBacklogAdditional", Additional); }
+
+    inline bool cacheEnabled() { return localValue("CacheEnabled", true).toBool(); }
+    inline void setCacheEnabled(bool enabled) { return setLocalValue("CacheEnabled", enabled); }
+    // in MB
+    inline int cacheSize() { return localValue("CacheSize", 50).toInt(); }
+    inline void setCacheSize(int size) { return setLocalValue("CacheSize", size); }
+    inline int cacheMessagesPerBuffer() { return localValue("CacheMessagesPerBuffer", 500).toInt(); }
+    inline void setCacheMessagesPerBuffer(int amount) { return setLocalValue("CacheMessagesPerBuffer", amount); }
 };
 
 
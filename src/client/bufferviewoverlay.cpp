@@ -54,6 +54,8 @@ void BufferViewOverlay::reset()
     _buffers.clear();
     _removedBuffers.clear();
     _tempRemovedBuffers.clear();
+
+    _viewBuffers.clear();
 }
 
 
@@ -128,6 +130,7 @@ void BufferViewOverlay::removeView(int viewId)
         return;
 
     _bufferViewIds.remove(viewId);
+    _viewBuffers.remove(viewId);
     BufferViewConfig *config = Client::bufferViewManager()->bufferViewConfig(viewId);
     if (config)
         disconnect(config, 0, this, 0);
@@ -164,6 +167,11 @@ void BufferViewOverlay::viewInitialized(BufferViewConfig *config)
     disconnect(config, SIGNAL(initDone()), this, SLOT(viewInitialized()));
 
     connect(config, SIGNAL(configChanged()), this, SLOT(update()));
+    connect(config, SIGNAL(bufferAdded(const BufferId &, int)), this, SLOT(viewBufferChanged(const BufferId &)));
+    connect(config, SIGNAL(bufferRemoved(const BufferId &)), this, SLOT(viewBufferChanged(const BufferId &)));
+    connect(config, SIGNAL(bufferPermanentlyRemoved(const BufferId &)), this, SLOT(viewBufferChanged(const BufferId &)));
+    connect(config, SIGNAL(bufferListSet()), this, SLOT(viewBufferListSet()));
+    _viewBuffers.remove(config->bufferViewId());
 
     // check if the view was removed in the meantime...
     if (_bufferViewIds.contains(config->bufferViewId()))
@@ -222,9 +230,10 @@ void BufferViewOverlay::updateHelper()
 
             networkIds << config->networkId();
 
-            // we have to apply several filters before we can add a buffer to a category (visible, removed, ...)
-            buffers += filterBuffersByConfig(config->bufferList(), config);
-            tempRemovedBuffers += filterBuffersByConfig(config->temporarilyRemovedBuffers().toList(), config);
+            // the filtered buffers of every view are cached, so only the union is computed here
+            const ViewBuffers &view = viewBuffers(config);
+            buffers += view.buffers;
+            tempRemovedBuffers += view.tempRemovedBuffers;
             removedBuffers += config->removedBuffers();
         }
 
@@ -262,22 +271,86 @@ void BufferViewOverlay::updateHelper()
 }
 
 
-QSet<BufferId> BufferViewOverlay::filterBuffersByConfig(const QList<BufferId> &buffers, const BufferViewConfig *config)
+const BufferViewOverlay::ViewBuffers &BufferViewOverlay::viewBuffers(const BufferViewConfig *config)
 {
     Q_ASSERT(config);
 
-    QSet<BufferId> bufferIds;
-    BufferInfo bufferInfo;
-    foreach(BufferId bufferId, buffers) {
-        bufferInfo = Client::networkModel()->bufferInfo(bufferId);
-        if (!(bufferInfo.type() & config->allowedBufferTypes()))
-            continue;
-        if (config->networkId().isValid() && bufferInfo.networkId() != config->networkId())
-            continue;
-        bufferIds << bufferId;
+    ViewBuffers &view = _viewBuffers[config->bufferViewId()];
+    if (!view.isValid || view.networkId != config->networkId() || view.allowedBufferTypes != config->allowedBufferTypes()) {
+        // we have to apply several filters before we can add a buffer to a category (visible, removed, ...)
+        view = ViewBuffers();
+        view.networkId = config->networkId();
+        view.allowedBufferTypes = config->allowedBufferTypes();
+        view.isValid = true;
+        foreach(BufferId bufferId, config->bufferList()) {
+            if (acceptBuffer(view, bufferId))
+                view.buffers << bufferId;
+        }
+        foreach(BufferId bufferId, config->temporarilyRemovedBuffers()) {
+            if (acceptBuffer(view, bufferId))
+                view.tempRemovedBuffers << bufferId;
+        }
+    }
+    else if (!view.unknownBuffers.isEmpty()) {
+        QSet<BufferId> unknownBuffers = view.unknownBuffers;
+        view.unknownBuffers.clear();
+        foreach(BufferId bufferId, unknownBuffers) {
+            sortBuffer(view, config, bufferId);
+        }
     }
+    return view;
+}
 
-    return bufferIds;
+
+void BufferViewOverlay::sortBuffer(ViewBuffers &view, const BufferViewConfig *config, const BufferId &bufferId)
+{
+    view.buffers.remove(bufferId);
+    view.tempRemovedBuffers.remove(bufferId);
+    view.unknownBuffers.remove(bufferId);
+
+    if (config->containsBuffer(bufferId)) {
+        if (acceptBuffer(view, bufferId))
+            view.buffers << bufferId;
+    }
+    else if (config->temporarilyRemovedBuffers().contains(bufferId)) {
+        if (acceptBuffer(view, bufferId))
+            view.tempRemovedBuffers << bufferId;
+    }
+}
+
+
+bool BufferViewOverlay::acceptBuffer(ViewBuffers &view, const BufferId &bufferId)
+{
+    BufferInfo bufferInfo = Client::networkModel()->bufferInfo(bufferId);
+    if (!bufferInfo.isValid()) {
+        view.unknownBuffers << bufferId;
+        return false;
+    }
+    if (!(bufferInfo.type() & view.allowedBufferTypes))
+        return false;
+    if (view.networkId.isValid() && bufferInfo.networkId() != view.networkId)
+        return false;
+    return true;
+}
+
+
+void BufferViewOverlay::viewBufferChanged(const BufferId &bufferId)
+{
+    BufferViewConfig *config = qobject_cast<BufferViewConfig *>(sender());
+    if (!config)
+        return;
+
+    QHash<int, ViewBuffers>::iterator view = _viewBuffers.find(config->bufferViewId());
+    if (view != _viewBuffers.end() && view->isValid)
+        sortBuffer(*view, config, bufferId);
+}
+
+
+void BufferViewOverlay::viewBufferListSet()
+{
+    BufferViewConfig *config = qobject_cast<BufferViewConfig *>(sender());
+    if (config)
+        _viewBuffers.remove(config->bufferViewId());
 }
 
 
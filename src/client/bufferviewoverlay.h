@@ -70,9 +70,26 @@ private slots:
     void viewInitialized();
     void viewInitialized(BufferViewConfig *config);
 
+    // keep the cached buffers of a view in sync with single changes
+    void viewBufferChanged(const BufferId &bufferId);
+    void viewBufferListSet();
+
 private:
+    //! The buffers a single view contributes to the overlay, with the view's filters applied
+    struct ViewBuffers {
+        NetworkId networkId;
+        int allowedBufferTypes;
+        QSet<BufferId> buffers;
+        QSet<BufferId> tempRemovedBuffers;
+        QSet<BufferId> unknownBuffers; // not in the network model yet, checked again on every update
+        bool isValid;
+        ViewBuffers() : allowedBufferTypes(0), isValid(false) {}
+    };
+
     void updateHelper();
-    QSet<BufferId> filterBuffersByConfig(const QList<BufferId> &buffers, const BufferViewConfig *config);
+    const ViewBuffers &viewBuffers(const BufferViewConfig *config);
+    void sortBuffer(ViewBuffers &view, const BufferViewConfig *config, const BufferId &bufferId);
+    bool acceptBuffer(ViewBuffers &view, const BufferId &bufferId);
 
     bool _aboutToUpdate;
 
@@ -87,6 +104,8 @@ private:
     QSet<BufferId> _removedBuffers;
     QSet<BufferId> _tempRemovedBuffers;
 
+    QHash<int, ViewBuffers> _viewBuffers;
+
     static const int _updateEventId;
 };
 
@@ -33,6 +33,7 @@
 #include "clientbufferviewmanager.h"
 #include "clientirclisthelper.h"
 #include "clientidentity.h"
+#include "clienthighlightrulemanager.h"
 #include "clientignorelistmanager.h"
 #include "clienttransfermanager.h"
 #include "clientuserinputhandler.h"
@@ -103,6 +104,7 @@ Client::Client(QObject *parent)
     _inputHandler(0),
     _networkConfig(0),
     _ignoreListManager(0),
+    _highlightRuleManager(0),
     _transferManager(0),
     _messageModel(0),
     _messageProcessor(0),
@@ -160,10 +162,13 @@ void Client::init()
     // attach backlog manager
     p->synchronize(backlogManager());
     connect(backlogManager(), SIGNAL(messagesReceived(BufferId, int)), _messageModel, SLOT(messagesReceived(BufferId, int)));
+    connect(messageProcessor(), SIGNAL(pendingMessagesInserted()), backlogManager(), SLOT(emitMessagesReceived()));
 
     coreAccountModel()->load();
 
     connect(coreConnection(), SIGNAL(stateChanged(CoreConnection::ConnectionState)), SLOT(connectionStateChanged(CoreConnection::ConnectionState)));
+    connect(coreConnection(), SIGNAL(resumeAborted()), SLOT(setDisconnectedFromCore()));
+    connect(coreConnection(), SIGNAL(sessionDiscarded()), SLOT(discardSessionState()));
     coreConnection()->init();
 }
 
@@ -359,10 +364,14 @@ void Client::connectionStateChanged(CoreConnection::ConnectionState state)
 {
     switch (state) {
     case CoreConnection::Disconnected:
-        setDisconnectedFromCore();
+        // keep our state while trying to resume the session
+        if (!coreConnection()->isResuming())
+            setDisconnectedFromCore();
         break;
     case CoreConnection::Synchronized:
-        setSyncedToCore();
+        // a resumed session is still set up
+        if (!_connected)
+            setSyncedToCore();
         break;
     default:
         break;
@@ -376,6 +385,7 @@ void Client::setSyncedToCore()
     Q_ASSERT(!_bufferSyncer);
     _bufferSyncer = new BufferSyncer(this);
     connect(bufferSyncer(), SIGNAL(lastSeenMsgSet(BufferId, MsgId)), _networkModel, SLOT(setLastSeenMsgId(BufferId, MsgId)));
+    connect(bufferSyncer(), SIGNAL(activityCountSet(BufferId, int, int)), _networkModel, SLOT(setBufferActivityCount(BufferId, int, int)));
     connect(bufferSyncer(), SIGNAL(markerLineSet(BufferId, MsgId)), _networkModel, SLOT(setMarkerLineMsgId(BufferId, MsgId)));
     connect(bufferSyncer(), SIGNAL(bufferRemoved(BufferId)), this, SLOT(bufferRemoved(BufferId)));
     connect(bufferSyncer(), SIGNAL(bufferRenamed(BufferId, QString)), this, SLOT(bufferRenamed(BufferId, QString)));
@@ -404,8 +414,17 @@ void Client::setSyncedToCore()
     // create IgnoreListManager
     Q_ASSERT(!_ignoreListManager);
     _ignoreListManager = new ClientIgnoreListManager(this);
+    // connected first, so cached verdicts are dropped before the filters reevaluate
+    connect(ignoreListManager(), SIGNAL(ignoreListChanged()), _messageModel, SLOT(invalidateIgnoreVerdicts()));
     signalProxy()->synchronize(ignoreListManager());
 
+    // create HighlightRuleManager, if the core flags highlights itself
+    Q_ASSERT(!_highlightRuleManager);
+    if (coreFeatures() & Quassel::CoreSideHighlights) {
+        _highlightRuleManager = new ClientHighlightRuleManager(this);
+        signalProxy()->synchronize(highlightRuleManager());
+    }
+
     Q_ASSERT(!_transferManager);
     _transferManager = new ClientTransferManager(this);
     signalProxy()->synchronize(transferManager());
@@ -432,6 +451,7 @@ void Client::requestInitialBacklog()
     disconnect(bufferViewOverlay(), SIGNAL(initDone()), this, SLOT(requestInitialBacklog()));
     disconnect(bufferSyncer(), SIGNAL(initDone()), this, SLOT(requestInitialBacklog()));
 
+    coreConnection()->markLoginPhase("session objects", true);
     _backlogManager->requestInitialBacklog();
 }
 
@@ -453,6 +473,21 @@ void Client::setDisconnectedFromCore()
     emit disconnected();
     emit coreConnectionStateChanged(false);
 
+    clearSessionState();
+}
+
+
+// The core replaced our session while we tried to resume it. Unlike a disconnect, the features of the
+// new login must survive and no disconnected() is emitted, as setSyncedToCore() follows right away.
+void Client::discardSessionState()
+{
+    _connected = false;
+    clearSessionState();
+}
+
+
+void Client::clearSessionState()
+{
     backlogManager()->reset();
     messageProcessor()->reset();
 
@@ -480,6 +515,11 @@ void Client::setDisconnectedFromCore()
         _ignoreListManager = 0;
     }
 
+    if (_highlightRuleManager) {
+        _highlightRuleManager->deleteLater();
+        _highlightRuleManager = 0;
+    }
+
     if (_transferManager) {
         _transferManager->deleteLater();
         _transferManager = 0;
@@ -546,6 +586,7 @@ void Client::recvMessage(const Message &msg)
 {
     Message msg_ = msg;
     messageProcessor()->process(msg_);
+    backlogManager()->cacheMessage(msg_);
 }
 
 
@@ -619,6 +660,7 @@ void Client::bufferRemoved(BufferId bufferId)
 
     // and remove it from the model
     networkModel()->removeBuffer(bufferId);
+    backlogManager()->invalidateCache(bufferId);
 }
 
 
@@ -633,6 +675,9 @@ void Client::bufferRenamed(BufferId bufferId, const QString &newName)
 
 void Client::buffersPermanentlyMerged(BufferId bufferId1, BufferId bufferId2)
 {
+    backlogManager()->invalidateCache(bufferId1);
+    backlogManager()->invalidateCache(bufferId2);
+
     QModelIndex idx = networkModel()->bufferIndex(bufferId1);
     bufferModel()->setCurrentIndex(bufferModel()->mapFromSource(idx));
     networkModel()->removeBuffer(bufferId2);
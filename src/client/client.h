@@ -47,6 +47,7 @@ class BufferViewOverlay;
 class ClientAliasManager;
 class ClientBacklogManager;
 class ClientBufferViewManager;
+class ClientHighlightRuleManager;
 class ClientIgnoreListManager;
 class ClientIrcListHelper;
 class ClientTransferManager;
@@ -119,6 +120,7 @@ public:
     static inline ClientUserInputHandler *inputHandler() { return instance()->_inputHandler; }
     static inline NetworkConfig *networkConfig() { return instance()->_networkConfig; }
     static inline ClientIgnoreListManager *ignoreListManager() { return instance()->_ignoreListManager; }
+    static inline ClientHighlightRuleManager *highlightRuleManager() { return instance()->_highlightRuleManager; }
     static inline ClientTransferManager *transferManager() { return instance()->_transferManager; }
 
     static inline CoreAccountModel *coreAccountModel() { return instance()->_coreAccountModel; }
@@ -203,6 +205,7 @@ public slots:
 private slots:
     void setSyncedToCore();
     void setDisconnectedFromCore();
+    void discardSessionState();
     void connectionStateChanged(CoreConnection::ConnectionState);
 
     void recvMessage(const Message &message);
@@ -222,6 +225,7 @@ private:
     Client(QObject *parent = 0);
     virtual ~Client();
     void init();
+    void clearSessionState();
 
     static void addNetwork(Network *);
     static inline BufferSyncer *bufferSyncer() { return instance()->_bufferSyncer; }
@@ -241,6 +245,7 @@ private:
     ClientUserInputHandler *_inputHandler;
     NetworkConfig *_networkConfig;
     ClientIgnoreListManager *_ignoreListManager;
+    ClientHighlightRuleManager *_highlightRuleManager;
     ClientTransferManager *_transferManager;
 
     MessageModel *_messageModel;
@@ -42,12 +42,20 @@ ClientAuthHandler::ClientAuthHandler(CoreAccount account, QObject *parent)
     _account(account),
     _probing(false),
     _legacy(false),
-    _connectionFeatures(0)
+    _connectionFeatures(0),
+    _resumeSequence(0)
 {
 
 }
 
 
+void ClientAuthHandler::setResumeInfo(const QByteArray &token, quint64 lastSequence)
+{
+    _resumeToken = token;
+    _resumeSequence = lastSequence;
+}
+
+
 void ClientAuthHandler::connectToCore()
 {
     CoreAccountSettings s;
@@ -283,7 +291,7 @@ void ClientAuthHandler::startRegistration()
     useSsl = _account.useSsl();
 #endif
 
-    _peer->dispatch(RegisterClient(Quassel::buildInfo().fancyVersionString, Quassel::buildInfo().buildDate, useSsl));
+    _peer->dispatch(RegisterClient(Quassel::features(), Quassel::buildInfo().fancyVersionString, Quassel::buildInfo().buildDate, useSsl));
 }
 
 
@@ -364,7 +372,10 @@ void ClientAuthHandler::login(const QString &previousError)
         }
     }
 
-    _peer->dispatch(Login(_account.user(), _account.password()));
+    Login msg(_account.user(), _account.password());
+    msg.resumeToken = _resumeToken;
+    msg.lastSequence = _resumeSequence;
+    _peer->dispatch(msg);
 }
 
 
@@ -36,6 +36,9 @@ class ClientAuthHandler : public AuthHandler
 public:
     ClientAuthHandler(CoreAccount account, QObject *parent = 0);
 
+    //! Asks the core to resume a previous session on login (\sa Protocol::Login)
+    void setResumeInfo(const QByteArray &token, quint64 lastSequence);
+
 public slots:
     void connectToCore();
 
@@ -107,6 +110,8 @@ private:
     bool _probing;
     bool _legacy;
     quint8 _connectionFeatures;
+    QByteArray _resumeToken;
+    quint64 _resumeSequence;
 };
 
 #endif
@@ -21,6 +21,7 @@
 #include "clientbacklogmanager.h"
 
 #include "abstractmessageprocessor.h"
+#include "backlogcache.h"
 #include "backlogsettings.h"
 #include "backlogrequester.h"
 #include "client.h"
@@ -33,8 +34,21 @@ INIT_SYNCABLE_OBJECT(ClientBacklogManager)
 ClientBacklogManager::ClientBacklogManager(QObject *parent)
     : BacklogManager(parent),
     _requester(0),
-    _initBacklogRequested(false)
+    _initBacklogRequested(false),
+    _cache(0),
+    _messagesFromCache(0)
 {
+    _cacheFlushTimer.setSingleShot(true);
+    _cacheFlushTimer.setInterval(2000);
+    connect(&_cacheFlushTimer, SIGNAL(timeout()), SLOT(flushCache()));
+}
+
+
+ClientBacklogManager::~ClientBacklogManager()
+{
+    delete _requester;
+    flushCache();
+    delete _cache;
 }
 
 
@@ -49,8 +63,6 @@ void ClientBacklogManager::receiveBacklog(BufferId bufferId, MsgId first, MsgId
 {
     Q_UNUSED(first) Q_UNUSED(last) Q_UNUSED(limit) Q_UNUSED(additional)
 
-    emit messagesReceived(bufferId, msgs.count());
-
     MessageList msglist;
     foreach(QVariant v, msgs) {
         Message msg = v.value<Message>();
@@ -58,20 +70,148 @@ void ClientBacklogManager::receiveBacklog(BufferId bufferId, MsgId first, MsgId
         msglist << msg;
     }
 
+    processBacklog(bufferId, msglist);
+}
+
+
+QVariantList ClientBacklogManager::requestBacklogMulti(const QVariantList &requests)
+{
+    foreach(const QVariant &v, requests) {
+        _buffersRequested << v.toList().value(0).value<BufferId>();
+    }
+    return BacklogManager::requestBacklogMulti(requests);
+}
+
+
+void ClientBacklogManager::receiveBacklogMulti(QVariantList requests, QVariantList msgs)
+{
+    QHash<BufferId, MessageList> msglists;
+    foreach(QVariant v, msgs) {
+        Message msg = v.value<Message>();
+        msg.setFlags(msg.flags() | Message::Backlog);
+        msglists[msg.bufferInfo().bufferId()] << msg;
+    }
+
+    // every requested buffer gets processed, even if it had no messages
+    QSet<BufferId> processed;
+    foreach(const QVariant &v, requests) {
+        BufferId bufferId = v.toList().value(0).value<BufferId>();
+        if (processed.contains(bufferId))
+            continue;
+        processed << bufferId;
+        processBacklog(bufferId, msglists.value(bufferId));
+    }
+}
+
+
+void ClientBacklogManager::processBacklog(BufferId bufferId, const MessageList &received)
+{
+    MessageList msglist = received;
+    if (_cache && _expectedBacklog.contains(bufferId)) {
+        flushCache(); // queued messages are older than the reply
+        int cachedLimit = _expectedBacklog.take(bufferId);
+        if (cachedLimit < 0 || received.count() >= cachedLimit) {
+            // either a full request, or there may be a gap between the cache and the reply
+            _cache->remove(bufferId);
+        }
+        else {
+            MessageList cached = _cache->messages(bufferId, cachedLimit - received.count());
+            for (int i = 0; i < cached.count(); i++) {
+                cached[i].setFlags(cached[i].flags() | Message::Backlog);
+            }
+            msglist += cached;
+            _messagesFromCache += cached.count();
+        }
+        _cache->append(received);
+        _cachedBuffers << bufferId;
+
+        // live messages that arrived while the request was pending connect to the reply
+        foreach(const Message &msg, _heldBackMessages.take(bufferId)) {
+            cacheMessage(msg);
+        }
+    }
+
     if (isBuffering()) {
+        _bufferedCounts << qMakePair(bufferId, msglist.count());
         bool lastPart = !_requester->buffer(bufferId, msglist);
         updateProgress(_requester->totalBuffers() - _requester->buffersWaiting(), _requester->totalBuffers());
         if (lastPart) {
             dispatchMessages(_requester->bufferedMessages(), true);
             _requester->flushBuffer();
+            _dispatchedCounts += _bufferedCounts;
+            _bufferedCounts.clear();
+            emitMessagesReceived();
+            if (_messagesFromCache) {
+                emit messagesProcessed(tr("Loaded %1 messages from the local backlog cache.").arg(_messagesFromCache));
+                _messagesFromCache = 0;
+            }
         }
     }
     else {
         dispatchMessages(msglist);
+        _dispatchedCounts << qMakePair(bufferId, msglist.count());
+        emitMessagesReceived();
     }
 }
 
 
+void ClientBacklogManager::emitMessagesReceived()
+{
+    // the processor may still be inserting the messages; we get called again when it's done
+    if (Client::messageProcessor()->hasPendingMessages())
+        return;
+
+    QList<QPair<BufferId, int> > counts = _dispatchedCounts;
+    _dispatchedCounts.clear();
+    for (int i = 0; i < counts.count(); i++) {
+        emit messagesReceived(counts.at(i).first, counts.at(i).second);
+    }
+}
+
+
+void ClientBacklogManager::cacheMessage(const Message &msg)
+{
+    if (!_cache)
+        return;
+
+    BufferId bufferId = msg.bufferInfo().bufferId();
+    if (_expectedBacklog.contains(bufferId)) {
+        _heldBackMessages[bufferId] << msg;
+    }
+    else if (_cachedBuffers.contains(bufferId)) {
+        _cacheQueue << msg;
+        if (!_cacheFlushTimer.isActive())
+            _cacheFlushTimer.start();
+    }
+}
+
+
+void ClientBacklogManager::flushCache()
+{
+    _cacheFlushTimer.stop();
+
+    // skip buffers that have been invalidated since their messages were queued
+    MessageList messages;
+    foreach(const Message &msg, _cacheQueue) {
+        if (_cachedBuffers.contains(msg.bufferInfo().bufferId()))
+            messages << msg;
+    }
+    _cacheQueue.clear();
+
+    if (_cache && !messages.isEmpty())
+        _cache->append(messages);
+}
+
+
+void ClientBacklogManager::invalidateCache(BufferId bufferId)
+{
+    _cachedBuffers.remove(bufferId);
+    _heldBackMessages.remove(bufferId);
+    if (_cache)
+        _cache->remove(bufferId);
+}
+
+
 void ClientBacklogManager::receiveBacklogAll(MsgId first, MsgId last, int limit, int additional, QVariantList msgs)
 {
     Q_UNUSED(first) Q_UNUSED(last) Q_UNUSED(limit) Q_UNUSED(additional)
@@ -87,6 +227,47 @@ void ClientBacklogManager::receiveBacklogAll(MsgId first, MsgId last, int limit,
 }
 
 
+void ClientBacklogManager::receiveBacklogHighlights(MsgId first, int limit, QVariantList msgs)
+{
+    Q_UNUSED(first) Q_UNUSED(limit)
+
+    MessageList msglist;
+    foreach(QVariant v, msgs) {
+        Message msg = v.value<Message>();
+        msg.setFlags(msg.flags() | Message::Backlog);
+        msglist << msg;
+    }
+
+    dispatchMessages(msglist, true);
+}
+
+
+void ClientBacklogManager::receiveBacklogByTime(BufferId bufferId, QDateTime time, MsgId first, MsgId last, int before, int after, QVariantList msgs)
+{
+    Q_UNUSED(first)
+
+    MessageList msglist;
+    MsgId newest;
+    foreach(QVariant v, msgs) {
+        Message msg = v.value<Message>();
+        if (msg.msgId() > newest)
+            newest = msg.msgId();
+        msg.setFlags(msg.flags() | Message::Backlog);
+        msglist << msg;
+    }
+
+    // a full page after the split might not be all of it, so continue right after its newest message until we reach 'last'.
+    // Paging by MsgId rather than by time, since timestamps don't tell apart the messages of a burst.
+    if (!before && after > 0 && msglist.count() >= after) {
+        MsgId next = newest.toInt() + 1;
+        if (last == -1 || next < last)
+            requestBacklogByTime(bufferId, time, next, last, 0, after);
+    }
+
+    processBacklog(bufferId, msglist);
+}
+
+
 void ClientBacklogManager::requestInitialBacklog()
 {
     if (_initBacklogRequested) {
@@ -96,6 +277,10 @@ void ClientBacklogManager::requestInitialBacklog()
     }
 
     BacklogSettings settings;
+    AccountId accountId = Client::currentCoreAccount().accountId();
+    if (settings.cacheEnabled() && accountId.isValid())
+        _cache = new BacklogCache(accountId, (qint64)settings.cacheSize() * 1024 * 1024, settings.cacheMessagesPerBuffer());
+
     switch (settings.requesterType()) {
     case BacklogRequester::GlobalUnread:
         _requester = new GlobalUnreadBacklogRequester(this);
@@ -185,4 +370,14 @@ void ClientBacklogManager::reset()
     _requester = 0;
     _initBacklogRequested = false;
     _buffersRequested.clear();
+    _bufferedCounts.clear();
+    _dispatchedCounts.clear();
+
+    flushCache();
+    delete _cache;
+    _cache = 0;
+    _expectedBacklog.clear();
+    _cachedBuffers.clear();
+    _heldBackMessages.clear();
+    _messagesFromCache = 0;
 }
@@ -21,9 +21,12 @@
 #ifndef CLIENTBACKLOGMANAGER_H
 #define CLIENTBACKLOGMANAGER_H
 
+#include <QTimer>
+
 #include "backlogmanager.h"
 #include "message.h"
 
+class BacklogCache;
 class BacklogRequester;
 
 class ClientBacklogManager : public BacklogManager
@@ -33,16 +36,37 @@ class ClientBacklogManager : public BacklogManager
 
 public:
     ClientBacklogManager(QObject *parent = 0);
+    ~ClientBacklogManager();
 
     // helper for the backlogRequester, as it isn't a QObject and can't emit itself
     inline void emitMessagesRequested(const QString &msg) const { emit messagesRequested(msg); }
 
     void reset();
 
+    //! The local backlog cache of the current core account, if enabled
+    inline BacklogCache *cache() const { return _cache; }
+
+    //! Called by the requester for every buffer it requests backlog for
+    /** \param cachedLimit The number of messages wanted if the request only asks for messages newer
+     *                     than the cache, or -1 if the reply replaces the cached messages
+     */
+    inline void expectBacklog(BufferId bufferId, int cachedLimit) { _expectedBacklog[bufferId] = cachedLimit; }
+
+    //! Queues a live message for the cache if its buffer's cache is up to date
+    /** Messages for buffers with a pending backlog request are held back until the reply has been
+     *  cached, so the cached range stays contiguous. Queued messages are written in batches.
+     */
+    void cacheMessage(const Message &msg);
+    void invalidateCache(BufferId bufferId);
+
 public slots:
     virtual QVariantList requestBacklog(BufferId bufferId, MsgId first = -1, MsgId last = -1, int limit = -1, int additional = 0);
     virtual void receiveBacklog(BufferId bufferId, MsgId first, MsgId last, int limit, int additional, QVariantList msgs);
     virtual void receiveBacklogAll(MsgId first, MsgId last, int limit, int additional, QVariantList msgs);
+    virtual QVariantList requestBacklogMulti(const QVariantList &requests);
+    virtual void receiveBacklogMulti(QVariantList requests, QVariantList msgs);
+    virtual void receiveBacklogHighlights(MsgId first, int limit, QVariantList msgs);
+    virtual void receiveBacklogByTime(BufferId bufferId, QDateTime time, MsgId first, MsgId last, int before, int after, QVariantList msgs);
 
     void requestInitialBacklog();
 
@@ -56,15 +80,33 @@ signals:
 
     void updateProgress(int, int);
 
+private slots:
+    void flushCache();
+    void emitMessagesReceived();
+
 private:
     bool isBuffering();
     BufferIdList filterNewBufferIds(const BufferIdList &bufferIds);
 
+    void processBacklog(BufferId bufferId, const MessageList &received);
+
     void dispatchMessages(const MessageList &messages, bool sort = false);
 
     BacklogRequester *_requester;
     bool _initBacklogRequested;
     QSet<BufferId> _buffersRequested;
+
+    // received counts are only reported once the messages are in the model
+    QList<QPair<BufferId, int> > _bufferedCounts;
+    QList<QPair<BufferId, int> > _dispatchedCounts;
+
+    BacklogCache *_cache;
+    QHash<BufferId, int> _expectedBacklog;
+    QSet<BufferId> _cachedBuffers; // buffers whose cache is in sync with the core
+    QHash<BufferId, MessageList> _heldBackMessages; // live messages received while a request is pending
+    MessageList _cacheQueue;
+    QTimer _cacheFlushTimer;
+    int _messagesFromCache;
 };
 
 
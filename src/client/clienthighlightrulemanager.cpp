@@ -0,0 +1,71 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+#include "clienthighlightrulemanager.h"
+
+#include "clientsettings.h"
+
+INIT_SYNCABLE_OBJECT(ClientHighlightRuleManager)
+
+ClientHighlightRuleManager::ClientHighlightRuleManager(QObject *parent)
+    : HighlightRuleManager(parent)
+{
+    NotificationSettings notificationSettings;
+    notificationSettings.notify("Highlights/CustomList", this, SLOT(pushSettings()));
+    notificationSettings.notify("Highlights/HighlightNick", this, SLOT(pushSettings()));
+    notificationSettings.notify("Highlights/NicksCaseSensitive", this, SLOT(pushSettings()));
+
+    // the settings are kept on the client, so whatever the core had is replaced
+    connect(this, SIGNAL(initDone()), SLOT(pushSettings()));
+}
+
+
+void ClientHighlightRuleManager::pushSettings()
+{
+    if (!isInitialized())
+        return;
+
+    NotificationSettings notificationSettings;
+    QStringList nameList;
+    QVariantList isRegExList;
+    QVariantList isCaseSensitiveList;
+    QVariantList isEnabledList;
+    QStringList chanNameList;
+    foreach(const QVariant &v, notificationSettings.highlightList()) {
+        QVariantMap rule = v.toMap();
+        nameList << rule["Name"].toString();
+        isRegExList << rule["RegEx"].toBool();
+        isCaseSensitiveList << rule["CS"].toBool();
+        isEnabledList << rule["Enable"].toBool();
+        chanNameList << rule["Channel"].toString();
+    }
+
+    QVariantMap highlightRuleList;
+    highlightRuleList["name"] = nameList;
+    highlightRuleList["isRegEx"] = isRegExList;
+    highlightRuleList["isCaseSensitive"] = isCaseSensitiveList;
+    highlightRuleList["isEnabled"] = isEnabledList;
+    highlightRuleList["chanName"] = chanNameList;
+
+    QVariantMap properties;
+    properties["HighlightRuleList"] = highlightRuleList;
+    properties["highlightNick"] = (int)notificationSettings.highlightNick();
+    properties["nicksCaseSensitive"] = notificationSettings.nicksCaseSensitive();
+    requestUpdate(properties);
+}
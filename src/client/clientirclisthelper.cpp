@@ -29,10 +29,23 @@ INIT_SYNCABLE_OBJECT(ClientIrcListHelper)
 QVariantList ClientIrcListHelper::requestChannelList(const NetworkId &netId, const QStringList &channelFilters)
 {
     _netId = netId;
+    if (!channelFilters.isEmpty()) {
+        _query = channelFilters.join(",");
+        _nextOffset = 0;
+        _pageRequestPending = false;
+        _listFinished = false;
+    }
     return IrcListHelper::requestChannelList(netId, channelFilters);
 }
 
 
+void ClientIrcListHelper::requestFilteredChannelList(const NetworkId &netId, const QStringList &channelFilters, const QVariantMap &filter)
+{
+    _filter = filter;
+    requestChannelList(netId, channelFilters);
+}
+
+
 void ClientIrcListHelper::receiveChannelList(const NetworkId &netId, const QStringList &channelFilters, const QVariantList &channels)
 {
     QVariantList::const_iterator iter = channels.constBegin();
@@ -50,10 +63,65 @@ void ClientIrcListHelper::receiveChannelList(const NetworkId &netId, const QStri
 }
 
 
-void ClientIrcListHelper::reportFinishedList(const NetworkId &netId)
+void ClientIrcListHelper::receiveChannelListPage(const NetworkId &netId, const QVariantMap &filter, int offset, const QVariantMap &page)
 {
-    if (_netId == netId) {
-        requestChannelList(netId, QStringList());
+    if (netId != _netId || filter != _filter || offset != _nextOffset)
+        return;
+
+    _pageRequestPending = false;
+    if (page.isEmpty())
+        return;
+
+    if (page["Query"].toString() != _query) {
+        // the core is still busy with a previous query; wait for the progress of ours
+        _listFinished = false;
+        return;
+    }
+
+    QList<ChannelDescription> channelList;
+    foreach(const QVariant &channel, page["Channels"].toList()) {
+        QVariantList channelVar = channel.toList();
+        channelList << ChannelDescription(channelVar[0].toString(), channelVar[1].toUInt(), channelVar[2].toString());
+    }
+    if (!channelList.isEmpty())
+        emit channelListPageReceived(netId, channelList);
+
+    _nextOffset = page["NextOffset"].toInt();
+    if (_nextOffset < page["Total"].toInt() || (_listFinished && !page["Finished"].toBool()))
+        requestNextPage();
+    else if (page["Finished"].toBool())
         emit finishedListReported(netId);
+}
+
+
+void ClientIrcListHelper::reportChannelListProgress(const NetworkId &netId, int channelCount)
+{
+    if (_netId == netId && _nextOffset < channelCount && (Client::coreFeatures() & Quassel::PagedChannelList))
+        requestNextPage();
+}
+
+
+void ClientIrcListHelper::reportFinishedList(const NetworkId &netId)
+{
+    if (_netId != netId)
+        return;
+
+    if (Client::coreFeatures() & Quassel::PagedChannelList) {
+        _listFinished = true;
+        requestNextPage();
+        return;
     }
+
+    requestChannelList(netId, QStringList());
+    emit finishedListReported(netId);
+}
+
+
+void ClientIrcListHelper::requestNextPage()
+{
+    if (_pageRequestPending)
+        return;
+
+    _pageRequestPending = true;
+    requestChannelListPage(_netId, _filter, _nextOffset);
 }
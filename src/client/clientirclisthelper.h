@@ -29,23 +29,39 @@ class ClientIrcListHelper : public IrcListHelper
         Q_OBJECT
 
 public:
-    inline ClientIrcListHelper(QObject *object = 0) : IrcListHelper(object) {};
+    inline ClientIrcListHelper(QObject *object = 0) : IrcListHelper(object), _nextOffset(0), _pageRequestPending(false), _listFinished(false) {};
 
     inline virtual const QMetaObject *syncMetaObject() const { return &IrcListHelper::staticMetaObject; }
 
+    //! Requests a channel list, having the core apply the given filter if it supports paged lists
+    /** With Quassel::PagedChannelList, the list is delivered in chunks via channelListPageReceived(),
+     *  otherwise as a whole via channelListReceived() and the filter is ignored.
+     */
+    void requestFilteredChannelList(const NetworkId &netId, const QStringList &channelFilters, const QVariantMap &filter);
+
 public slots:
     virtual QVariantList requestChannelList(const NetworkId &netId, const QStringList &channelFilters);
     virtual void receiveChannelList(const NetworkId &netId, const QStringList &channelFilters, const QVariantList &channels);
+    virtual void receiveChannelListPage(const NetworkId &netId, const QVariantMap &filter, int offset, const QVariantMap &page);
+    virtual void reportChannelListProgress(const NetworkId &netId, int channelCount);
     virtual void reportFinishedList(const NetworkId &netId);
     inline virtual void reportError(const QString &error) { emit errorReported(error); }
 
 signals:
     void channelListReceived(const NetworkId &netId, const QStringList &channelFilters, const QList<IrcListHelper::ChannelDescription> &channelList);
+    void channelListPageReceived(const NetworkId &netId, const QList<IrcListHelper::ChannelDescription> &channelList);
     void finishedListReported(const NetworkId &netId);
     void errorReported(const QString &error);
 
 private:
+    void requestNextPage();
+
     NetworkId _netId;
+    QString _query;
+    QVariantMap _filter;
+    int _nextOffset;
+    bool _pageRequestPending;
+    bool _listFinished;
 };
 
 
@@ -40,9 +40,11 @@ CoreConnection::CoreConnection(QObject *parent)
     _state(Disconnected),
     _wantReconnect(false),
     _wasReconnect(false),
+    _resuming(false),
     _progressMinimum(0),
     _progressMaximum(-1),
     _progressValue(-1),
+    _loginPhaseStart(0),
     _resetting(false)
 {
     qRegisterMetaType<ConnectionState>("CoreConnection::ConnectionState");
@@ -57,6 +59,10 @@ void CoreConnection::init()
     _reconnectTimer.setSingleShot(true);
     connect(&_reconnectTimer, SIGNAL(timeout()), SLOT(reconnectTimeout()));
 
+    _resumeTimer.setSingleShot(true);
+    _resumeTimer.setInterval(resumeTimeoutSecs * 1000);
+    connect(&_resumeTimer, SIGNAL(timeout()), SLOT(abortResume()));
+
 #ifdef HAVE_KDE
     connect(Solid::Networking::notifier(), SIGNAL(statusChanged(Solid::Networking::Status)),
         SLOT(solidNetworkStatusChanged(Solid::Networking::Status)));
@@ -222,10 +228,27 @@ bool CoreConnection::isLocalConnection() const
 
 void CoreConnection::onConnectionReady()
 {
+    markLoginPhase("connect");
     setState(Connected);
 }
 
 
+void CoreConnection::markLoginPhase(const QString &phase, bool last)
+{
+    if (_loginTimer.isNull())
+        return;
+
+    int elapsed = _loginTimer.elapsed();
+    _loginPhases << QString("%1 %2 ms").arg(phase).arg(elapsed - _loginPhaseStart);
+    _loginPhaseStart = elapsed;
+
+    if (last) {
+        qDebug() << "Login to" << currentAccount().accountName() << "took" << elapsed << "ms:" << qPrintable(_loginPhases.join(", "));
+        _loginTimer = QTime();
+    }
+}
+
+
 void CoreConnection::setState(ConnectionState state)
 {
     if (state != _state) {
@@ -247,9 +270,33 @@ void CoreConnection::coreSocketError(QAbstractSocket::SocketError error, const Q
 
 void CoreConnection::coreSocketDisconnected()
 {
+    // if we lose an established connection, try to pick up where we left off
+    bool resume = state() == Synchronized && !_resumeToken.isEmpty() && !_resuming && CoreConnectionSettings().autoReconnect();
+    if (resume) {
+        _resuming = true;
+        _wantReconnect = true;
+        _resumeTimer.start();
+    }
+
     setState(Disconnected);
     _wasReconnect = false;
     resetConnection(_wantReconnect);
+
+    // don't wait for the reconnect interval, the core only keeps our session around for a while
+    if (resume)
+        QTimer::singleShot(0, this, SLOT(reconnectTimeout()));
+}
+
+
+void CoreConnection::abortResume()
+{
+    _resumeToken.clear();
+    if (!_resuming)
+        return;
+
+    _resuming = false;
+    _resumeTimer.stop();
+    emit resumeAborted();
 }
 
 
@@ -261,6 +308,9 @@ void CoreConnection::disconnectFromCore()
 
 void CoreConnection::disconnectFromCore(const QString &errorString, bool wantReconnect)
 {
+    if (!wantReconnect)
+        abortResume();
+
     if (wantReconnect)
         _reconnectTimer.start();
     else
@@ -305,6 +355,7 @@ void CoreConnection::resetConnection(bool wantReconnect)
 
     _netsToSync.clear();
     _numNetsToSync = 0;
+    _loginTimer = QTime();
 
     setProgressMaximum(-1); // disable
     setState(Disconnected);
@@ -338,6 +389,9 @@ bool CoreConnection::connectToCore(AccountId accId)
     if (isConnected())
         return false;
 
+    if (accId.isValid() && accId != currentAccount().accountId())
+        abortResume();
+
     CoreAccountSettings s;
 
     // FIXME: Don't force connection to internal core in mono client
@@ -380,6 +434,10 @@ void CoreConnection::connectToCurrentAccount()
         return;
     }
 
+    _loginTimer.start();
+    _loginPhaseStart = 0;
+    _loginPhases.clear();
+
     if (currentAccount().isInternal()) {
         if (Quassel::runMode() != Quassel::Monolithic) {
             qWarning() << "Cannot connect to internal core in client-only mode!";
@@ -397,6 +455,8 @@ void CoreConnection::connectToCurrentAccount()
     }
 
     _authHandler = new ClientAuthHandler(currentAccount(), this);
+    if (_resuming)
+        _authHandler->setResumeInfo(_resumeToken, Client::signalProxy()->receivedSequence());
 
     connect(_authHandler, SIGNAL(disconnected()), SLOT(coreSocketDisconnected()));
     connect(_authHandler, SIGNAL(connectionReady()), SLOT(onConnectionReady()));
@@ -441,6 +501,7 @@ void CoreConnection::loginToCore(const QString &user, const QString &password, b
 void CoreConnection::onLoginSuccessful(const CoreAccount &account)
 {
     updateProgress(0, 0);
+    markLoginPhase("authentication");
 
     // save current account data
     accountModel()->createOrUpdateAccount(account);
@@ -457,6 +518,7 @@ void CoreConnection::onLoginSuccessful(const CoreAccount &account)
 void CoreConnection::onHandshakeComplete(RemotePeer *peer, const Protocol::SessionState &sessionState)
 {
     updateProgress(100, 100);
+    markLoginPhase("session state");
 
     disconnect(_authHandler, 0, this, 0);
     _authHandler->deleteLater();
@@ -469,6 +531,36 @@ void CoreConnection::onHandshakeComplete(RemotePeer *peer, const Protocol::Sessi
 
     Client::signalProxy()->addPeer(_peer);  // sigproxy takes ownership of the peer!
 
+    if (sessionState.resumed) {
+        if (!_resuming) {
+            // we gave up on the old session in the meantime, so start over
+            disconnectFromCore(tr("Could not resume the session"), true);
+            return;
+        }
+        _resuming = false;
+        _resumeTimer.stop();
+        markLoginPhase("resumed session", true);
+
+        // init data that was on its way when we lost the connection isn't part of the replay
+        Client::signalProxy()->requestPendingInitData();
+
+        setState(Synchronized);
+        setProgressText(tr("Synchronized to %1").arg(currentAccount().accountName()));
+        setProgressMaximum(-1);
+        emit synchronized();
+        return;
+    }
+
+    // the core doesn't know our session anymore (or we didn't ask), so throw away our old state.
+    // The core features of this login are already set, so this must not go through resumeAborted().
+    if (_resuming) {
+        _resuming = false;
+        _resumeTimer.stop();
+        emit sessionDiscarded();
+    }
+    _resumeToken = sessionState.resumeToken;
+    Client::signalProxy()->resetReceivedSequence();
+
     syncToCore(sessionState);
 }
 
@@ -478,6 +570,7 @@ void CoreConnection::internalSessionStateReceived(const Protocol::SessionState &
     updateProgress(100, 100);
 
     Client::setCoreFeatures(Quassel::features()); // mono connection...
+    markLoginPhase("session state");
 
     setState(Synchronizing);
     syncToCore(sessionState);
@@ -489,6 +582,9 @@ void CoreConnection::syncToCore(const Protocol::SessionState &sessionState)
     setProgressText(tr("Receiving network states"));
     updateProgress(0, 100);
 
+    // if the core sent the init data of our objects along, we don't need to ask for it
+    Client::signalProxy()->setInitDataSnapshot(sessionState.initDataSnapshot);
+
     // create identities
     foreach(const QVariant &vid, sessionState.identities) {
         Client::instance()->coreIdentityCreated(vid.value<Identity>());
@@ -536,6 +632,8 @@ void CoreConnection::networkInitDone()
 void CoreConnection::checkSyncState()
 {
     if (_netsToSync.isEmpty() && state() >= Synchronizing) {
+        if (state() == Synchronizing)
+            markLoginPhase("networks");
         setState(Synchronized);
         setProgressText(tr("Synchronized to %1").arg(currentAccount().accountName()));
         setProgressMaximum(-1);
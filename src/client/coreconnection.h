@@ -22,6 +22,7 @@
 #define CORECONNECTION_H_
 
 #include "QPointer"
+#include "QTime"
 #include "QTimer"
 
 #ifdef HAVE_SSL
@@ -77,6 +78,20 @@ public:
     //! Check if we consider the last connect as reconnect
     bool wasReconnect() const { return _wasReconnect; }
 
+    //! Check if we are trying to resume our session after losing the connection
+    /** While resuming, the client keeps its state around, and the core only sends what was missed.
+     *  If we give up, resumeAborted() is emitted. If the core starts a new session instead,
+     *  sessionDiscarded() is emitted and we synchronize from scratch.
+     */
+    bool isResuming() const { return _resuming; }
+
+    //! Marks the end of a phase of the login process
+    /** The durations of all phases are logged when the last phase is marked.
+     *  \param phase The name of the phase that just finished
+     *  \param last  true if this was the last phase of the login
+     */
+    void markLoginPhase(const QString &phase, bool last = false);
+
 public slots:
     bool connectToCore(AccountId = 0);
     void reconnectToCore();
@@ -94,6 +109,9 @@ signals:
     void connectionErrorPopup(const QString &errorMsg);
     void connectionMsg(const QString &msg);
     void disconnected();
+    void resumeAborted();
+    //! The core started a new session instead of resuming ours; the old session state is stale
+    void sessionDiscarded();
 
     void progressRangeChanged(int minimum, int maximum);
     void progressValueChanged(int value);
@@ -147,6 +165,7 @@ private slots:
     void pingTimeoutIntervalChanged(const QVariant &interval);
     void reconnectIntervalChanged(const QVariant &interval);
     void reconnectTimeout();
+    void abortResume();
 
 #ifdef HAVE_KDE
     void solidNetworkStatusChanged(Solid::Networking::Status status);
@@ -161,11 +180,20 @@ private:
     bool _wantReconnect;
     bool _wasReconnect;
 
+    QByteArray _resumeToken;
+    bool _resuming;
+    QTimer _resumeTimer;
+    static const int resumeTimeoutSecs = 300;
+
     QSet<QObject *> _netsToSync;
     int _numNetsToSync;
     int _progressMinimum, _progressMaximum, _progressValue;
     QString _progressText;
 
+    QTime _loginTimer;
+    int _loginPhaseStart;
+    QStringList _loginPhases;
+
     bool _resetting;
 
     CoreAccount _account;
@@ -97,3 +97,14 @@ void IrcListModel::setChannelList(const QList<IrcListHelper::ChannelDescription>
         endInsertRows();
     }
 }
+
+
+void IrcListModel::appendChannelList(const QList<IrcListHelper::ChannelDescription> &channelList)
+{
+    if (channelList.isEmpty())
+        return;
+
+    beginInsertRows(QModelIndex(), _channelList.count(), _channelList.count() + channelList.count() - 1);
+    _channelList << channelList;
+    endInsertRows();
+}
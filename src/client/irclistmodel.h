@@ -46,6 +46,7 @@ public:
 
 public slots:
     void setChannelList(const QList<IrcListHelper::ChannelDescription> &channelList = QList<IrcListHelper::ChannelDescription>());
+    void appendChannelList(const QList<IrcListHelper::ChannelDescription> &channelList);
 
 private:
     QList<IrcListHelper::ChannelDescription> _channelList;
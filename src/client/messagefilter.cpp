@@ -25,10 +25,10 @@
 #include "buffermodel.h"
 #include "messagemodel.h"
 #include "networkmodel.h"
-#include "clientignorelistmanager.h"
 
 MessageFilter::MessageFilter(QAbstractItemModel *source, QObject *parent)
     : QSortFilterProxyModel(parent),
+    _messageModel(qobject_cast<MessageModel *>(source)),
     _messageTypeFilter(0)
 {
     init();
@@ -38,6 +38,7 @@ MessageFilter::MessageFilter(QAbstractItemModel *source, QObject *parent)
 
 MessageFilter::MessageFilter(MessageModel *source, const QList<BufferId> &buffers, QObject *parent)
     : QSortFilterProxyModel(parent),
+    _messageModel(source),
     _validBuffers(buffers.toSet()),
     _messageTypeFilter(0)
 {
@@ -131,8 +132,9 @@ QString MessageFilter::idString() const
 bool MessageFilter::filterAcceptsRow(int sourceRow, const QModelIndex &sourceParent) const
 {
     Q_UNUSED(sourceParent);
-    QModelIndex sourceIdx = sourceModel()->index(sourceRow, 2);
-    Message::Type messageType = (Message::Type)sourceIdx.data(MessageModel::TypeRole).toInt();
+    Q_ASSERT(messageModel());
+    const MessageModel::MessageAttributes &attributes = messageModel()->messageAttributes(sourceRow);
+    Message::Type messageType = attributes.type;
 
     // apply message type filter
     if (_messageTypeFilter & messageType)
@@ -141,25 +143,23 @@ bool MessageFilter::filterAcceptsRow(int sourceRow, const QModelIndex &sourcePar
     if (_validBuffers.isEmpty())
         return true;
 
-    BufferId bufferId = sourceIdx.data(MessageModel::BufferIdRole).value<BufferId>();
+    BufferId bufferId = attributes.bufferId;
     if (!bufferId.isValid()) {
         return true;
     }
 
-    // MsgId msgId = sourceIdx.data(MessageModel::MsgIdRole).value<MsgId>();
-    Message::Flags flags = (Message::Flags)sourceIdx.data(MessageModel::FlagsRole).toInt();
+    Message::Flags flags = attributes.flags;
 
     NetworkId myNetworkId = networkId();
-    NetworkId msgNetworkId = Client::networkModel()->networkId(bufferId);
+    NetworkId msgNetworkId = attributes.networkId;
     if (myNetworkId != msgNetworkId)
         return false;
 
     // ignorelist handling
-    // only match if message is not flagged as server msg
-    if (!(flags & Message::ServerMsg) && Client::ignoreListManager()
-        && Client::ignoreListManager()->match(sourceIdx.data(MessageModel::MessageRole).value<Message>(), Client::networkModel()->networkName(bufferId)))
+    if (messageModel()->isIgnored(sourceRow))
         return false;
 
+    QModelIndex sourceIdx = sourceModel()->index(sourceRow, 2);
     if (flags & Message::Redirected) {
         int redirectionTarget = 0;
         switch (messageType) {
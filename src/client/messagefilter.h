@@ -58,9 +58,12 @@ protected:
     BufferInfo::Type bufferType() const { return Client::networkModel()->bufferType(singleBufferId()); }
     NetworkId networkId() const { return Client::networkModel()->networkId(singleBufferId()); }
 
+    inline MessageModel *messageModel() const { return _messageModel; }
+
 private:
     void init();
 
+    MessageModel *_messageModel;
     QSet<BufferId> _validBuffers;
     QMultiHash<QString, uint> _filteredQuitMsgs;
     int _messageTypeFilter;
@@ -24,6 +24,7 @@
 
 #include "backlogsettings.h"
 #include "clientbacklogmanager.h"
+#include "clientignorelistmanager.h"
 #include "client.h"
 #include "message.h"
 #include "networkmodel.h"
@@ -135,6 +136,7 @@ void MessageModel::insertMessageGroup(const QList<Message> &msglist)
             && messageItemAt(prevIdx)->timestamp() > msglist.at(0).timestamp()) {
             beginRemoveRows(QModelIndex(), prevIdx, prevIdx);
             Message oldDayChangeMsg = takeMessageAt(prevIdx);
+            _attributes.remove(prevIdx);
             if (msglist.last().timestamp() < oldDayChangeMsg.timestamp()) {
                 // we have to reinsert it with a changed msgId
                 dayChangeMsg = oldDayChangeMsg;
@@ -175,8 +177,13 @@ void MessageModel::insertMessageGroup(const QList<Message> &msglist)
     Q_ASSERT(start == messageCount() || messageItemAt(start)->msgId() > msglist.last().msgId());
     beginInsertRows(QModelIndex(), start, end);
     insertMessages__(start, msglist);
-    if (dayChangeMsg.isValid())
+    insertAttributes(start, msglist);
+    if (dayChangeMsg.isValid()) {
         insertMessage__(start + msglist.count(), dayChangeMsg);
+        insertAttributes(start + msglist.count(), QList<Message>() << dayChangeMsg);
+    }
+    // the filters will check every new row right away, so get the ignore list done in one go
+    updateIgnoreVerdicts(start, end);
     endInsertRows();
 
     Q_ASSERT(start == end || messageItemAt(start)->msgId() != messageItemAt(end)->msgId() || messageItemAt(end)->msgType() == Message::DayChange);
@@ -332,6 +339,7 @@ void MessageModel::clear()
     if (rowCount() > 0) {
         beginRemoveRows(QModelIndex(), 0, rowCount() - 1);
         removeAllMessages();
+        _attributes.clear();
         endRemoveRows();
     }
 }
@@ -370,6 +378,7 @@ void MessageModel::changeOfDay()
         Message dayChangeMsg = Message::ChangeOfDay(_nextDayChange);
         dayChangeMsg.setMsgId(messageItemAt(idx - 1)->msgId());
         insertMessage__(idx, dayChangeMsg);
+        insertAttributes(idx, QList<Message>() << dayChangeMsg);
         endInsertRows();
     }
     _nextDayChange = _nextDayChange.addSecs(86400);
@@ -386,6 +395,7 @@ void MessageModel::insertErrorMessage(BufferInfo bufferInfo, const QString &erro
     else
         msg.setMsgId(0);
     insertMessage__(idx, msg);
+    insertAttributes(idx, QList<Message>() << msg);
     endInsertRows();
 }
 
@@ -430,6 +440,7 @@ void MessageModel::buffersPermanentlyMerged(BufferId bufferId1, BufferId bufferI
     for (int i = 0; i < messageCount(); i++) {
         if (messageItemAt(i)->bufferId() == bufferId2) {
             messageItemAt(i)->setBufferId(bufferId1);
+            _attributes[i].bufferId = bufferId1;
             QModelIndex idx = index(i, 0);
             emit dataChanged(idx, idx);
         }
@@ -437,6 +448,74 @@ void MessageModel::buffersPermanentlyMerged(BufferId bufferId1, BufferId bufferI
 }
 
 
+void MessageModel::insertAttributes(int pos, const QList<Message> &msglist)
+{
+    // make room for all messages at once instead of shifting the tail for each of them
+    _attributes.insert(pos, msglist.count(), MessageAttributes());
+    for (int i = 0; i < msglist.count(); i++)
+        _attributes[pos + i] = MessageAttributes(msglist.at(i));
+}
+
+
+bool MessageModel::isIgnored(int row) const
+{
+    const MessageAttributes &attributes = _attributes.at(row);
+    if (attributes.ignored < 0) {
+        // only match if message is not flagged as server msg
+        if (attributes.flags & Message::ServerMsg)
+            attributes.ignored = 0;
+        else if (Client::ignoreListManager())
+            attributes.ignored = Client::ignoreListManager()->match(messageItemAt(row)->message(), Client::networkModel()->networkName(attributes.bufferId)) ? 1 : 0;
+        else
+            return false;
+    }
+    return attributes.ignored;
+}
+
+
+void MessageModel::updateIgnoreVerdicts(int first, int last)
+{
+    ClientIgnoreListManager *ignoreListManager = Client::ignoreListManager();
+    if (!ignoreListManager)
+        return;
+
+    QHash<BufferId, QString> networkNames;
+    for (int i = first; i <= last; i++) {
+        const MessageAttributes &attributes = _attributes.at(i);
+        if (attributes.ignored >= 0)
+            continue;
+        if (attributes.flags & Message::ServerMsg) {
+            attributes.ignored = 0;
+            continue;
+        }
+        if (!networkNames.contains(attributes.bufferId))
+            networkNames[attributes.bufferId] = Client::networkModel()->networkName(attributes.bufferId);
+        attributes.ignored = ignoreListManager->match(messageItemAt(i)->message(), networkNames[attributes.bufferId]) ? 1 : 0;
+    }
+}
+
+
+void MessageModel::invalidateIgnoreVerdicts()
+{
+    for (int i = 0; i < _attributes.count(); i++)
+        _attributes[i].ignored = -1;
+}
+
+
+// ========================================
+//  MessageAttributes
+// ========================================
+MessageModel::MessageAttributes::MessageAttributes(const Message &msg)
+    : msgId(msg.msgId()),
+    bufferId(msg.bufferInfo().bufferId()),
+    networkId(msg.bufferInfo().networkId()),
+    type(msg.type()),
+    flags(msg.flags()),
+    ignored(-1)
+{
+}
+
+
 // ========================================
 //  MessageModelItem
 // ========================================
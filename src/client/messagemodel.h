@@ -24,6 +24,7 @@
 #include <QAbstractItemModel>
 #include <QDateTime>
 #include <QTimer>
+#include <QVector>
 
 #include "message.h"
 #include "types.h"
@@ -56,6 +57,22 @@ public:
         TimestampColumn, SenderColumn, ContentsColumn, UserColumnType
     };
 
+    //! Attributes of a message that filters need for every row, stored contiguously
+    /** Filters read these directly instead of going through data(), which would wrap every
+     *  value (or even a copy of the whole Message) in a QVariant.
+     */
+    struct MessageAttributes {
+        MsgId msgId;
+        BufferId bufferId;
+        NetworkId networkId;
+        Message::Type type;
+        Message::Flags flags;
+        mutable qint8 ignored; // cached ignore list verdict; -1 if not yet known
+
+        MessageAttributes() : type(Message::Plain), flags(Message::None), ignored(-1) {}
+        MessageAttributes(const Message &msg);
+    };
+
     MessageModel(QObject *parent);
 
     inline QModelIndex index(int row, int column, const QModelIndex &parent = QModelIndex()) const;
@@ -73,6 +90,11 @@ public:
 
     void clear();
 
+    inline const MessageAttributes &messageAttributes(int row) const { return _attributes.at(row); }
+
+    //! Returns whether the message in the given row matches the ignore list, caching the verdict
+    bool isIgnored(int row) const;
+
 signals:
     void finishedBacklogFetch(BufferId bufferId);
 
@@ -81,6 +103,7 @@ public slots:
     void messagesReceived(BufferId bufferId, int count);
     void buffersPermanentlyMerged(BufferId bufferId1, BufferId bufferId2);
     void insertErrorMessage(BufferInfo bufferInfo, const QString &errorString);
+    void invalidateIgnoreVerdicts();
 
 protected:
 //   virtual MessageModelItem *createMessageModelItem(const Message &) = 0;
@@ -108,12 +131,15 @@ private:
     void insertMessageGroup(const QList<Message> &);
     int insertMessagesGracefully(const QList<Message> &); // inserts as many contiguous msgs as possible. returns numer of inserted msgs.
     int indexForId(MsgId);
+    void insertAttributes(int pos, const QList<Message> &);
+    void updateIgnoreVerdicts(int first, int last);
 
     //  QList<MessageModelItem *> _messageList;
     QList<Message> _messageBuffer;
     QTimer _dayChangeTimer;
     QDateTime _nextDayChange;
     QHash<BufferId, int> _messagesWaiting;
+    QVector<MessageAttributes> _attributes;
 };
 
 
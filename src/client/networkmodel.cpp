@@ -321,6 +321,21 @@ void BufferItem::updateActivityLevel(const Message &msg)
 }
 
 
+void BufferItem::updateActivityLevel(int unreadCount, int highlightCount)
+{
+    if (isCurrentBuffer())
+        return;
+
+    // counts dropping to zero come along with a new last seen message, which clears the activity anyway
+    BufferInfo::ActivityLevel level = _activity;
+    if (unreadCount > 0)
+        level |= BufferInfo::OtherActivity | BufferInfo::NewMessage;
+    if (highlightCount > 0)
+        level |= BufferInfo::Highlight;
+    setActivityLevel(level);
+}
+
+
 QVariant BufferItem::data(int column, int role) const
 {
     switch (role) {
@@ -1306,6 +1321,17 @@ void NetworkModel::setBufferActivity(const BufferId &bufferId, BufferInfo::Activ
 }
 
 
+void NetworkModel::setBufferActivityCount(BufferId bufferId, int unreadCount, int highlightCount)
+{
+    BufferItem *bufferItem = findBufferItem(bufferId);
+    if (!bufferItem) {
+        qDebug() << "NetworkModel::setBufferActivityCount(): buffer is unknown:" << bufferId;
+        return;
+    }
+    bufferItem->updateActivityLevel(unreadCount, highlightCount);
+}
+
+
 void NetworkModel::clearBufferActivity(const BufferId &bufferId)
 {
     BufferItem *bufferItem = findBufferItem(bufferId);
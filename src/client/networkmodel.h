@@ -118,6 +118,8 @@ public :
     void setActivityLevel(BufferInfo::ActivityLevel level);
     void clearActivityLevel();
     void updateActivityLevel(const Message &msg);
+    //! Raises the activity level according to the unread counts maintained by the core
+    void updateActivityLevel(int unreadCount, int highlightCount);
 
     inline const MsgId &firstUnreadMsgId() const { return _firstUnreadMsgId; }
 
@@ -354,6 +356,7 @@ public slots:
     void setBufferActivity(const BufferId &bufferId, BufferInfo::ActivityLevel activity);
     void clearBufferActivity(const BufferId &bufferId);
     void updateBufferActivity(Message &msg);
+    void setBufferActivityCount(BufferId bufferId, int unreadCount, int highlightCount);
     void networkRemoved(const NetworkId &networkId);
 
 signals:
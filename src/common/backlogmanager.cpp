@@ -33,3 +33,31 @@ QVariantList BacklogManager::requestBacklogAll(MsgId first, MsgId last, int limi
     REQUEST(ARG(first), ARG(last), ARG(limit), ARG(additional))
     return QVariantList();
 }
+
+
+QVariantList BacklogManager::requestBacklogMulti(const QVariantList &requests)
+{
+    REQUEST(ARG(requests))
+    return QVariantList();
+}
+
+
+QVariantList BacklogManager::requestBacklogHighlights(MsgId first, int limit)
+{
+    REQUEST(ARG(first), ARG(limit))
+    return QVariantList();
+}
+
+
+QVariantList BacklogManager::requestBacklogByTime(BufferId bufferId, const QDateTime &time, MsgId first, MsgId last, int before, int after)
+{
+    REQUEST(ARG(bufferId), ARG(time), ARG(first), ARG(last), ARG(before), ARG(after))
+    return QVariantList();
+}
+
+
+QVariantList BacklogManager::requestBacklogBySender(BufferId bufferId, const QString &nick, MsgId last, int limit)
+{
+    REQUEST(ARG(bufferId), ARG(nick), ARG(last), ARG(limit))
+    return QVariantList();
+}
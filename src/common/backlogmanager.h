@@ -21,6 +21,8 @@
 #ifndef BACKLOGMANAGER_H
 #define BACKLOGMANAGER_H
 
+#include <QDateTime>
+
 #include "syncableobject.h"
 #include "types.h"
 
@@ -40,9 +42,51 @@ public slots:
     virtual QVariantList requestBacklogAll(MsgId first = -1, MsgId last = -1, int limit = -1, int additional = 0);
     inline virtual void receiveBacklogAll(MsgId, MsgId, int, int, QVariantList) {};
 
+    //! Request backlog for several buffers in a single round trip
+    /** Requires Quassel::BacklogRequestMulti on the core.
+     *  \param requests A list of (BufferId, first, last, limit, additional) lists, with the same
+     *                  semantics as the parameters of requestBacklog()
+     *  \return The messages of all requested buffers
+     */
+    virtual QVariantList requestBacklogMulti(const QVariantList &requests);
+    inline virtual void receiveBacklogMulti(QVariantList, QVariantList) {};
+
+    //! Request the most recent highlights across all buffers
+    /** Requires Quassel::CoreSideHighlights on the core.
+     *  \param first if != -1 return only messages with a MsgId >= first
+     *  \param limit Max amount of messages
+     */
+    virtual QVariantList requestBacklogHighlights(MsgId first = -1, int limit = -1);
+    inline virtual void receiveBacklogHighlights(MsgId, int, QVariantList) {};
+
+    //! Request backlog of a buffer around a point in time
+    /** Requires Quassel::BacklogByTime on the core.
+     *  The backlog is split at the first message at or after \p time, both parts are paged by MsgId.
+     *  \param time   The point in time
+     *  \param first  if != -1 split at this MsgId instead, to continue a previous request
+     *  \param last   if != -1 return only messages with a MsgId < last
+     *  \param before Max amount of messages before the split
+     *  \param after  Max amount of messages from the split on, -1 for all of them
+     */
+    virtual QVariantList requestBacklogByTime(BufferId bufferId, const QDateTime &time, MsgId first = -1, MsgId last = -1, int before = 0, int after = -1);
+    inline virtual void receiveBacklogByTime(BufferId, QDateTime, MsgId, MsgId, int, int, QVariantList) {};
+
+    //! Request the messages sent by a nick
+    /** Requires Quassel::BacklogBySender on the core.
+     *  \param bufferId if valid return only messages of this buffer, otherwise of all buffers
+     *  \param nick     The nick, compared case insensitively
+     *  \param last     if != -1 return only messages with a MsgId < last
+     *  \param limit    Max amount of messages
+     */
+    virtual QVariantList requestBacklogBySender(BufferId bufferId, const QString &nick, MsgId last = -1, int limit = -1);
+    inline virtual void receiveBacklogBySender(BufferId, QString, MsgId, int, QVariantList) {};
+
 signals:
     void backlogRequested(BufferId, MsgId, MsgId, int, int);
     void backlogAllRequested(MsgId, MsgId, int, int);
+    void backlogMultiRequested(QVariantList);
+    void backlogByTimeRequested(BufferId, QDateTime, MsgId, MsgId, int, int);
+    void backlogBySenderRequested(BufferId, QString, MsgId, int);
 };
 
 
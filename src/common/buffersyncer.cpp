@@ -78,6 +78,36 @@ bool BufferSyncer::setMarkerLine(BufferId buffer, const MsgId &msgId)
 }
 
 
+int BufferSyncer::unreadCount(BufferId buffer) const
+{
+    return _activityCounts.value(buffer).first;
+}
+
+
+int BufferSyncer::highlightCount(BufferId buffer) const
+{
+    return _activityCounts.value(buffer).second;
+}
+
+
+void BufferSyncer::setActivityCount(BufferId buffer, int unreadCount, int highlightCount)
+{
+    if (unreadCount <= 0 && highlightCount <= 0) {
+        if (!_activityCounts.contains(buffer))
+            return;
+        _activityCounts.remove(buffer);
+    }
+    else {
+        ActivityCount count(unreadCount, highlightCount);
+        if (_activityCounts.value(buffer) == count)
+            return;
+        _activityCounts[buffer] = count;
+    }
+    SYNC(ARG(buffer), ARG(unreadCount), ARG(highlightCount))
+    emit activityCountSet(buffer, unreadCount, highlightCount);
+}
+
+
 QVariantList BufferSyncer::initLastSeenMsg() const
 {
     QVariantList list;
@@ -124,12 +154,37 @@ void BufferSyncer::initSetMarkerLines(const QVariantList &list)
 }
 
 
+QVariantList BufferSyncer::initActivityCounts() const
+{
+    QVariantList list;
+    QHash<BufferId, ActivityCount>::const_iterator iter = _activityCounts.constBegin();
+    while (iter != _activityCounts.constEnd()) {
+        list << QVariant::fromValue<BufferId>(iter.key())
+             << iter.value().first
+             << iter.value().second;
+        ++iter;
+    }
+    return list;
+}
+
+
+void BufferSyncer::initSetActivityCounts(const QVariantList &list)
+{
+    _activityCounts.clear();
+    Q_ASSERT(list.count() % 3 == 0);
+    for (int i = 0; i + 2 < list.count(); i += 3) {
+        setActivityCount(list.at(i).value<BufferId>(), list.at(i+1).toInt(), list.at(i+2).toInt());
+    }
+}
+
+
 void BufferSyncer::removeBuffer(BufferId buffer)
 {
     if (_lastSeenMsg.contains(buffer))
         _lastSeenMsg.remove(buffer);
     if (_markerLines.contains(buffer))
         _markerLines.remove(buffer);
+    _activityCounts.remove(buffer);
     SYNC(ARG(buffer))
     emit bufferRemoved(buffer);
 }
@@ -141,6 +196,7 @@ void BufferSyncer::mergeBuffersPermanently(BufferId buffer1, BufferId buffer2)
         _lastSeenMsg.remove(buffer2);
     if (_markerLines.contains(buffer2))
         _markerLines.remove(buffer2);
+    _activityCounts.remove(buffer2);
     SYNC(ARG(buffer1), ARG(buffer2))
     emit buffersPermanentlyMerged(buffer1, buffer2);
 }
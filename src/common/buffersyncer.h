@@ -38,6 +38,12 @@ public:
     MsgId lastSeenMsg(BufferId buffer) const;
     MsgId markerLine(BufferId buffer) const;
 
+    //! The number of unread messages in a buffer, as counted by the core
+    /** Only available if the core supports Quassel::BufferActivityCounts.
+     */
+    int unreadCount(BufferId buffer) const;
+    int highlightCount(BufferId buffer) const;
+
 public slots:
     QVariantList initLastSeenMsg() const;
     void initSetLastSeenMsg(const QVariantList &);
@@ -45,6 +51,11 @@ public slots:
     QVariantList initMarkerLines() const;
     void initSetMarkerLines(const QVariantList &);
 
+    QVariantList initActivityCounts() const;
+    void initSetActivityCounts(const QVariantList &);
+
+    virtual void setActivityCount(BufferId buffer, int unreadCount, int highlightCount);
+
     virtual inline void requestSetLastSeenMsg(BufferId buffer, const MsgId &msgId) { REQUEST(ARG(buffer), ARG(msgId)) }
     virtual inline void requestSetMarkerLine(BufferId buffer, const MsgId &msgId) { REQUEST(ARG(buffer), ARG(msgId)) setMarkerLine(buffer, msgId); }
 
@@ -69,6 +80,7 @@ signals:
     void bufferRenamed(BufferId buffer, QString newName);
     void buffersPermanentlyMerged(BufferId buffer1, BufferId buffer2);
     void bufferMarkedAsRead(BufferId buffer);
+    void activityCountSet(BufferId buffer, int unreadCount, int highlightCount);
 
 protected slots:
     bool setLastSeenMsg(BufferId buffer, const MsgId &msgId);
@@ -82,6 +94,10 @@ protected:
 private:
     QHash<BufferId, MsgId> _lastSeenMsg;
     QHash<BufferId, MsgId> _markerLines;
+
+    // buffers without unread messages have no entry
+    typedef QPair<int, int> ActivityCount; // unread messages, highlights
+    QHash<BufferId, ActivityCount> _activityCounts;
 };
 
 
@@ -160,11 +160,17 @@ QVariantList BufferViewConfig::initBufferList() const
 void BufferViewConfig::initSetBufferList(const QVariantList &buffers)
 {
     _buffers.clear();
+    _bufferIndex.clear();
 
     foreach(QVariant buffer, buffers) {
-        _buffers << buffer.value<BufferId>();
+        BufferId bufferId = buffer.value<BufferId>();
+        if (_bufferIndex.contains(bufferId))
+            continue;
+        _bufferIndex[bufferId] = _buffers.count();
+        _buffers << bufferId;
     }
 
+    emit bufferListSet();
     emit configChanged(); // used to track changes in the settingspage
 }
 
@@ -172,11 +178,16 @@ void BufferViewConfig::initSetBufferList(const QVariantList &buffers)
 void BufferViewConfig::initSetBufferList(const QList<BufferId> &buffers)
 {
     _buffers.clear();
+    _bufferIndex.clear();
 
     foreach(BufferId bufferId, buffers) {
+        if (_bufferIndex.contains(bufferId))
+            continue;
+        _bufferIndex[bufferId] = _buffers.count();
         _buffers << bufferId;
     }
 
+    emit bufferListSet();
     emit configChanged(); // used to track changes in the settingspage
 }
 
@@ -225,9 +236,16 @@ void BufferViewConfig::initSetTemporarilyRemovedBuffers(const QVariantList &buff
 }
 
 
+void BufferViewConfig::indexBuffers(int first, int last)
+{
+    for (int i = first; i <= last; i++)
+        _bufferIndex[_buffers.at(i)] = i;
+}
+
+
 void BufferViewConfig::addBuffer(const BufferId &bufferId, int pos)
 {
-    if (_buffers.contains(bufferId))
+    if (_bufferIndex.contains(bufferId))
         return;
 
     if (pos < 0)
@@ -242,6 +260,7 @@ void BufferViewConfig::addBuffer(const BufferId &bufferId, int pos)
         _temporarilyRemovedBuffers.remove(bufferId);
 
     _buffers.insert(pos, bufferId);
+    indexBuffers(pos, _buffers.count() - 1);
     SYNC(ARG(bufferId), ARG(pos))
     emit bufferAdded(bufferId, pos);
     emit configChanged();
@@ -250,7 +269,8 @@ void BufferViewConfig::addBuffer(const BufferId &bufferId, int pos)
 
 void BufferViewConfig::moveBuffer(const BufferId &bufferId, int pos)
 {
-    if (!_buffers.contains(bufferId))
+    int from = bufferIndex(bufferId);
+    if (from == -1)
         return;
 
     if (pos < 0)
@@ -258,7 +278,8 @@ void BufferViewConfig::moveBuffer(const BufferId &bufferId, int pos)
     if (pos >= _buffers.count())
         pos = _buffers.count() - 1;
 
-    _buffers.move(_buffers.indexOf(bufferId), pos);
+    _buffers.move(from, pos);
+    indexBuffers(qMin(from, pos), qMax(from, pos));
     SYNC(ARG(bufferId), ARG(pos))
     emit bufferMoved(bufferId, pos);
     emit configChanged();
@@ -267,8 +288,12 @@ void BufferViewConfig::moveBuffer(const BufferId &bufferId, int pos)
 
 void BufferViewConfig::removeBuffer(const BufferId &bufferId)
 {
-    if (_buffers.contains(bufferId))
-        _buffers.removeAt(_buffers.indexOf(bufferId));
+    int index = bufferIndex(bufferId);
+    if (index != -1) {
+        _bufferIndex.remove(bufferId);
+        _buffers.removeAt(index);
+        indexBuffers(index, _buffers.count() - 1);
+    }
 
     if (_removedBuffers.contains(bufferId))
         _removedBuffers.remove(bufferId);
@@ -282,8 +307,12 @@ void BufferViewConfig::removeBuffer(const BufferId &bufferId)
 
 void BufferViewConfig::removeBufferPermanently(const BufferId &bufferId)
 {
-    if (_buffers.contains(bufferId))
-        _buffers.removeAt(_buffers.indexOf(bufferId));
+    int index = bufferIndex(bufferId);
+    if (index != -1) {
+        _bufferIndex.remove(bufferId);
+        _buffers.removeAt(index);
+        indexBuffers(index, _buffers.count() - 1);
+    }
 
     if (_temporarilyRemovedBuffers.contains(bufferId))
         _temporarilyRemovedBuffers.remove(bufferId);
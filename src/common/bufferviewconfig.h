@@ -46,6 +46,10 @@ public :
 
     inline virtual const QMetaObject *syncMetaObject() const { return &staticMetaObject; }
 
+    //! The position of a buffer in bufferList(), or -1 if it isn't part of this view
+    inline int bufferIndex(const BufferId &bufferId) const { return _bufferIndex.value(bufferId, -1); }
+    inline bool containsBuffer(const BufferId &bufferId) const { return _bufferIndex.contains(bufferId); }
+
 public slots:
     inline int bufferViewId() const { return _bufferViewId; }
 
@@ -125,6 +129,9 @@ signals:
 //   void setBufferViewNameRequested(const QString &bufferViewName);
 
 private:
+    // updates _bufferIndex for the positions from first to last (inclusive) of _buffers
+    void indexBuffers(int first, int last);
+
     int _bufferViewId;
     QString _bufferViewName;
     NetworkId _networkId;
@@ -136,6 +143,7 @@ private:
     int _allowedBufferTypes;
     int _minimumActivity;
     QList<BufferId> _buffers;
+    QHash<BufferId, int> _bufferIndex; // position of every buffer in _buffers
     QSet<BufferId> _removedBuffers;
     QSet<BufferId> _temporarilyRemovedBuffers;
 };
@@ -26,6 +26,7 @@
 
 #include "event.h"
 #include "ircevent.h"
+#include "metrics.h"
 
 // ============================================================
 //  QueuedEvent
@@ -219,8 +220,11 @@ void EventManager::postEvent(Event *event)
         if (_eventQueue.isEmpty())
             // we're currently not processing events
             processEvent(event);
-        else
+        else {
             _eventQueue.append(event);
+            if (Metrics::isEnabled())
+                Metrics::setGauge("quassel_event_queue_length", metricsLabels(), _eventQueue.count());
+        }
     }
 }
 
@@ -244,6 +248,8 @@ void EventManager::processEvent(Event *event)
         dispatchEvent(_eventQueue.first());
         _eventQueue.removeFirst();
     }
+    if (Metrics::isEnabled())
+        Metrics::setGauge("quassel_event_queue_length", metricsLabels(), 0);
 }
 
 
@@ -251,6 +257,8 @@ void EventManager::dispatchEvent(Event *event)
 {
     //qDebug() << "Dispatching" << event;
 
+    Metrics::Timer dispatchTimer;
+
     // we try handlers from specialized to generic by masking the enum
 
     // build a list sorted by priorities that contains all eligible handlers
@@ -306,10 +314,16 @@ void EventManager::dispatchEvent(Event *event)
         }
 
         // finally, deliverance!
+        Metrics::Timer handlerTimer;
         void *param[] = { 0, Q_ARG(Event *, event).data() };
         obj->qt_metacall(QMetaObject::InvokeMetaMethod, it->methodIndex, param);
+        if (Metrics::isEnabled())
+            Metrics::observe("quassel_event_handler_seconds", Metrics::labels("handler", obj->metaObject()->className()), handlerTimer.elapsed());
     }
 
+    if (Metrics::isEnabled())
+        Metrics::observe("quassel_event_dispatch_seconds", Metrics::labels("type", enumName(type)), dispatchTimer.elapsed());
+
     // that's it
     delete event;
 }
@@ -148,6 +148,8 @@ public slots:
 protected:
     virtual Network *networkById(NetworkId id) const = 0;
     virtual void customEvent(QEvent *event);
+    //! Labels identifying this instance in recorded metrics
+    inline virtual QString metricsLabels() const { return QString(); }
 
 private:
     struct Handler {
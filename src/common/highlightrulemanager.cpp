@@ -0,0 +1,166 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "highlightrulemanager.h"
+
+#include <QDebug>
+
+INIT_SYNCABLE_OBJECT(HighlightRuleManager)
+
+HighlightRuleManager::HighlightRule::HighlightRule(const QString &name_, bool isRegEx_, bool isCaseSensitive_, bool isEnabled_, const QString &chanName_)
+    : name(name_),
+    isRegEx(isRegEx_),
+    isCaseSensitive(isCaseSensitive_),
+    isEnabled(isEnabled_),
+    chanName(chanName_),
+    chanInverted(false)
+{
+    Qt::CaseSensitivity cs = isCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive;
+    if (isRegEx)
+        regEx = QRegExp(name, cs);
+    else
+        regEx = QRegExp("(^|\\W)" + QRegExp::escape(name) + "(\\W|$)", cs);
+
+    // an empty channel or ".*" applies everywhere, a leading "!" excludes the matching channels
+    if (!chanName.isEmpty() && chanName != ".*") {
+        chanInverted = chanName.startsWith('!');
+        chanRegEx = QRegExp(chanInverted ? chanName.mid(1) : chanName, Qt::CaseInsensitive);
+    }
+}
+
+
+QVariantMap HighlightRuleManager::initHighlightRuleList() const
+{
+    QVariantMap highlightRuleListMap;
+    QStringList nameList;
+    QVariantList isRegExList;
+    QVariantList isCaseSensitiveList;
+    QVariantList isEnabledList;
+    QStringList chanNameList;
+
+    for (int i = 0; i < _highlightRuleList.count(); i++) {
+        nameList << _highlightRuleList[i].name;
+        isRegExList << _highlightRuleList[i].isRegEx;
+        isCaseSensitiveList << _highlightRuleList[i].isCaseSensitive;
+        isEnabledList << _highlightRuleList[i].isEnabled;
+        chanNameList << _highlightRuleList[i].chanName;
+    }
+
+    highlightRuleListMap["name"] = nameList;
+    highlightRuleListMap["isRegEx"] = isRegExList;
+    highlightRuleListMap["isCaseSensitive"] = isCaseSensitiveList;
+    highlightRuleListMap["isEnabled"] = isEnabledList;
+    highlightRuleListMap["chanName"] = chanNameList;
+    return highlightRuleListMap;
+}
+
+
+void HighlightRuleManager::initSetHighlightRuleList(const QVariantMap &highlightRuleList)
+{
+    QStringList name = highlightRuleList["name"].toStringList();
+    QVariantList isRegEx = highlightRuleList["isRegEx"].toList();
+    QVariantList isCaseSensitive = highlightRuleList["isCaseSensitive"].toList();
+    QVariantList isEnabled = highlightRuleList["isEnabled"].toList();
+    QStringList chanName = highlightRuleList["chanName"].toStringList();
+
+    int count = name.count();
+    if (count != isRegEx.count() || count != isCaseSensitive.count() ||
+        count != isEnabled.count() || count != chanName.count()) {
+        qWarning() << "Corrupted HighlightRuleList settings! (Count missmatch)";
+        return;
+    }
+
+    _highlightRuleList.clear();
+    for (int i = 0; i < name.count(); i++) {
+        _highlightRuleList << HighlightRule(name[i], isRegEx[i].toBool(), isCaseSensitive[i].toBool(), isEnabled[i].toBool(), chanName[i]);
+    }
+}
+
+
+void HighlightRuleManager::setHighlightNick(int highlightNick)
+{
+    _highlightNick = highlightNick;
+    SYNC(ARG(highlightNick))
+}
+
+
+void HighlightRuleManager::setNicksCaseSensitive(bool nicksCaseSensitive)
+{
+    if (_nicksCaseSensitive != nicksCaseSensitive)
+        _nickRegExps.clear();
+    _nicksCaseSensitive = nicksCaseSensitive;
+    SYNC(ARG(nicksCaseSensitive))
+}
+
+
+QRegExp HighlightRuleManager::nickRegExp(const QStringList &nicks)
+{
+    QString key = nicks.join("\n");
+    QHash<QString, QRegExp>::const_iterator it = _nickRegExps.constFind(key);
+    if (it != _nickRegExps.constEnd())
+        return it.value();
+
+    // one alternation instead of a regexp per nick
+    QStringList escaped;
+    foreach(const QString &nick, nicks) {
+        if (!nick.isEmpty())
+            escaped << QRegExp::escape(nick);
+    }
+    QRegExp rx("(^|\\W)(" + escaped.join("|") + ")(\\W|$)", _nicksCaseSensitive ? Qt::CaseSensitive : Qt::CaseInsensitive);
+
+    if (_nickRegExps.count() >= maxNickRegExps)
+        _nickRegExps.clear();
+    _nickRegExps[key] = rx;
+    return rx;
+}
+
+
+bool HighlightRuleManager::match(const Message &msg, const QStringList &nicks)
+{
+    if (!((msg.type() & (Message::Plain | Message::Notice | Message::Action)) && !(msg.flags() & Message::Self)))
+        return false;
+
+    // like the client, we can't tell highlights until we know our nick
+    if (nicks.isEmpty() || nicks.first().isEmpty())
+        return false;
+
+    if (_highlightNick != NoNick) {
+        QStringList nickList;
+        if (_highlightNick == CurrentNick)
+            nickList << nicks.first();
+        else
+            nickList = nicks;
+        if (nickRegExp(nickList).indexIn(msg.contents()) >= 0)
+            return true;
+    }
+
+    for (int i = 0; i < _highlightRuleList.count(); i++) {
+        HighlightRule &rule = _highlightRuleList[i];
+        if (!rule.isEnabled)
+            continue;
+
+        if (!rule.chanRegEx.isEmpty() && rule.chanRegEx.exactMatch(msg.bufferInfo().bufferName()) == rule.chanInverted)
+            continue;
+
+        if (rule.regEx.indexIn(msg.contents()) >= 0)
+            return true;
+    }
+    return false;
+}
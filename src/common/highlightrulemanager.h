@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef HIGHLIGHTRULEMANAGER_H
+#define HIGHLIGHTRULEMANAGER_H
+
+#include <QHash>
+#include <QRegExp>
+#include <QStringList>
+
+#include "message.h"
+#include "syncableobject.h"
+
+//! The user's highlight rules, so the core can flag highlights when it stores a message
+/** The rules mirror the client's highlight settings; the client pushes them with requestUpdate().
+ */
+class HighlightRuleManager : public SyncableObject
+{
+    SYNCABLE_OBJECT
+        Q_OBJECT
+
+    Q_PROPERTY(int highlightNick READ highlightNick WRITE setHighlightNick)
+    Q_PROPERTY(bool nicksCaseSensitive READ nicksCaseSensitive WRITE setNicksCaseSensitive)
+
+public:
+    enum HighlightNickType {
+        NoNick = 0x00,
+        CurrentNick = 0x01,
+        AllNicks = 0x02
+    };
+
+    struct HighlightRule {
+        QString name;
+        bool isRegEx;
+        bool isCaseSensitive;
+        bool isEnabled;
+        QString chanName;
+        QRegExp regEx;
+        QRegExp chanRegEx;
+        bool chanInverted;
+        HighlightRule() {}
+        HighlightRule(const QString &name_, bool isRegEx_, bool isCaseSensitive_, bool isEnabled_, const QString &chanName_);
+    };
+    typedef QList<HighlightRule> HighlightRuleList;
+
+    inline HighlightRuleManager(QObject *parent = 0) : SyncableObject(parent), _highlightNick(CurrentNick), _nicksCaseSensitive(false) { setAllowClientUpdates(true); }
+
+    inline const HighlightRuleList &highlightRuleList() const { return _highlightRuleList; }
+    inline int highlightNick() const { return _highlightNick; }
+    inline bool nicksCaseSensitive() const { return _nicksCaseSensitive; }
+
+    //! Check if a message is a highlight
+    /** Only messages of type Plain, Notice and Action that weren't sent by ourselves can be highlights.
+     *  \param msg The message to check
+     *  \param nicks Our nicks on the message's network, the current one first
+     *  \return true if our nick or one of the rules matches the message contents
+     */
+    bool match(const Message &msg, const QStringList &nicks);
+
+public slots:
+    virtual QVariantMap initHighlightRuleList() const;
+    virtual void initSetHighlightRuleList(const QVariantMap &highlightRuleList);
+
+    void setHighlightNick(int highlightNick);
+    void setNicksCaseSensitive(bool nicksCaseSensitive);
+
+private:
+    QRegExp nickRegExp(const QStringList &nicks);
+
+    HighlightRuleList _highlightRuleList;
+    int _highlightNick;
+    bool _nicksCaseSensitive;
+
+    // compiled matchers for the nick lists we've seen, by nicks joined with newlines
+    QHash<QString, QRegExp> _nickRegExps;
+    static const int maxNickRegExps = 64;
+};
+
+
+#endif // HIGHLIGHTRULEMANAGER_H
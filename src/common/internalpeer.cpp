@@ -42,7 +42,8 @@ InternalPeer::InternalPeer(QObject *parent)
     _peer(0),
     _isOpen(true)
 {
-
+    // both ends of an internal connection are the same build
+    setFeatures(Quassel::features());
 }
 
 
@@ -50,6 +50,40 @@ IrcChannel::~IrcChannel()
 }
 
 
+QString IrcChannel::initColumnName(int column)
+{
+    static const char *const names[InitColumnCount] = {
+        "name", "topic", "password", "encrypted", "ChanModes", "UserModes"
+    };
+    Q_ASSERT(column >= 0 && column < InitColumnCount);
+    return QString::fromLatin1(names[column]);
+}
+
+
+void IrcChannel::appendInitColumns(QVector<QVariantList> &columns) const
+{
+    Q_ASSERT(columns.count() == InitColumnCount);
+    columns[NameColumn] << _name;
+    columns[TopicColumn] << _topic;
+    columns[PasswordColumn] << _password;
+    columns[EncryptedColumn] << _encrypted;
+    columns[ChanModesColumn] << initChanModes();
+    columns[UserModesColumn] << initUserModes();
+}
+
+
+void IrcChannel::initSetColumns(const QVector<QVariantList> &columns, int row)
+{
+    Q_ASSERT(columns.count() == InitColumnCount);
+    // the name was already set by the constructor
+    _topic = columns[TopicColumn].at(row).toString();
+    _password = columns[PasswordColumn].at(row).toString();
+    _encrypted = columns[EncryptedColumn].at(row).toBool();
+    initSetChanModes(columns[ChanModesColumn].at(row).toMap());
+    initSetUserModes(columns[UserModesColumn].at(row).toMap());
+}
+
+
 // ====================
 //  PUBLIC:
 // ====================
@@ -254,6 +288,58 @@ void IrcChannel::part(const QString &nick)
 }
 
 
+// Requires Quassel::BatchedChannelParts on all clients, the parts are synced as a single call
+void IrcChannel::partIrcUsers(const QList<IrcUser *> &users)
+{
+    QStringList nicks;
+    QList<IrcUser *> partedUsers;
+    foreach(IrcUser *ircuser, users) {
+        // users that left in the meantime are expected here, so don't warn about them
+        if (!ircuser || !_userModes.contains(ircuser))
+            continue;
+
+        _userModes.remove(ircuser);
+        disconnect(ircuser, 0, this, 0);
+        nicks << ircuser->nick();
+        partedUsers << ircuser;
+    }
+
+    if (nicks.isEmpty())
+        return;
+
+    // sync before the users are gone, as the other side looks them up by nick
+    SYNC_OTHER(partIrcUsers, ARG(nicks));
+
+    bool meParted = false;
+    foreach(IrcUser *ircuser, partedUsers) {
+        if (network()->isMe(ircuser))
+            meParted = true;
+        ircuser->leaveChannel(this);
+        emit ircUserParted(ircuser);
+    }
+
+    if (meParted || _userModes.isEmpty()) {
+        QList<IrcUser *> remainingUsers = _userModes.keys();
+        _userModes.clear();
+        foreach(IrcUser *user, remainingUsers) {
+            disconnect(user, 0, this, 0);
+            user->leaveChannel(this);
+        }
+        emit parted();
+        network()->removeIrcChannel(this);
+    }
+}
+
+
+void IrcChannel::partIrcUsers(const QStringList &nicks)
+{
+    QList<IrcUser *> users;
+    foreach(QString nick, nicks)
+    users << network()->ircUser(nick);
+    partIrcUsers(users);
+}
+
+
 // SET USER MODE
 void IrcChannel::setUserModes(IrcUser *ircuser, const QString &modes)
 {
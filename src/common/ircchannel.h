@@ -26,6 +26,7 @@
 #include <QString>
 #include <QStringList>
 #include <QVariantMap>
+#include <QVector>
 
 #include "syncableobject.h"
 
@@ -43,9 +44,29 @@ class IrcChannel : public SyncableObject
     Q_PROPERTY(bool encrypted READ encrypted WRITE setEncrypted)
 
 public :
+    //! Columns of the channels part of Network's init data (\sa Network::initIrcUsersAndChannels())
+    /** These correspond to the properties and init methods, so peers can still fall back to fromVariantMap().
+     *  Keep this in sync with them!
+     */
+    enum InitColumn {
+        NameColumn,
+        TopicColumn,
+        PasswordColumn,
+        EncryptedColumn,
+        ChanModesColumn,
+        UserModesColumn,
+        InitColumnCount
+    };
+
     IrcChannel(const QString &channelname, Network *network);
     ~IrcChannel();
 
+    static QString initColumnName(int column);
+    //! Appends the channel's state to the columns, without going through the meta object like toVariantMap()
+    void appendInitColumns(QVector<QVariantList> &columns) const;
+    //! Sets the state of a new channel from a row of the columns
+    void initSetColumns(const QVector<QVariantList> &columns, int row);
+
     bool isKnownUser(IrcUser *ircuser) const;
     bool isValidChannelUserMode(const QString &mode) const;
 
@@ -86,6 +107,8 @@ public slots:
 
     void part(IrcUser *ircuser);
     void part(const QString &nick);
+    void partIrcUsers(const QList<IrcUser *> &users);
+    void partIrcUsers(const QStringList &nicks);
 
     void setUserModes(IrcUser *ircuser, const QString &modes);
     void setUserModes(const QString &nick, const QString &modes);
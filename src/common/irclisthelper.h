@@ -31,6 +31,16 @@
  *  2.) RPL_LIST fills on the core the list of available channels
  *      when RPL_LISTEND is received the clients will be informed, that they can pull the data
  *  3.) client pulls the data by calling requestChannelList again. receiving the data in receiveChannelList
+ *
+ * If the core supports Quassel::PagedChannelList, clients can instead fetch the list in pages
+ * while it is still being received by calling requestChannelListPage(). The core announces
+ * the number of channels received so far with reportChannelListProgress() and applies the
+ * given filter to every page, so only matching channels are transferred. Known filter keys:
+ *   "Pattern"  - wildcard matched case insensitively against the channel name
+ *   "MinUsers" - minimum number of users in the channel
+ *   "Topic"    - case insensitive substring of the topic
+ * Finished lists are cached on the core for a while, so repeating the same query is answered
+ * without sending another LIST to the server.
  */
 class IrcListHelper : public SyncableObject
 {
@@ -50,6 +60,9 @@ public:
 public slots:
     inline virtual QVariantList requestChannelList(const NetworkId &netId, const QStringList &channelFilters) { REQUEST(ARG(netId), ARG(channelFilters)); return QVariantList(); }
     inline virtual void receiveChannelList(const NetworkId &, const QStringList &, const QVariantList &) {};
+    inline virtual QVariantMap requestChannelListPage(const NetworkId &netId, const QVariantMap &filter, int offset) { REQUEST(ARG(netId), ARG(filter), ARG(offset)); return QVariantMap(); }
+    inline virtual void receiveChannelListPage(const NetworkId &, const QVariantMap &, int, const QVariantMap &) {};
+    inline virtual void reportChannelListProgress(const NetworkId &netId, int channelCount) { SYNC(ARG(netId), ARG(channelCount)) }
     inline virtual void reportFinishedList(const NetworkId &netId) { SYNC(ARG(netId)) }
     inline virtual void reportError(const QString &error) { SYNC(ARG(error)) }
 };
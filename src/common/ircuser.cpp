@@ -56,6 +56,62 @@ IrcUser::~IrcUser()
 }
 
 
+QString IrcUser::initColumnName(int column)
+{
+    static const char *const names[InitColumnCount] = {
+        "user", "host", "nick", "realName", "away", "awayMessage", "idleTime", "loginTime", "server", "ircOperator",
+        "lastAwayMessage", "whoisServiceReply", "suserHost", "encrypted", "channels", "userModes"
+    };
+    Q_ASSERT(column >= 0 && column < InitColumnCount);
+    return QString::fromLatin1(names[column]);
+}
+
+
+void IrcUser::appendInitColumns(QVector<QVariantList> &columns)
+{
+    Q_ASSERT(columns.count() == InitColumnCount);
+    columns[UserColumn] << _user;
+    columns[HostColumn] << _host;
+    columns[NickColumn] << _nick;
+    columns[RealNameColumn] << _realName;
+    columns[AwayColumn] << _away;
+    columns[AwayMessageColumn] << _awayMessage;
+    columns[IdleTimeColumn] << idleTime();
+    columns[LoginTimeColumn] << _loginTime;
+    columns[ServerColumn] << _server;
+    columns[IrcOperatorColumn] << _ircOperator;
+    columns[LastAwayMessageColumn] << _lastAwayMessage;
+    columns[WhoisServiceReplyColumn] << _whoisServiceReply;
+    columns[SuserHostColumn] << _suserHost;
+    columns[EncryptedColumn] << _encrypted;
+    columns[ChannelsColumn] << channels();
+    columns[UserModesColumn] << _userModes;
+}
+
+
+void IrcUser::initSetColumns(const QVector<QVariantList> &columns, int row)
+{
+    Q_ASSERT(columns.count() == InitColumnCount);
+    // the nick was already set by the constructor, and channels are joined by the channels themselves
+    _user = columns[UserColumn].at(row).toString();
+    _host = columns[HostColumn].at(row).toString();
+    _realName = columns[RealNameColumn].at(row).toString();
+    _away = columns[AwayColumn].at(row).toBool();
+    _awayMessage = columns[AwayMessageColumn].at(row).toString();
+    _idleTime = columns[IdleTimeColumn].at(row).toDateTime();
+    if (_idleTime.isValid())
+        _idleTimeSet = QDateTime::currentDateTime();
+    _loginTime = columns[LoginTimeColumn].at(row).toDateTime();
+    _server = columns[ServerColumn].at(row).toString();
+    _ircOperator = columns[IrcOperatorColumn].at(row).toString();
+    _lastAwayMessage = columns[LastAwayMessageColumn].at(row).toInt();
+    _whoisServiceReply = columns[WhoisServiceReplyColumn].at(row).toString();
+    _suserHost = columns[SuserHostColumn].at(row).toString();
+    _encrypted = columns[EncryptedColumn].at(row).toBool();
+    _userModes = columns[UserModesColumn].at(row).toString();
+}
+
+
 // ====================
 //  PUBLIC:
 // ====================
@@ -317,6 +373,20 @@ void IrcUser::partChannel(const QString &channelname)
 }
 
 
+void IrcUser::leaveChannel(IrcChannel *channel)
+{
+    if (!_channels.contains(channel))
+        return;
+
+    _channels.remove(channel);
+    disconnect(channel, 0, this, 0);
+    if (_channels.isEmpty() && !network()->isMe(this)) {
+        network()->removeIrcUser(this);
+        emit quited();
+    }
+}
+
+
 void IrcUser::quit()
 {
     QList<IrcChannel *> channels = _channels.toList();
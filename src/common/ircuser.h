@@ -25,6 +25,7 @@
 #include <QString>
 #include <QStringList>
 #include <QVariantMap>
+#include <QVector>
 #include <QDateTime>
 
 #include "syncableobject.h"
@@ -58,9 +59,39 @@ class IrcUser : public SyncableObject
     Q_PROPERTY(QString userModes READ userModes WRITE setUserModes)
 
 public :
+    //! Columns of the users part of Network's init data (\sa Network::initIrcUsersAndChannels())
+    /** Each column holds one of the properties above, so peers can still fall back to fromVariantMap().
+     *  Keep this in sync with the list of properties!
+     */
+    enum InitColumn {
+        UserColumn,
+        HostColumn,
+        NickColumn,
+        RealNameColumn,
+        AwayColumn,
+        AwayMessageColumn,
+        IdleTimeColumn,
+        LoginTimeColumn,
+        ServerColumn,
+        IrcOperatorColumn,
+        LastAwayMessageColumn,
+        WhoisServiceReplyColumn,
+        SuserHostColumn,
+        EncryptedColumn,
+        ChannelsColumn,
+        UserModesColumn,
+        InitColumnCount
+    };
+
         IrcUser(const QString &hostmask, Network *network);
     virtual ~IrcUser();
 
+    static QString initColumnName(int column);
+    //! Appends the user's state to the columns, without going through the meta object like toVariantMap()
+    void appendInitColumns(QVector<QVariantList> &columns);
+    //! Sets the state of a new user from a row of the columns
+    void initSetColumns(const QVector<QVariantList> &columns, int row);
+
     inline QString user() const { return _user; }
     inline QString host() const { return _host; }
     inline QString nick() const { return _nick; }
@@ -99,6 +130,10 @@ public :
     inline QDateTime lastSpokenTo(BufferId id) const { return _lastSpokenTo.value(id); }
     void setLastSpokenTo(BufferId id, const QDateTime &time);
 
+    //! Leave a channel as part of IrcChannel::partIrcUsers(), which syncs the parts of all users itself
+    /** Both sides drop the user once it has left its last channel, so that isn't synced either. */
+    void leaveChannel(IrcChannel *channel);
+
 public slots:
     void setUser(const QString &user);
     void setHost(const QString &host);
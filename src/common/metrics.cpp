@@ -0,0 +1,227 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "metrics.h"
+
+#include <QMutex>
+#include <QVector>
+
+bool Metrics::_enabled = false;
+
+enum MetricType {
+    CounterMetric,
+    GaugeMetric,
+    HistogramMetric
+};
+
+// upper bounds of the histogram buckets, in microseconds
+static const qint64 bucketBounds[] = {
+    100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 5000000
+};
+static const int bucketCount = sizeof(bucketBounds) / sizeof(bucketBounds[0]);
+
+struct MetricSeries {
+    qint64 value; // histogram: sum of all observations
+    qint64 count;
+    QVector<qint64> buckets;
+    MetricSeries() : value(0), count(0) {}
+};
+
+struct MetricFamily {
+    MetricType type;
+    QByteArray help;
+    QMap<QString, MetricSeries> series;
+    MetricFamily() : type(CounterMetric) {}
+};
+
+struct MetricsRegistry {
+    QMutex mutex;
+    QMap<QByteArray, MetricFamily> families;
+};
+
+static MetricsRegistry &registry()
+{
+    static MetricsRegistry registry;
+    return registry;
+}
+
+
+// must be called with the registry locked
+static MetricSeries &series(const char *name, MetricType type, const QString &labels)
+{
+    // metric names are string literals, so we don't need to copy them
+    QByteArray key = QByteArray::fromRawData(name, qstrlen(name));
+    QMap<QByteArray, MetricFamily>::iterator family = registry().families.find(key);
+    if (family == registry().families.end())
+        family = registry().families.insert(key, MetricFamily());
+    if (family->series.isEmpty())
+        family->type = type;
+    return family->series[labels];
+}
+
+
+void Metrics::enable()
+{
+    _enabled = true;
+}
+
+
+void Metrics::increment(const char *name, const QString &labels, qint64 value)
+{
+    if (!_enabled)
+        return;
+
+    QMutexLocker locker(&registry().mutex);
+    series(name, CounterMetric, labels).value += value;
+}
+
+
+void Metrics::setGauge(const char *name, const QString &labels, qint64 value)
+{
+    if (!_enabled)
+        return;
+
+    QMutexLocker locker(&registry().mutex);
+    series(name, GaugeMetric, labels).value = value;
+}
+
+
+void Metrics::observe(const char *name, const QString &labels, qint64 usecs)
+{
+    if (!_enabled)
+        return;
+
+    QMutexLocker locker(&registry().mutex);
+    MetricSeries &s = series(name, HistogramMetric, labels);
+    if (s.buckets.isEmpty())
+        s.buckets.fill(0, bucketCount);
+    for (int i = 0; i < bucketCount; i++) {
+        if (usecs <= bucketBounds[i]) {
+            s.buckets[i]++;
+            break;
+        }
+    }
+    s.value += usecs;
+    s.count++;
+}
+
+
+void Metrics::describe(const char *name, const char *help)
+{
+    QMutexLocker locker(&registry().mutex);
+    QByteArray key = QByteArray::fromRawData(name, qstrlen(name));
+    registry().families[key].help = help;
+}
+
+
+static QString escapeLabelValue(QString value)
+{
+    return value.replace('\\', "\\\\").replace('"', "\\\"").replace('\n', "\\n");
+}
+
+
+QString Metrics::labels(const char *key, const QString &value)
+{
+    return QString("%1=\"%2\"").arg(key, escapeLabelValue(value));
+}
+
+
+QString Metrics::labels(const char *key1, const QString &value1, const char *key2, const QString &value2)
+{
+    return labels(key1, value1) + ',' + labels(key2, value2);
+}
+
+
+static QByteArray formatSeries(const QByteArray &name, const QString &labels, const QString &extraLabel = QString())
+{
+    QString allLabels = labels;
+    if (!extraLabel.isEmpty())
+        allLabels += (allLabels.isEmpty() ? "" : ",") + extraLabel;
+    if (allLabels.isEmpty())
+        return name + ' ';
+    return name + '{' + allLabels.toUtf8() + "} ";
+}
+
+
+QByteArray Metrics::prometheusText()
+{
+    QMutexLocker locker(&registry().mutex);
+
+    QByteArray text;
+    QMap<QByteArray, MetricFamily>::const_iterator family;
+    for (family = registry().families.constBegin(); family != registry().families.constEnd(); ++family) {
+        if (family->series.isEmpty())
+            continue;
+
+        const QByteArray &name = family.key();
+        if (!family->help.isEmpty())
+            text += "# HELP " + name + ' ' + family->help + '\n';
+
+        switch (family->type) {
+        case CounterMetric:
+            text += "# TYPE " + name + " counter\n";
+            break;
+        case GaugeMetric:
+            text += "# TYPE " + name + " gauge\n";
+            break;
+        case HistogramMetric:
+            text += "# TYPE " + name + " histogram\n";
+            break;
+        }
+
+        QMap<QString, MetricSeries>::const_iterator s;
+        for (s = family->series.constBegin(); s != family->series.constEnd(); ++s) {
+            if (family->type != HistogramMetric) {
+                text += formatSeries(name, s.key()) + QByteArray::number(s->value) + '\n';
+                continue;
+            }
+            qint64 cumulative = 0;
+            for (int i = 0; i < s->buckets.count(); i++) {
+                cumulative += s->buckets.at(i);
+                QString le = QString("le=\"%1\"").arg(bucketBounds[i] / 1000000.0);
+                text += formatSeries(name + "_bucket", s.key(), le) + QByteArray::number(cumulative) + '\n';
+            }
+            text += formatSeries(name + "_bucket", s.key(), "le=\"+Inf\"") + QByteArray::number(s->count) + '\n';
+            text += formatSeries(name + "_sum", s.key()) + QByteArray::number(s->value / 1000000.0) + '\n';
+            text += formatSeries(name + "_count", s.key()) + QByteArray::number(s->count) + '\n';
+        }
+    }
+    return text;
+}
+
+
+QMap<QString, qint64> Metrics::values(const char *name, QMap<QString, qint64> *counts)
+{
+    QMutexLocker locker(&registry().mutex);
+
+    QMap<QString, qint64> result;
+    QByteArray key = QByteArray::fromRawData(name, qstrlen(name));
+    QMap<QByteArray, MetricFamily>::const_iterator family = registry().families.constFind(key);
+    if (family == registry().families.constEnd())
+        return result;
+
+    QMap<QString, MetricSeries>::const_iterator s;
+    for (s = family->series.constBegin(); s != family->series.constEnd(); ++s) {
+        result[s.key()] = s->value;
+        if (counts)
+            (*counts)[s.key()] = s->count;
+    }
+    return result;
+}
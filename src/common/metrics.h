@@ -0,0 +1,96 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef METRICS_H
+#define METRICS_H
+
+#include <QByteArray>
+#include <QMap>
+#include <QString>
+
+#if QT_VERSION >= 0x040700
+#  include <QElapsedTimer>
+#else
+#  include <QTime>
+#endif
+
+//! Process-wide counters, gauges and latency histograms
+/** Values are identified by a metric name and a preformatted label set (see labels()), and can be
+ *  exported in the Prometheus text format. All functions are thread-safe.
+ *
+ *  Recording is disabled until enable() is called, which the core does when an endpoint for
+ *  scraping the values has been configured. Callers should check isEnabled() before building
+ *  label strings, so that instrumentation costs no more than a branch otherwise.
+ */
+class Metrics
+{
+public:
+    class Timer;
+
+    static void enable();
+    static inline bool isEnabled() { return _enabled; }
+
+    static void increment(const char *name, const QString &labels = QString(), qint64 value = 1);
+    static void setGauge(const char *name, const QString &labels, qint64 value);
+    //! Adds a duration (in microseconds) to a latency histogram
+    static void observe(const char *name, const QString &labels, qint64 usecs);
+
+    //! Sets the HELP text shown for a metric in the export
+    static void describe(const char *name, const char *help);
+
+    static QString labels(const char *key, const QString &value);
+    static QString labels(const char *key1, const QString &value1, const char *key2, const QString &value2);
+
+    //! Returns all recorded values in the Prometheus text exposition format
+    static QByteArray prometheusText();
+
+    //! Returns the current values of a metric, keyed by label set
+    /** For histograms this is the sum of all observations in microseconds, and \p counts receives
+     *  the number of observations if given.
+     */
+    static QMap<QString, qint64> values(const char *name, QMap<QString, qint64> *counts = 0);
+
+private:
+    static bool _enabled;
+};
+
+
+//! Measures the time between construction and elapsed()
+class Metrics::Timer
+{
+public:
+    inline Timer() { if (Metrics::isEnabled()) _timer.start(); }
+
+#if QT_VERSION >= 0x040800
+    inline qint64 elapsed() const { return _timer.nsecsElapsed() / 1000; }
+#else
+    inline qint64 elapsed() const { return _timer.elapsed() * 1000; }
+#endif
+
+private:
+#if QT_VERSION >= 0x040700
+    QElapsedTimer _timer;
+#else
+    QTime _timer;
+#endif
+};
+
+
+#endif
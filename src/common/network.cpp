@@ -221,26 +221,31 @@ IrcUser *Network::newIrcUser(const QString &hostmask, const QVariantMap &initDat
             ircuser->fromVariantMap(initData);
             ircuser->setInitialized();
         }
+        attachIrcUser(nick, ircuser);
+    }
 
-        if (proxy())
-            proxy()->synchronize(ircuser);
-        else
-            qWarning() << "unable to synchronize new IrcUser" << hostmask << "forgot to call Network::setProxy(SignalProxy *)?";
+    return _ircUsers[nick];
+}
 
-        connect(ircuser, SIGNAL(nickSet(QString)), this, SLOT(ircUserNickChanged(QString)));
 
-        _ircUsers[nick] = ircuser;
+void Network::attachIrcUser(const QString &key, IrcUser *ircuser)
+{
+    if (proxy())
+        proxy()->synchronize(ircuser);
+    else
+        qWarning() << "unable to synchronize new IrcUser" << ircuser->hostmask() << "forgot to call Network::setProxy(SignalProxy *)?";
 
-        // This method will be called with a nick instead of hostmask by setInitIrcUsersAndChannels().
-        // Not a problem because initData contains all we need; however, making sure here to get the real
-        // hostmask out of the IrcUser afterwards.
-        QString mask = ircuser->hostmask();
-        SYNC_OTHER(addIrcUser, ARG(mask));
-        // emit ircUserAdded(mask);
-        emit ircUserAdded(ircuser);
-    }
+    connect(ircuser, SIGNAL(nickSet(QString)), this, SLOT(ircUserNickChanged(QString)));
 
-    return _ircUsers[nick];
+    _ircUsers[key] = ircuser;
+
+    // This method will be called with a nick instead of hostmask by setInitIrcUsersAndChannels().
+    // Not a problem because initData contains all we need; however, making sure here to get the real
+    // hostmask out of the IrcUser afterwards.
+    QString mask = ircuser->hostmask();
+    SYNC_OTHER(addIrcUser, ARG(mask));
+    // emit ircUserAdded(mask);
+    emit ircUserAdded(ircuser);
 }
 
 
@@ -256,7 +261,10 @@ IrcUser *Network::ircUser(QString nickname) const
 
 void Network::removeIrcUser(IrcUser *ircuser)
 {
-    QString nick = _ircUsers.key(ircuser);
+    // the hash is keyed by the lowercased nick, so only fall back to the linear search if that fails
+    QString nick = ircuser->nick().toLower();
+    if (_ircUsers.value(nick) != ircuser)
+        nick = _ircUsers.key(ircuser);
     if (nick.isNull())
         return;
 
@@ -268,7 +276,9 @@ void Network::removeIrcUser(IrcUser *ircuser)
 
 void Network::removeIrcChannel(IrcChannel *channel)
 {
-    QString chanName = _ircChannels.key(channel);
+    QString chanName = channel->name().toLower();
+    if (_ircChannels.value(chanName) != channel)
+        chanName = _ircChannels.key(channel);
     if (chanName.isNull())
         return;
 
@@ -298,19 +308,25 @@ IrcChannel *Network::newIrcChannel(const QString &channelname, const QVariantMap
             channel->fromVariantMap(initData);
             channel->setInitialized();
         }
+        attachIrcChannel(channelname.toLower(), channel);
+    }
+    return _ircChannels[channelname.toLower()];
+}
 
-        if (proxy())
-            proxy()->synchronize(channel);
-        else
-            qWarning() << "unable to synchronize new IrcChannel" << channelname << "forgot to call Network::setProxy(SignalProxy *)?";
 
-        _ircChannels[channelname.toLower()] = channel;
+void Network::attachIrcChannel(const QString &key, IrcChannel *channel)
+{
+    QString channelname = channel->name();
+    if (proxy())
+        proxy()->synchronize(channel);
+    else
+        qWarning() << "unable to synchronize new IrcChannel" << channelname << "forgot to call Network::setProxy(SignalProxy *)?";
 
-        SYNC_OTHER(addIrcChannel, ARG(channelname))
-        // emit ircChannelAdded(channelname);
-        emit ircChannelAdded(channel);
-    }
-    return _ircChannels[channelname.toLower()];
+    _ircChannels[key] = channel;
+
+    SYNC_OTHER(addIrcChannel, ARG(channelname))
+    // emit ircChannelAdded(channelname);
+    emit ircChannelAdded(channel);
 }
 
 
@@ -694,6 +710,23 @@ QVariantMap Network::initSupports() const
 }
 
 
+// Collects the named lists of the map in the given column order; fails if the map has a different layout
+static bool initColumnsFromMap(const QVariantMap &map, int columnCount, QString (*columnName)(int), QVector<QVariantList> &columns)
+{
+    if (map.count() != columnCount)
+        return false;
+
+    columns.resize(columnCount);
+    for (int i = 0; i < columnCount; i++) {
+        QVariantMap::const_iterator iter = map.constFind(columnName(i));
+        if (iter == map.constEnd())
+            return false;
+        columns[i] = iter->toList();
+    }
+    return true;
+}
+
+
 // There's potentially a lot of users and channels, so it makes sense to optimize the format of this.
 // Rather than sending a thousand maps with identical keys, we convert this into one map containing lists
 // where each list index corresponds to a particular IrcUser. This saves sending the key names a thousand times.
@@ -703,43 +736,35 @@ QVariantMap Network::initIrcUsersAndChannels() const
 {
     QVariantMap usersAndChannels;
 
+    // The users and channels are transferred column by column, i.e. one list per property. Since there
+    // may be tens of thousands of users, the columns are filled directly from the objects rather than
+    // via toVariantMap(), which looks up and invokes every property and init method by name.
     if (_ircUsers.count()) {
-        QHash<QString, QVariantList> users;
-        QHash<QString, IrcUser *>::const_iterator it = _ircUsers.begin();
-        QHash<QString, IrcUser *>::const_iterator end = _ircUsers.end();
-        while (it != end) {
-            const QVariantMap &map = it.value()->toVariantMap();
-            QVariantMap::const_iterator mapiter = map.begin();
-            while (mapiter != map.end()) {
-                users[mapiter.key()] << mapiter.value();
-                ++mapiter;
-            }
-            ++it;
-        }
+        QVector<QVariantList> columns(IrcUser::InitColumnCount);
+        for (int i = 0; i < columns.count(); i++)
+            columns[i].reserve(_ircUsers.count());
+
+        foreach(IrcUser *ircuser, _ircUsers)
+            ircuser->appendInitColumns(columns);
+
         // Can't have a container with a value type != QVariant in a QVariant :(
-        // However, working directly on a QVariantMap is awkward for appending, thus the detour via the hash above.
         QVariantMap userMap;
-        foreach(const QString &key, users.keys())
-            userMap[key] = users[key];
+        for (int i = 0; i < columns.count(); i++)
+            userMap[IrcUser::initColumnName(i)] = columns[i];
         usersAndChannels["Users"] = userMap;
     }
 
     if (_ircChannels.count()) {
-        QHash<QString, QVariantList> channels;
-        QHash<QString, IrcChannel *>::const_iterator it = _ircChannels.begin();
-        QHash<QString, IrcChannel *>::const_iterator end = _ircChannels.end();
-        while (it != end) {
-            const QVariantMap &map = it.value()->toVariantMap();
-            QVariantMap::const_iterator mapiter = map.begin();
-            while (mapiter != map.end()) {
-                channels[mapiter.key()] << mapiter.value();
-                ++mapiter;
-            }
-            ++it;
-        }
+        QVector<QVariantList> columns(IrcChannel::InitColumnCount);
+        for (int i = 0; i < columns.count(); i++)
+            columns[i].reserve(_ircChannels.count());
+
+        foreach(const IrcChannel *channel, _ircChannels)
+            channel->appendInitColumns(columns);
+
         QVariantMap channelMap;
-        foreach(const QString &key, channels.keys())
-            channelMap[key] = channels[key];
+        for (int i = 0; i < columns.count(); i++)
+            channelMap[IrcChannel::initColumnName(i)] = columns[i];
         usersAndChannels["Channels"] = channelMap;
     }
 
@@ -770,11 +795,28 @@ void Network::initSetIrcUsersAndChannels(const QVariantMap &usersAndChannels)
     }
 
     // now create the individual IrcUsers
-    for(int i = 0; i < count; i++) {
-        QVariantMap map;
-        foreach(const QString &key, users.keys())
-            map[key] = users[key].toList().at(i);
-        newIrcUser(map["nick"].toString(), map); // newIrcUser() properly handles the hostmask being just the nick
+    QVector<QVariantList> columns;
+    if (initColumnsFromMap(users, IrcUser::InitColumnCount, &IrcUser::initColumnName, columns)) {
+        // fast path: the columns match our own IrcUser, so we can set them directly
+        const QVariantList &nicks = columns[IrcUser::NickColumn];
+        for (int i = 0; i < count; i++) {
+            const QString nick = nicks.at(i).toString();
+            const QString key = nick.toLower();
+            if (_ircUsers.contains(key))
+                continue;
+            IrcUser *ircuser = ircUserFactory(nick);
+            ircuser->initSetColumns(columns, i);
+            ircuser->setInitialized();
+            attachIrcUser(key, ircuser);
+        }
+    }
+    else {
+        for (int i = 0; i < count; i++) {
+            QVariantMap map;
+            foreach(const QString &key, users.keys())
+                map[key] = users[key].toList().at(i);
+            newIrcUser(map["nick"].toString(), map); // newIrcUser() properly handles the hostmask being just the nick
+        }
     }
 
     // same thing for IrcChannels
@@ -789,11 +831,26 @@ void Network::initSetIrcUsersAndChannels(const QVariantMap &usersAndChannels)
         }
     }
     // now create the individual IrcChannels
-    for(int i = 0; i < count; i++) {
-        QVariantMap map;
-        foreach(const QString &key, channels.keys())
-            map[key] = channels[key].toList().at(i);
-        newIrcChannel(map["name"].toString(), map);
+    if (initColumnsFromMap(channels, IrcChannel::InitColumnCount, &IrcChannel::initColumnName, columns)) {
+        const QVariantList &names = columns[IrcChannel::NameColumn];
+        for (int i = 0; i < count; i++) {
+            const QString name = names.at(i).toString();
+            const QString key = name.toLower();
+            if (_ircChannels.contains(key))
+                continue;
+            IrcChannel *channel = ircChannelFactory(name);
+            channel->initSetColumns(columns, i);
+            channel->setInitialized();
+            attachIrcChannel(key, channel);
+        }
+    }
+    else {
+        for (int i = 0; i < count; i++) {
+            QVariantMap map;
+            foreach(const QString &key, channels.keys())
+                map[key] = channels[key].toList().at(i);
+            newIrcChannel(map["name"].toString(), map);
+        }
     }
 }
 
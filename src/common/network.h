@@ -321,6 +321,10 @@ protected:
     inline virtual IrcUser *ircUserFactory(const QString &hostmask) { return new IrcUser(hostmask, this); }
 
 private:
+    // registers and synchronizes a newly created user or channel; key is the lowercased nick or channel name
+    void attachIrcUser(const QString &key, IrcUser *ircuser);
+    void attachIrcChannel(const QString &key, IrcChannel *channel);
+
     QPointer<SignalProxy> _proxy;
 
     NetworkId _networkId;
@@ -23,6 +23,7 @@
 Peer::Peer(AuthHandler *authHandler, QObject *parent)
     : QObject(parent)
     , _authHandler(authHandler)
+    , _features(0)
 {
 
 }
@@ -32,3 +33,15 @@ AuthHandler *Peer::authHandler() const
 {
     return _authHandler;
 }
+
+
+Quassel::Features Peer::features() const
+{
+    return _features;
+}
+
+
+void Peer::setFeatures(Quassel::Features features)
+{
+    _features = features;
+}
@@ -26,6 +26,7 @@
 
 #include "authhandler.h"
 #include "protocol.h"
+#include "quassel.h"
 #include "signalproxy.h"
 
 class Peer : public QObject
@@ -48,6 +49,10 @@ public:
 
     virtual int lag() const = 0;
 
+    //! The features the other side told us about during the handshake, 0 for older versions
+    Quassel::Features features() const;
+    void setFeatures(Quassel::Features features);
+
 public slots:
     /* Handshake messages */
     virtual void dispatch(const Protocol::RegisterClient &) = 0;
@@ -80,6 +85,7 @@ protected:
 
 private:
     QPointer<AuthHandler> _authHandler;
+    Quassel::Features _features;
 };
 
 // We need to special-case Peer* in attached signals/slots, so typedef it for the meta type system
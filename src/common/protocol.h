@@ -56,11 +56,13 @@ struct HandshakeMessage {
 
 struct RegisterClient : public HandshakeMessage
 {
-    inline RegisterClient(const QString &clientVersion, const QString &buildDate, bool sslSupported = false)
-    : clientVersion(clientVersion)
+    inline RegisterClient(quint32 clientFeatures, const QString &clientVersion, const QString &buildDate, bool sslSupported = false)
+    : clientFeatures(clientFeatures)
+    , clientVersion(clientVersion)
     , buildDate(buildDate)
     , sslSupported(sslSupported) {}
 
+    quint32 clientFeatures;
     QString clientVersion;
     QString buildDate;
 
@@ -128,10 +130,14 @@ struct SetupDone : public HandshakeMessage
 struct Login : public HandshakeMessage
 {
     inline Login(const QString &user, const QString &password)
-    : user(user), password(password) {}
+    : user(user), password(password), lastSequence(0) {}
 
     QString user;
     QString password;
+
+    // set when the client tries to resume a previous session; only sent if the peer supports it
+    QByteArray resumeToken;
+    quint64 lastSequence;
 };
 
 
@@ -153,13 +159,22 @@ struct LoginSuccess : public HandshakeMessage
 // TODO: more generic format
 struct SessionState : public HandshakeMessage
 {
-    inline SessionState() {} // needed for QMetaType (for the mono client)
+    inline SessionState() : resumed(false) {} // needed for QMetaType (for the mono client)
     inline SessionState(const QVariantList &identities, const QVariantList &bufferInfos, const QVariantList &networkIds)
-    : identities(identities), bufferInfos(bufferInfos), networkIds(networkIds) {}
+    : identities(identities), bufferInfos(bufferInfos), networkIds(networkIds), resumed(false) {}
 
     QVariantList identities;
     QVariantList bufferInfos;
     QVariantList networkIds;
+
+    // init data of the session's objects, so the client doesn't need to request it one by one
+    // flat list of (className, objectName, initData) triples; only filled if the peer supports it
+    QVariantList initDataSnapshot;
+
+    // token for resuming this session later, and whether the client's previous session was resumed;
+    // in the latter case the other fields are empty and the client keeps its existing state
+    QByteArray resumeToken;
+    bool resumed;
 };
 
 /*** handled by SignalProxy ***/
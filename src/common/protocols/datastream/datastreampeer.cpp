@@ -22,21 +22,41 @@
 
 #include <QHostAddress>
 #include <QTcpSocket>
+#include <QVector>
 
 #include "datastreampeer.h"
 
 using namespace Protocol;
 
+QDataStream &operator<<(QDataStream &out, const CompactMessageBatch &batch)
+{
+    out << batch.data;
+    return out;
+}
+
+
+QDataStream &operator>>(QDataStream &in, CompactMessageBatch &batch)
+{
+    in >> batch.data;
+    return in;
+}
+
+
 DataStreamPeer::DataStreamPeer(::AuthHandler *authHandler, QTcpSocket *socket, quint16 features, Compressor::CompressionLevel level, QObject *parent)
-    : RemotePeer(authHandler, socket, level, parent)
+    : RemotePeer(authHandler, socket, level, parent),
+    _features(features & supportedFeatures())
 {
-    Q_UNUSED(features);
+    static bool batchTypeRegistered = false;
+    if (!batchTypeRegistered) {
+        qRegisterMetaTypeStreamOperators<CompactMessageBatch>("CompactMessageBatch");
+        batchTypeRegistered = true;
+    }
 }
 
 
 quint16 DataStreamPeer::supportedFeatures()
 {
-    return 0;
+    return CompactMessages | SessionSnapshot | SessionResume;
 }
 
 
@@ -49,7 +69,7 @@ bool DataStreamPeer::acceptsFeatures(quint16 peerFeatures)
 
 quint16 DataStreamPeer::enabledFeatures() const
 {
-    return 0;
+    return _features;
 }
 
 
@@ -116,7 +136,7 @@ void DataStreamPeer::handleHandshakeMessage(const QVariantList &mapData)
     }
 
     if (msgType == "ClientInit") {
-        handle(RegisterClient(m["ClientVersion"].toString(), m["ClientDate"].toString(), false)); // UseSsl obsolete
+        handle(RegisterClient(m["Features"].toUInt(), m["ClientVersion"].toString(), m["ClientDate"].toString(), false)); // UseSsl obsolete
     }
 
     else if (msgType == "ClientInitReject") {
@@ -141,7 +161,12 @@ void DataStreamPeer::handleHandshakeMessage(const QVariantList &mapData)
     }
 
     else if (msgType == "ClientLogin") {
-        handle(Login(m["User"].toString(), m["Password"].toString()));
+        Login login(m["User"].toString(), m["Password"].toString());
+        if (_features & SessionResume) {
+            login.resumeToken = m["ResumeToken"].toByteArray();
+            login.lastSequence = m["LastSequence"].toULongLong();
+        }
+        handle(login);
     }
 
     else if (msgType == "ClientLoginReject") {
@@ -154,7 +179,14 @@ void DataStreamPeer::handleHandshakeMessage(const QVariantList &mapData)
 
     else if (msgType == "SessionInit") {
         QVariantMap map = m["SessionState"].toMap();
-        handle(SessionState(map["Identities"].toList(), map["BufferInfos"].toList(), map["NetworkIds"].toList()));
+        SessionState sessionState(map["Identities"].toList(), map["BufferInfos"].toList(), map["NetworkIds"].toList());
+        if (_features & SessionSnapshot)
+            sessionState.initDataSnapshot = map["InitDataSnapshot"].toList();
+        if (_features & SessionResume) {
+            sessionState.resumeToken = map["ResumeToken"].toByteArray();
+            sessionState.resumed = map["Resumed"].toBool();
+        }
+        handle(sessionState);
     }
 
     else {
@@ -168,6 +200,7 @@ void DataStreamPeer::dispatch(const RegisterClient &msg) {
     m["MsgType"] = "ClientInit";
     m["ClientVersion"] = msg.clientVersion;
     m["ClientDate"] = msg.buildDate;
+    m["Features"] = msg.clientFeatures;
 
     writeMessage(m);
 }
@@ -236,6 +269,10 @@ void DataStreamPeer::dispatch(const Login &msg)
     m["MsgType"] = "ClientLogin";
     m["User"] = msg.user;
     m["Password"] = msg.password;
+    if ((_features & SessionResume) && !msg.resumeToken.isEmpty()) {
+        m["ResumeToken"] = msg.resumeToken;
+        m["LastSequence"] = msg.lastSequence;
+    }
 
     writeMessage(m);
 }
@@ -271,6 +308,12 @@ void DataStreamPeer::dispatch(const SessionState &msg)
     map["BufferInfos"] = msg.bufferInfos;
     map["NetworkIds"] = msg.networkIds;
     map["Identities"] = msg.identities;
+    if (_features & SessionSnapshot)
+        map["InitDataSnapshot"] = msg.initDataSnapshot;
+    if (_features & SessionResume) {
+        map["ResumeToken"] = msg.resumeToken;
+        map["Resumed"] = msg.resumed;
+    }
     m["SessionState"] = map;
 
     writeMessage(m);
@@ -299,7 +342,7 @@ void DataStreamPeer::handlePackedFunc(const QVariantList &packedFunc)
             QByteArray className = params.takeFirst().toByteArray();
             QString objectName = QString::fromUtf8(params.takeFirst().toByteArray());
             QByteArray slotName = params.takeFirst().toByteArray();
-            handle(Protocol::SyncMessage(className, objectName, slotName, params));
+            handle(Protocol::SyncMessage(className, objectName, slotName, decodeMessages(params)));
             break;
         }
         case RpcCall: {
@@ -308,7 +351,7 @@ void DataStreamPeer::handlePackedFunc(const QVariantList &packedFunc)
                 return;
             }
             QByteArray slotName = params.takeFirst().toByteArray();
-            handle(Protocol::RpcCall(slotName, params));
+            handle(Protocol::RpcCall(slotName, decodeMessages(params)));
             break;
         }
         case InitRequest: {
@@ -359,13 +402,13 @@ void DataStreamPeer::handlePackedFunc(const QVariantList &packedFunc)
 
 void DataStreamPeer::dispatch(const Protocol::SyncMessage &msg)
 {
-    dispatchPackedFunc(QVariantList() << (qint16)Sync << msg.className << msg.objectName.toUtf8() << msg.slotName << msg.params);
+    dispatchPackedFunc(QVariantList() << (qint16)Sync << msg.className << msg.objectName.toUtf8() << msg.slotName << encodeMessages(msg.params));
 }
 
 
 void DataStreamPeer::dispatch(const Protocol::RpcCall &msg)
 {
-    dispatchPackedFunc(QVariantList() << (qint16)RpcCall << msg.slotName << msg.params);
+    dispatchPackedFunc(QVariantList() << (qint16)RpcCall << msg.slotName << encodeMessages(msg.params));
 }
 
 
@@ -403,3 +446,156 @@ void DataStreamPeer::dispatchPackedFunc(const QVariantList &packedFunc)
 {
     writeMessage(packedFunc);
 }
+
+
+/*** Compact message encoding ***/
+
+QVariantList DataStreamPeer::encodeMessages(const QVariantList &params)
+{
+    if (!(_features & CompactMessages))
+        return params;
+
+    QVariantList result;
+    foreach(const QVariant &param, params) {
+        if (param.userType() == qMetaTypeId<Message>()) {
+            result << qVariantFromValue(encodeMessageBatch(MessageList() << param.value<Message>(), false));
+            continue;
+        }
+        if (param.type() == QVariant::List) {
+            QVariantList list = param.toList();
+            MessageList messages;
+            foreach(const QVariant &v, list) {
+                if (v.userType() != qMetaTypeId<Message>())
+                    break;
+                messages << v.value<Message>();
+            }
+            if (!messages.isEmpty() && messages.count() == list.count()) {
+                result << qVariantFromValue(encodeMessageBatch(messages, true));
+                continue;
+            }
+        }
+        result << param;
+    }
+    return result;
+}
+
+
+QVariantList DataStreamPeer::decodeMessages(const QVariantList &params)
+{
+    if (!(_features & CompactMessages))
+        return params;
+
+    QVariantList result;
+    foreach(const QVariant &param, params) {
+        if (param.userType() == qMetaTypeId<CompactMessageBatch>())
+            result << decodeMessageBatch(param.value<CompactMessageBatch>());
+        else
+            result << param;
+    }
+    return result;
+}
+
+
+CompactMessageBatch DataStreamPeer::encodeMessageBatch(const MessageList &messages, bool isList)
+{
+    CompactMessageBatch batch;
+    QDataStream out(&batch.data, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_4_2);
+
+    // dictionary entries for buffers the peer doesn't know yet, or that changed since we sent them
+    QList<BufferInfo> newBufferInfos;
+    foreach(const Message &msg, messages) {
+        const BufferInfo &bufferInfo = msg.bufferInfo();
+        QHash<BufferId, BufferInfo>::const_iterator sent = _sentBufferInfos.constFind(bufferInfo.bufferId());
+        if (sent != _sentBufferInfos.constEnd() && sent->networkId() == bufferInfo.networkId() && sent->type() == bufferInfo.type()
+            && sent->groupId() == bufferInfo.groupId() && sent->bufferName() == bufferInfo.bufferName())
+            continue;
+        _sentBufferInfos[bufferInfo.bufferId()] = bufferInfo;
+        newBufferInfos << bufferInfo;
+    }
+
+    out << (quint8)isList << (quint32)messages.count() << (quint32)newBufferInfos.count();
+    foreach(const BufferInfo &bufferInfo, newBufferInfos)
+        out << bufferInfo;
+
+    // one column per field, which also compresses a lot better than interleaved records
+    foreach(const Message &msg, messages)
+        out << msg.msgId();
+    foreach(const Message &msg, messages)
+        out << (quint32)msg.timestamp().toTime_t();
+    foreach(const Message &msg, messages)
+        out << (quint32)msg.type();
+    foreach(const Message &msg, messages)
+        out << (quint8)msg.flags();
+    foreach(const Message &msg, messages)
+        out << msg.bufferInfo().bufferId();
+    foreach(const Message &msg, messages)
+        out << msg.sender().toUtf8();
+    foreach(const Message &msg, messages)
+        out << msg.contents().toUtf8();
+
+    return batch;
+}
+
+
+QVariant DataStreamPeer::decodeMessageBatch(const CompactMessageBatch &batch)
+{
+    QDataStream in(batch.data);
+    in.setVersion(QDataStream::Qt_4_2);
+
+    quint8 isList;
+    quint32 count, dictionaryCount;
+    in >> isList >> count >> dictionaryCount;
+    // every message takes at least 17 bytes, anything else is garbage
+    if (in.status() != QDataStream::Ok || count > (quint32)batch.data.size() / 17) {
+        qWarning() << Q_FUNC_INFO << "Received corrupt message batch!";
+        return QVariant();
+    }
+
+    for (quint32 i = 0; i < dictionaryCount && in.status() == QDataStream::Ok; i++) {
+        BufferInfo bufferInfo;
+        in >> bufferInfo;
+        _receivedBufferInfos[bufferInfo.bufferId()] = bufferInfo;
+    }
+
+    QVector<MsgId> msgIds(count);
+    QVector<quint32> timestamps(count);
+    QVector<quint32> types(count);
+    QVector<quint8> flags(count);
+    QVector<BufferId> bufferIds(count);
+    for (quint32 i = 0; i < count; i++)
+        in >> msgIds[i];
+    for (quint32 i = 0; i < count; i++)
+        in >> timestamps[i];
+    for (quint32 i = 0; i < count; i++)
+        in >> types[i];
+    for (quint32 i = 0; i < count; i++)
+        in >> flags[i];
+    for (quint32 i = 0; i < count; i++)
+        in >> bufferIds[i];
+
+    QVector<QString> senders(count);
+    QByteArray buffer;
+    for (quint32 i = 0; i < count; i++) {
+        in >> buffer;
+        senders[i] = QString::fromUtf8(buffer);
+    }
+
+    QVariantList messages;
+    for (quint32 i = 0; i < count; i++) {
+        in >> buffer;
+        Message msg(QDateTime::fromTime_t(timestamps[i]), _receivedBufferInfos.value(bufferIds[i]),
+            (Message::Type)types[i], QString::fromUtf8(buffer), senders[i], (Message::Flags)flags[i]);
+        msg.setMsgId(msgIds[i]);
+        messages << qVariantFromValue(msg);
+    }
+
+    if (in.status() != QDataStream::Ok) {
+        qWarning() << Q_FUNC_INFO << "Received corrupt message batch!";
+        return QVariant();
+    }
+
+    if (!isList)
+        return messages.value(0);
+    return messages;
+}
@@ -21,10 +21,22 @@
 #ifndef DATASTREAMPEER_H
 #define DATASTREAMPEER_H
 
+#include "../../bufferinfo.h"
+#include "../../message.h"
 #include "../../remotepeer.h"
 
 class QDataStream;
 
+//! Wire representation of one or more Messages if DataStreamPeer::CompactMessages is enabled
+/** \sa DataStreamPeer::encodeMessages() */
+struct CompactMessageBatch {
+    QByteArray data;
+};
+
+Q_DECLARE_METATYPE(CompactMessageBatch)
+QDataStream &operator<<(QDataStream &out, const CompactMessageBatch &batch);
+QDataStream &operator>>(QDataStream &in, CompactMessageBatch &batch);
+
 class DataStreamPeer : public RemotePeer
 {
     Q_OBJECT
@@ -39,6 +51,12 @@ public:
         HeartBeatReply
     };
 
+    enum Feature {
+        CompactMessages = 0x0001,
+        SessionSnapshot = 0x0002,
+        SessionResume = 0x0004
+    };
+
     DataStreamPeer(AuthHandler *authHandler, QTcpSocket *socket, quint16 features, Compressor::CompressionLevel level, QObject *parent = 0);
 
     Protocol::Type protocol() const { return Protocol::DataStreamProtocol; }
@@ -79,6 +97,22 @@ private:
     void handleHandshakeMessage(const QVariantList &mapData);
     void handlePackedFunc(const QVariantList &packedFunc);
     void dispatchPackedFunc(const QVariantList &packedFunc);
+
+    //! Replaces Message params and lists of Messages by CompactMessageBatches
+    /** A batch stores its messages column by column and only carries the BufferId of each message.
+     *  The full BufferInfo is sent once per connection as a dictionary entry, and again only if it
+     *  changed (e.g. when a query is renamed).
+     */
+    QVariantList encodeMessages(const QVariantList &params);
+    QVariantList decodeMessages(const QVariantList &params);
+    CompactMessageBatch encodeMessageBatch(const MessageList &messages, bool isList);
+    QVariant decodeMessageBatch(const CompactMessageBatch &batch);
+
+    quint16 _features;
+    QHash<BufferId, BufferInfo> _sentBufferInfos;
+    QHash<BufferId, BufferInfo> _receivedBufferInfos;
+
+    friend class ProtocolBenchmark; // compares the message encodings
 };
 
 #endif
@@ -71,8 +71,15 @@ public:
         SaslAuthentication = 0x0002,
         SaslExternal = 0x0004,
         HideInactiveNetworks = 0x0008,
-
-        NumFeatures = 0x0008
+        PagedChannelList = 0x0010,
+        BacklogRequestMulti = 0x0020,
+        BufferActivityCounts = 0x0040,
+        CoreSideHighlights = 0x0080,
+        BacklogByTime = 0x0100,
+        BacklogBySender = 0x0200,
+        BatchedChannelParts = 0x0400,
+
+        NumFeatures = 0x0400
     };
     Q_DECLARE_FLAGS(Features, Feature);
 
@@ -29,6 +29,7 @@
 #  include <QTcpSocket>
 #endif
 
+#include "metrics.h"
 #include "remotepeer.h"
 
 using namespace Protocol;
@@ -43,7 +44,8 @@ RemotePeer::RemotePeer(::AuthHandler *authHandler, QTcpSocket *socket, Compresso
     _heartBeatTimer(new QTimer(this)),
     _heartBeatCount(0),
     _lag(0),
-    _msgSize(0)
+    _msgSize(0),
+    _resumeSequence(0)
 {
     socket->setParent(this);
     connect(socket, SIGNAL(stateChanged(QAbstractSocket::SocketState)), SLOT(onSocketStateChanged(QAbstractSocket::SocketState)));
@@ -63,6 +65,13 @@ RemotePeer::RemotePeer(::AuthHandler *authHandler, QTcpSocket *socket, Compresso
 }
 
 
+void RemotePeer::setResumeInfo(const QByteArray &token, quint64 lastSequence)
+{
+    _resumeToken = token;
+    _resumeSequence = lastSequence;
+}
+
+
 void RemotePeer::onSocketStateChanged(QAbstractSocket::SocketState state)
 {
     if (state == QAbstractSocket::ClosingState) {
@@ -83,6 +92,13 @@ void RemotePeer::onCompressionError(Compressor::Error error)
 }
 
 
+QString RemotePeer::metricsProtocol() const
+{
+    // Peer addresses would create a new series for every connection
+    return protocol() == Protocol::LegacyProtocol ? "legacy" : "datastream";
+}
+
+
 QString RemotePeer::description() const
 {
     if (socket())
@@ -230,6 +246,9 @@ bool RemotePeer::readMessage(QByteArray &msg)
         return false;
     }
 
+    if (Metrics::isEnabled())
+        Metrics::increment("quassel_peer_bytes_received_total", Metrics::labels("protocol", metricsProtocol()), _msgSize + 4);
+
     _msgSize = 0;
     return true;
 }
@@ -240,6 +259,9 @@ void RemotePeer::writeMessage(const QByteArray &msg)
     quint32 size = qToBigEndian<quint32>(msg.size());
     _compressor->write((const char*)&size, 4, Compressor::NoFlush);
     _compressor->write(msg.constData(), msg.size());
+
+    if (Metrics::isEnabled())
+        Metrics::increment("quassel_peer_bytes_sent_total", Metrics::labels("protocol", metricsProtocol()), msg.size() + 4);
 }
 
 
@@ -50,6 +50,9 @@ public:
     virtual QString description() const;
     virtual quint16 enabledFeatures() const { return 0; }
 
+    //! Short protocol name used to label the peer metrics
+    QString metricsProtocol() const;
+
     bool isOpen() const;
     bool isSecure() const;
     bool isLocal() const;
@@ -61,6 +64,11 @@ public:
 
     QTcpSocket *socket() const;
 
+    //! The session the client asked to resume on login, if any (\sa Protocol::Login)
+    inline QByteArray resumeToken() const { return _resumeToken; }
+    inline quint64 resumeSequence() const { return _resumeSequence; }
+    void setResumeInfo(const QByteArray &token, quint64 lastSequence);
+
 public slots:
     void close(const QString &reason = QString());
 
@@ -103,6 +111,8 @@ private:
     int _heartBeatCount;
     int _lag;
     quint32 _msgSize;
+    QByteArray _resumeToken;
+    quint64 _resumeSequence;
 };
 
 #endif
@@ -0,0 +1,94 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "sessionjournal.h"
+
+#include "peer.h"
+
+using namespace Protocol;
+
+SessionJournal::SessionJournal(const QByteArray &token, int maxEntries)
+    : _token(token),
+    _maxEntries(maxEntries),
+    _sequence(0),
+    _detachedSince(QDateTime::currentDateTime())
+{
+}
+
+
+void SessionJournal::append(const SyncMessage &syncMessage)
+{
+    Entry entry;
+    entry.isSync = true;
+    entry.className = syncMessage.className;
+    entry.objectName = syncMessage.objectName;
+    entry.slotName = syncMessage.slotName;
+    entry.params = syncMessage.params;
+    append(entry);
+}
+
+
+void SessionJournal::append(const RpcCall &rpcCall)
+{
+    Entry entry;
+    entry.isSync = false;
+    entry.slotName = rpcCall.slotName;
+    entry.params = rpcCall.params;
+    append(entry);
+}
+
+
+void SessionJournal::append(const Entry &entry)
+{
+    _entries.append(entry);
+    _sequence++;
+    if (_entries.count() > _maxEntries)
+        _entries.removeFirst();
+}
+
+
+bool SessionJournal::canReplayFrom(quint64 lastSequence) const
+{
+    return lastSequence <= _sequence && _sequence - lastSequence <= (quint64)_entries.count();
+}
+
+
+int SessionJournal::replay(Peer *peer, quint64 lastSequence) const
+{
+    if (!peer || !canReplayFrom(lastSequence))
+        return 0;
+
+    int count = _sequence - lastSequence;
+    for (int i = _entries.count() - count; i < _entries.count(); i++) {
+        const Entry &entry = _entries.at(i);
+        if (entry.isSync)
+            peer->dispatch(SyncMessage(entry.className, entry.objectName, entry.slotName, entry.params));
+        else
+            peer->dispatch(RpcCall(entry.slotName, entry.params));
+    }
+    return count;
+}
+
+
+void SessionJournal::setPeer(Peer *peer)
+{
+    _peer = peer;
+    _detachedSince = peer ? QDateTime() : QDateTime::currentDateTime();
+}
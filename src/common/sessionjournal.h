@@ -0,0 +1,85 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef SESSIONJOURNAL_H
+#define SESSIONJOURNAL_H
+
+#include <QDateTime>
+#include <QList>
+#include <QPointer>
+
+#include "protocol.h"
+
+class Peer;
+
+//! Bounded record of the sync calls and RPCs sent to a client
+/** Messages are numbered consecutively, starting with 1 for the first message after the session state.
+ *  A client that lost its connection presents the number of the last message it has handled, and gets
+ *  the ones it missed replayed instead of having to synchronize its whole state again. Only the most
+ *  recent maxEntries messages are kept; if older ones are needed, the client has to start over.
+ *
+ *  Journals are filled by the SignalProxy (\sa SignalProxy::setJournal()).
+ */
+class SessionJournal
+{
+public:
+    SessionJournal(const QByteArray &token, int maxEntries = 10000);
+
+    inline QByteArray token() const { return _token; }
+
+    //! The number of the most recently recorded message
+    inline quint64 sequence() const { return _sequence; }
+
+    void append(const Protocol::SyncMessage &syncMessage);
+    void append(const Protocol::RpcCall &rpcCall);
+
+    //! Checks if all messages following lastSequence are still available
+    bool canReplayFrom(quint64 lastSequence) const;
+
+    //! Sends all messages following lastSequence to the given peer, returning their number
+    int replay(Peer *peer, quint64 lastSequence) const;
+
+    //! The peer the journal currently records for, or 0 while the client is away
+    inline Peer *peer() const { return _peer; }
+    void setPeer(Peer *peer);
+
+    //! The time the journal lost its peer; invalid while attached
+    inline QDateTime detachedSince() const { return _detachedSince; }
+
+private:
+    struct Entry {
+        bool isSync;
+        QByteArray className; // empty for RPCs
+        QString objectName;
+        QByteArray slotName;
+        QVariantList params;
+    };
+
+    void append(const Entry &entry);
+
+    QByteArray _token;
+    int _maxEntries;
+    quint64 _sequence;
+    QList<Entry> _entries; // the messages numbered (_sequence - _entries.count(), _sequence]
+    QPointer<Peer> _peer;
+    QDateTime _detachedSince;
+};
+
+#endif
@@ -30,8 +30,11 @@
 
 #include "signalproxy.h"
 
+#include "metrics.h"
 #include "peer.h"
 #include "protocol.h"
+#include "remotepeer.h"
+#include "sessionjournal.h"
 #include "syncableobject.h"
 #include "util.h"
 #include "types.h"
@@ -228,6 +231,7 @@ void SignalProxy::init()
     setHeartBeatInterval(30);
     setMaxHeartBeatCount(2);
     _secure = false;
+    _receivedSequence = 0;
     updateSecureState();
 }
 
@@ -332,6 +336,13 @@ void SignalProxy::removePeer(Peer *peer)
     peer->setSignalProxy(0);
 
     _peers.remove(peer);
+
+    SessionJournal *journal = _journals.take(peer);
+    if (journal) {
+        journal->setPeer(0);
+        _detachedJournals.insert(journal);
+    }
+
     emit peerRemoved(peer);
 
     if (peer->parent() == this)
@@ -339,8 +350,11 @@ void SignalProxy::removePeer(Peer *peer)
 
     updateSecureState();
 
-    if (_peers.isEmpty())
+    if (_peers.isEmpty()) {
+        _initDataSnapshot.clear();
+        _snapshotQueue.clear();
         emit disconnected();
+    }
 }
 
 
@@ -366,6 +380,8 @@ void SignalProxy::renameObject(const SyncableObject *obj, const QString &newname
 void SignalProxy::objectRenamed(const QByteArray &classname, const QString &newname, const QString &oldname)
 {
     if (_syncSlave.contains(classname) && _syncSlave[classname].contains(oldname) && oldname != newname) {
+        if (_initDataSnapshot.contains(classname))
+            _initDataSnapshot[classname].remove(oldname);
         SyncableObject *obj = _syncSlave[classname][newname] = _syncSlave[classname].take(oldname);
         requestInit(obj);
     }
@@ -461,6 +477,83 @@ void SignalProxy::synchronize(SyncableObject *obj)
 }
 
 
+QVariantList SignalProxy::initDataSnapshot(const QList<SyncableObject *> &objects) const
+{
+    QVariantList snapshot;
+    foreach(SyncableObject *obj, objects) {
+        if (!obj)
+            continue;
+        snapshot << QByteArray(obj->syncMetaObject()->className()) << obj->objectName() << initData(obj);
+    }
+    return snapshot;
+}
+
+
+void SignalProxy::setInitDataSnapshot(const QVariantList &snapshot)
+{
+    _initDataSnapshot.clear();
+    for (int i = 0; i + 2 < snapshot.count(); i += 3)
+        _initDataSnapshot[snapshot[i].toByteArray()][snapshot[i+1].toString()] = snapshot[i+2].toMap();
+}
+
+
+void SignalProxy::applyInitDataSnapshot()
+{
+    QList<QPointer<SyncableObject> > queue = _snapshotQueue;
+    _snapshotQueue.clear();
+
+    foreach(SyncableObject *obj, queue) {
+        if (!obj || obj->isInitialized())
+            continue;
+
+        QByteArray className(obj->syncMetaObject()->className());
+        QHash<QByteArray, QHash<QString, QVariantMap> >::iterator classIter = _initDataSnapshot.find(className);
+        if (classIter != _initDataSnapshot.end() && classIter->contains(obj->objectName()))
+            setInitData(obj, classIter->take(obj->objectName()));
+        else // the snapshot was outdated in the meantime
+            dispatch(InitRequest(className, obj->objectName()));
+    }
+}
+
+
+void SignalProxy::setJournal(Peer *peer, SessionJournal *journal)
+{
+    if (!_peers.contains(peer)) {
+        qWarning() << Q_FUNC_INFO << "Unknown peer" << peer;
+        return;
+    }
+
+    removeJournal(journal);
+    removeJournal(_journals.value(peer));
+    _journals[peer] = journal;
+    journal->setPeer(peer);
+}
+
+
+void SignalProxy::removeJournal(SessionJournal *journal)
+{
+    if (!journal)
+        return;
+
+    _detachedJournals.remove(journal);
+    Peer *peer = journal->peer();
+    if (peer && _journals.value(peer) == journal)
+        _journals.remove(peer);
+    journal->setPeer(0);
+}
+
+
+void SignalProxy::requestPendingInitData()
+{
+    foreach(const ObjectId &objects, _syncSlave) {
+        foreach(SyncableObject *obj, objects) {
+            if (!obj->isInitialized())
+                requestInit(obj);
+        }
+    }
+}
+
+
 void SignalProxy::detachObject(QObject *obj)
 {
     detachSignals(obj);
@@ -503,12 +596,50 @@ void SignalProxy::stopSynchronize(SyncableObject *obj)
 }
 
 
+template<class T> static inline const char *messageTypeName();
+template<> inline const char *messageTypeName<SyncMessage>() { return "SyncMessage"; }
+template<> inline const char *messageTypeName<RpcCall>() { return "RpcCall"; }
+template<> inline const char *messageTypeName<InitRequest>() { return "InitRequest"; }
+template<> inline const char *messageTypeName<InitData>() { return "InitData"; }
+
+static inline void countMessage(const char *metric, Peer *peer, const char *type)
+{
+    if (Metrics::isEnabled()) {
+        RemotePeer *remotePeer = qobject_cast<RemotePeer *>(peer);
+        Metrics::increment(metric, Metrics::labels("protocol", remotePeer ? remotePeer->metricsProtocol() : QString("internal"), "type", type));
+    }
+}
+
+
+void SignalProxy::record(SessionJournal *journal, const SyncMessage &msg)
+{
+    journal->append(msg);
+}
+
+
+void SignalProxy::record(SessionJournal *journal, const RpcCall &msg)
+{
+    journal->append(msg);
+}
+
+
 template<class T>
 void SignalProxy::dispatch(const T &protoMessage)
 {
+    foreach (SessionJournal *journal, _detachedJournals)
+        record(journal, protoMessage);
+
     foreach (Peer *peer, _peers) {
-        if (peer->isOpen())
+        // record even if the peer is gone already, the client may come back for it
+        if (!_journals.isEmpty()) {
+            SessionJournal *journal = _journals.value(peer);
+            if (journal)
+                record(journal, protoMessage);
+        }
+        if (peer->isOpen()) {
             peer->dispatch(protoMessage);
+            countMessage("quassel_peer_messages_sent_total", peer, messageTypeName<T>());
+        }
         else
             QCoreApplication::postEvent(this, new ::RemovePeerEvent(peer));
     }
@@ -518,8 +649,16 @@ void SignalProxy::dispatch(const T &protoMessage)
 template<class T>
 void SignalProxy::dispatch(Peer *peer, const T &protoMessage)
 {
-    if (peer && peer->isOpen())
+    if (!_journals.isEmpty()) {
+        SessionJournal *journal = _journals.value(peer);
+        if (journal)
+            record(journal, protoMessage);
+    }
+
+    if (peer && peer->isOpen()) {
         peer->dispatch(protoMessage);
+        countMessage("quassel_peer_messages_sent_total", peer, messageTypeName<T>());
+    }
     else
         QCoreApplication::postEvent(this, new ::RemovePeerEvent(peer));
 }
@@ -527,7 +666,18 @@ void SignalProxy::dispatch(Peer *peer, const T &protoMessage)
 
 void SignalProxy::handle(Peer *peer, const SyncMessage &syncMessage)
 {
+    countMessage("quassel_peer_messages_received_total", peer, "SyncMessage");
+    if (proxyMode() == Client)
+        _receivedSequence++;
+
+    // the sync call has to be applied on top of the snapshotted state, not the other way around
+    if (!_snapshotQueue.isEmpty())
+        applyInitDataSnapshot();
+
     if (!_syncSlave.contains(syncMessage.className) || !_syncSlave[syncMessage.className].contains(syncMessage.objectName)) {
+        // the snapshot doesn't reflect this change, so the object will have to request its init data
+        if (_initDataSnapshot.contains(syncMessage.className))
+            _initDataSnapshot[syncMessage.className].remove(syncMessage.objectName);
         qWarning() << QString("no registered receiver for sync call: %1::%2 (objectName=\"%3\"). Params are:").arg(syncMessage.className, syncMessage.slotName, syncMessage.objectName)
                    << syncMessage.params;
         return;
@@ -564,7 +714,7 @@ void SignalProxy::handle(Peer *peer, const SyncMessage &syncMessage)
         if (eMeta->argTypes(receiverId).count() > 1)
             returnParams << syncMessage.params;
         returnParams << returnValue;
-        peer->dispatch(SyncMessage(syncMessage.className, syncMessage.objectName, eMeta->methodName(receiverId), returnParams));
+        dispatch(peer, SyncMessage(syncMessage.className, syncMessage.objectName, eMeta->methodName(receiverId), returnParams));
     }
 
     // send emit update signal
@@ -574,6 +724,8 @@ void SignalProxy::handle(Peer *peer, const SyncMessage &syncMessage)
 
 void SignalProxy::handle(Peer *peer, const InitRequest &initRequest)
 {
+    countMessage("quassel_peer_messages_received_total", peer, "InitRequest");
+
    if (!_syncSlave.contains(initRequest.className)) {
         qWarning() << "SignalProxy::handleInitRequest() received initRequest for unregistered Class:"
                    << initRequest.className;
@@ -587,13 +739,13 @@ void SignalProxy::handle(Peer *peer, const InitRequest &initRequest)
     }
 
     SyncableObject *obj = _syncSlave[initRequest.className][initRequest.objectName];
-    peer->dispatch(InitData(initRequest.className, initRequest.objectName, initData(obj)));
+    dispatch(peer, InitData(initRequest.className, initRequest.objectName, initData(obj)));
 }
 
 
 void SignalProxy::handle(Peer *peer, const InitData &initData)
 {
-    Q_UNUSED(peer)
+    countMessage("quassel_peer_messages_received_total", peer, "InitData");
 
     if (!_syncSlave.contains(initData.className)) {
         qWarning() << "SignalProxy::handleInitData() received initData for unregistered Class:"
@@ -614,6 +766,10 @@ void SignalProxy::handle(Peer *peer, const InitData &initData)
 
 void SignalProxy::handle(Peer *peer, const RpcCall &rpcCall)
 {
+    countMessage("quassel_peer_messages_received_total", peer, "RpcCall");
+    if (proxyMode() == Client)
+        _receivedSequence++;
+
     QObject *receiver;
     int methodId;
     SlotHash::const_iterator slot = _attachedSlots.constFind(rpcCall.slotName);
@@ -699,7 +855,16 @@ void SignalProxy::requestInit(SyncableObject *obj)
     if (proxyMode() == Server || obj->isInitialized())
         return;
 
-    dispatch(InitRequest(obj->syncMetaObject()->className(), obj->objectName()));
+    QByteArray className(obj->syncMetaObject()->className());
+    if (_initDataSnapshot.value(className).contains(obj->objectName())) {
+        // objects tend to get synchronized from within their constructor, so apply the data from the event loop
+        if (_snapshotQueue.isEmpty())
+            QMetaObject::invokeMethod(this, "applyInitDataSnapshot", Qt::QueuedConnection);
+        _snapshotQueue << obj;
+        return;
+    }
+
+    dispatch(InitRequest(className, obj->objectName()));
 }
 
 
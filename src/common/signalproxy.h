@@ -22,6 +22,7 @@
 #define SIGNALPROXY_H
 
 #include <QEvent>
+#include <QPointer>
 #include <QSet>
 
 #include "protocol.h"
@@ -29,6 +30,7 @@
 struct QMetaObject;
 
 class Peer;
+class SessionJournal;
 class SyncableObject;
 
 class SignalProxy : public QObject
@@ -67,6 +69,32 @@ public:
     void synchronize(SyncableObject *obj);
     void stopSynchronize(SyncableObject *obj);
 
+    //! Collects the init data of the given objects (\sa Protocol::SessionState::initDataSnapshot)
+    QVariantList initDataSnapshot(const QList<SyncableObject *> &objects) const;
+
+    //! Use init data that was sent ahead of time instead of requesting it for each object
+    /** Sync calls received before an object is synchronized make its snapshot outdated; such objects
+     *  request their init data as usual.
+     */
+    void setInitDataSnapshot(const QVariantList &snapshot);
+
+    //! Records the sync calls and RPCs sent to the peer in the given journal
+    /** If the peer is removed, the journal keeps recording broadcasts until it is given to another peer.
+     *  A journal is only ever attached to one peer; the previous one stops recording.
+     */
+    void setJournal(Peer *peer, SessionJournal *journal);
+    //! Stops recording in the journal, e.g. before it is deleted
+    void removeJournal(SessionJournal *journal);
+
+    //! The number of sync calls and RPCs received since the session state (client mode only)
+    /** This corresponds to the core's journal sequence (\sa SessionJournal).
+     */
+    inline quint64 receivedSequence() const { return _receivedSequence; }
+    inline void resetReceivedSequence() { _receivedSequence = 0; }
+
+    //! Requests the init data of all synchronized objects that are still waiting for it
+    void requestPendingInitData();
+
     class ExtendedMetaObject;
     ExtendedMetaObject *extendedMetaObject(const QMetaObject *meta) const;
     ExtendedMetaObject *createExtendedMetaObject(const QMetaObject *meta, bool checkConflicts = false);
@@ -77,6 +105,7 @@ public:
     void dumpProxyStats();
     void dumpSyncMap(SyncableObject *object);
     inline int peerCount() const { return _peers.size(); }
+    inline QSet<Peer *> peers() const { return _peers; }
 
 public slots:
     void detachObject(QObject *obj);
@@ -90,6 +119,7 @@ protected:
 
 private slots:
     void removePeerBySender();
+    void applyInitDataSnapshot();
     void objectRenamed(const QByteArray &classname, const QString &newname, const QString &oldname);
     void updateSecureState();
 
@@ -129,6 +159,12 @@ private:
     template<class T>
     void handle(Peer *, T) { Q_ASSERT(0); }
 
+    // only sync calls and RPCs are journaled
+    static void record(SessionJournal *journal, const Protocol::SyncMessage &msg);
+    static void record(SessionJournal *journal, const Protocol::RpcCall &msg);
+    template<class T>
+    static inline void record(SessionJournal *, const T &) {}
+
     bool invokeSlot(QObject *receiver, int methodId, const QVariantList &params, QVariant &returnValue, Peer *peer = 0);
     bool invokeSlot(QObject *receiver, int methodId, const QVariantList &params = QVariantList(), Peer *peer = 0);
 
@@ -155,6 +191,15 @@ private:
     typedef QHash<QString, SyncableObject *> ObjectId;
     QHash<QByteArray, ObjectId> _syncSlave;
 
+    // init data received with the session state, and the objects waiting for it to be applied
+    QHash<QByteArray, QHash<QString, QVariantMap> > _initDataSnapshot;
+    QList<QPointer<SyncableObject> > _snapshotQueue;
+
+    // journals of resumable sessions; detached ones belong to clients that are currently away
+    QHash<Peer *, SessionJournal *> _journals;
+    QSet<SessionJournal *> _detachedJournals;
+    quint64 _receivedSequence;
+
     ProxyMode _proxyMode;
     int _heartBeatInterval;
     int _maxHeartBeatCount;
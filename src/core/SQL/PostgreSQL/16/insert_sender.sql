@@ -1,3 +0,0 @@
-INSERT INTO sender (sender)
-VALUES ($1)
-RETURNING senderid
@@ -1,2 +0,0 @@
-INSERT INTO sender (senderid, sender)
-VALUES (?, ?)
@@ -1,6 +0,0 @@
-SELECT messageid, time,  type, flags, sender, message
-FROM backlog
-LEFT JOIN sender ON backlog.senderid = sender.senderid
-WHERE bufferid = $1
-ORDER BY messageid DESC
-LIMIT $2
\ No newline at end of file
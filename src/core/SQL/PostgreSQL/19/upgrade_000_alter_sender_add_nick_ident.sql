@@ -0,0 +1 @@
+ALTER TABLE sender ADD COLUMN nick varchar(128), ADD COLUMN ident varchar(128)
@@ -0,0 +1,4 @@
+INSERT INTO senderhost (host)
+SELECT DISTINCT substr(sender, position('@' in sender) + 1)
+FROM sender
+WHERE position('!' in sender) > 0 AND position('@' in sender) > position('!' in sender) AND position('@' in sender) < length(sender)
@@ -0,0 +1 @@
+ALTER TABLE backlog ADD COLUMN hostid integer REFERENCES senderhost (hostid) ON DELETE SET NULL
@@ -0,0 +1,6 @@
+UPDATE backlog
+SET hostid = senderhost.hostid
+FROM sender, senderhost
+WHERE backlog.senderid = sender.senderid
+    AND position('!' in sender.sender) > 0 AND position('@' in sender.sender) > position('!' in sender.sender) AND position('@' in sender.sender) < length(sender.sender)
+    AND senderhost.host = substr(sender.sender, position('@' in sender.sender) + 1)
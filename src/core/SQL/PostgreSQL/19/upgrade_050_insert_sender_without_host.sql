@@ -0,0 +1,6 @@
+INSERT INTO sender (sender)
+SELECT substr(sender, 1, position('@' in sender) - 1)
+FROM sender
+WHERE position('!' in sender) > 0 AND position('@' in sender) > position('!' in sender) AND position('@' in sender) < length(sender)
+EXCEPT
+SELECT sender FROM sender
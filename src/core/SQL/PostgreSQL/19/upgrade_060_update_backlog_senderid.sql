@@ -0,0 +1,6 @@
+UPDATE backlog
+SET senderid = withouthost.senderid
+FROM sender, sender AS withouthost
+WHERE backlog.hostid IS NOT NULL
+    AND backlog.senderid = sender.senderid
+    AND withouthost.sender = substr(sender.sender, 1, position('@' in sender.sender) - 1)
@@ -0,0 +1,2 @@
+DELETE FROM sender
+WHERE position('!' in sender) > 0 AND position('@' in sender) > position('!' in sender) AND position('@' in sender) < length(sender)
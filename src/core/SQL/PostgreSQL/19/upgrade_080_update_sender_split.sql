@@ -0,0 +1,3 @@
+UPDATE sender
+SET nick = split_part(sender, '!', 1),
+    ident = CASE WHEN position('!' in sender) > 0 THEN substr(sender, position('!' in sender) + 1) END
@@ -0,0 +1,3 @@
+DELETE FROM backlog
+WHERE bufferid = $1
+    AND messageid <= $2
@@ -0,0 +1,3 @@
+INSERT INTO backlog (time, bufferid, type, flags, senderid, hostid, message, messagedata)
+VALUES ($1, $2, $3, $4, $5, $6, $7, $8)
+RETURNING messageid
@@ -0,0 +1,3 @@
+INSERT INTO backlog (messageid, time, bufferid, type, flags, senderid, hostid, message, messagedata)
+SELECT $1::integer, $2::timestamp, $3::integer, $4::integer, $5::integer, $6::integer, $7::integer, $8::text, $9::bytea
+WHERE NOT EXISTS (SELECT 1 FROM backlog WHERE messageid = $1::integer)
@@ -0,0 +1,3 @@
+INSERT INTO sender (sender, nick, ident)
+VALUES ($1, $2, $3)
+RETURNING senderid
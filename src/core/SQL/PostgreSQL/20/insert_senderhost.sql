@@ -0,0 +1,3 @@
+INSERT INTO senderhost (host)
+VALUES ($1)
+RETURNING hostid
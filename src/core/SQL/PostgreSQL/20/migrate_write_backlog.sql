@@ -1,2 +1,2 @@
-INSERT INTO backlog (messageid, time, bufferid, type, flags, senderid, message)
-VALUES (?, ?, ?, ?, ?, ?, ?)
+INSERT INTO backlog (messageid, time, bufferid, type, flags, senderid, hostid, message)
+VALUES (?, ?, ?, ?, ?, ?, ?, ?)
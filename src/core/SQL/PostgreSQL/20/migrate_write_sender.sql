@@ -0,0 +1,2 @@
+INSERT INTO sender (senderid, sender, nick, ident)
+VALUES (?, ?, ?, ?)
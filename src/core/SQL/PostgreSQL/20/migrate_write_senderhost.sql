@@ -0,0 +1,2 @@
+INSERT INTO senderhost (hostid, host)
+VALUES (?, ?)
@@ -0,0 +1,8 @@
+SELECT count(*), sum(CASE WHEN (backlog.flags & :highlightflag) = 0 THEN 0 ELSE 1 END)
+FROM backlog
+JOIN buffer ON backlog.bufferid = buffer.bufferid
+WHERE buffer.userid = :userid
+    AND backlog.bufferid = :bufferid
+    AND backlog.messageid > :lastseenmsgid
+    AND (backlog.type & :typemask) <> 0
+    AND (backlog.flags & :selfflag) = 0
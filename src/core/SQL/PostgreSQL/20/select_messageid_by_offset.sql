@@ -0,0 +1,5 @@
+SELECT messageid
+FROM backlog
+WHERE bufferid = $1
+ORDER BY messageid DESC
+LIMIT 1 OFFSET $2
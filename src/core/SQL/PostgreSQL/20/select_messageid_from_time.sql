@@ -0,0 +1,6 @@
+SELECT messageid
+FROM backlog
+WHERE bufferid = $1
+    AND time >= $2
+ORDER BY time ASC, messageid ASC
+LIMIT 1
@@ -1,6 +1,7 @@
-SELECT messageid, bufferid, time,  type, flags, sender, message
+SELECT messageid, bufferid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
 FROM backlog
 JOIN sender ON backlog.senderid = sender.senderid
+LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
 WHERE backlog.bufferid IN (SELECT bufferid FROM buffer WHERE userid = :userid)
     AND backlog.messageid >= :firstmsg
 ORDER BY messageid DESC
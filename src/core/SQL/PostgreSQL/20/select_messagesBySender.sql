@@ -0,0 +1,11 @@
+SELECT messageid, backlog.bufferid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
+FROM backlog
+JOIN sender ON backlog.senderid = sender.senderid
+LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
+JOIN buffer ON backlog.bufferid = buffer.bufferid
+WHERE lower(sender.nick) = lower($1)
+    AND buffer.userid = $2
+    AND ($3 = -1 OR backlog.bufferid = $3)
+    AND backlog.messageid < $4
+ORDER BY messageid DESC
+LIMIT $5
@@ -0,0 +1,7 @@
+SELECT messageid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
+FROM backlog
+LEFT JOIN sender ON backlog.senderid = sender.senderid
+LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
+WHERE backlog.messageid >= $1 AND bufferid = $2
+ORDER BY messageid DESC
+LIMIT $3
\ No newline at end of file
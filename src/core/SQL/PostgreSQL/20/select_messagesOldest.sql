@@ -0,0 +1,8 @@
+SELECT messageid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
+FROM backlog
+LEFT JOIN sender ON backlog.senderid = sender.senderid
+LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
+WHERE bufferid = $1
+    AND backlog.messageid < $2
+ORDER BY messageid ASC
+LIMIT $3
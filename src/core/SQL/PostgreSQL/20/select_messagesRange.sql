@@ -0,0 +1,9 @@
+SELECT messageid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
+FROM backlog
+LEFT JOIN sender ON backlog.senderid = sender.senderid
+LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
+WHERE backlog.messageid >= $1
+    AND backlog.messageid < $2
+    AND bufferid = $3
+ORDER BY messageid DESC
+LIMIT $4
\ No newline at end of file
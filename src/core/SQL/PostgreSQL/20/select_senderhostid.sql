@@ -0,0 +1,3 @@
+SELECT hostid
+FROM senderhost
+WHERE host = $1
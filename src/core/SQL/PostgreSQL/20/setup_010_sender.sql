@@ -0,0 +1,6 @@
+CREATE TABLE sender ( -- THE SENDER OF IRC MESSAGES, WITHOUT THE HOST
+       senderid serial NOT NULL PRIMARY KEY,
+       sender varchar(128) UNIQUE NOT NULL,
+       nick varchar(128),
+       ident varchar(128)
+)
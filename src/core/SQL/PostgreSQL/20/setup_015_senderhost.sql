@@ -0,0 +1,4 @@
+CREATE TABLE senderhost ( -- THE HOST PART OF SENDERS, SHARED BY ALL SENDERS ON THAT HOST
+       hostid serial NOT NULL PRIMARY KEY,
+       host varchar(128) UNIQUE NOT NULL
+)
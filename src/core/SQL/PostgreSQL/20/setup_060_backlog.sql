@@ -5,5 +5,7 @@ CREATE TABLE backlog (
 	type integer NOT NULL,
 	flags integer NOT NULL,
 	senderid integer NOT NULL REFERENCES sender (senderid) ON DELETE SET NULL,
-	message TEXT
+	hostid integer REFERENCES senderhost (hostid) ON DELETE SET NULL,
+	message TEXT,
+	messagedata bytea
 )
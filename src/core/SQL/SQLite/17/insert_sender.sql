@@ -1,2 +0,0 @@
-INSERT INTO sender (sender)
-VALUES (:sender)
\ No newline at end of file
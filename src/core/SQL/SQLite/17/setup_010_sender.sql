@@ -1,6 +0,0 @@
-CREATE TABLE sender ( -- THE SENDER OF IRC MESSAGES
-       senderid INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
-       sender TEXT UNIQUE NOT NULL
-)
-
-	  
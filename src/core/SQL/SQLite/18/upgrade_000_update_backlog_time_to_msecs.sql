@@ -0,0 +1 @@
+UPDATE backlog SET time = time * 1000
@@ -0,0 +1 @@
+ALTER TABLE sender ADD COLUMN nick TEXT COLLATE NOCASE
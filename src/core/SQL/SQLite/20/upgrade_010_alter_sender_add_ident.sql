@@ -0,0 +1 @@
+ALTER TABLE sender ADD COLUMN ident TEXT
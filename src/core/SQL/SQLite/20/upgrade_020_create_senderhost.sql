@@ -0,0 +1,4 @@
+CREATE TABLE senderhost ( -- THE HOST PART OF SENDERS, SHARED BY ALL SENDERS ON THAT HOST
+       hostid INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+       host TEXT UNIQUE NOT NULL
+)
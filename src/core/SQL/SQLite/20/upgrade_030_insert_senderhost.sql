@@ -0,0 +1,4 @@
+INSERT OR IGNORE INTO senderhost (host)
+SELECT substr(sender, instr(sender, '@') + 1)
+FROM sender
+WHERE instr(sender, '!') > 0 AND instr(sender, '@') > instr(sender, '!') AND instr(sender, '@') < length(sender)
@@ -0,0 +1 @@
+ALTER TABLE backlog ADD COLUMN hostid INTEGER
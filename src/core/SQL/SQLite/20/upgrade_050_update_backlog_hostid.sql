@@ -0,0 +1,6 @@
+UPDATE backlog
+SET hostid = (SELECT senderhost.hostid
+              FROM sender
+              JOIN senderhost ON senderhost.host = substr(sender.sender, instr(sender.sender, '@') + 1)
+              WHERE sender.senderid = backlog.senderid)
+WHERE senderid IN (SELECT senderid FROM sender WHERE instr(sender, '!') > 0 AND instr(sender, '@') > instr(sender, '!') AND instr(sender, '@') < length(sender))
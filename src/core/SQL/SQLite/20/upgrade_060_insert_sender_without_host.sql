@@ -0,0 +1,4 @@
+INSERT OR IGNORE INTO sender (sender)
+SELECT substr(sender, 1, instr(sender, '@') - 1)
+FROM sender
+WHERE instr(sender, '!') > 0 AND instr(sender, '@') > instr(sender, '!') AND instr(sender, '@') < length(sender)
@@ -0,0 +1,6 @@
+UPDATE backlog
+SET senderid = (SELECT withouthost.senderid
+                FROM sender
+                JOIN sender AS withouthost ON withouthost.sender = substr(sender.sender, 1, instr(sender.sender, '@') - 1)
+                WHERE sender.senderid = backlog.senderid)
+WHERE hostid IS NOT NULL
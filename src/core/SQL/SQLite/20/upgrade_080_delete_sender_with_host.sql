@@ -0,0 +1,2 @@
+DELETE FROM sender
+WHERE instr(sender, '!') > 0 AND instr(sender, '@') > instr(sender, '!') AND instr(sender, '@') < length(sender)
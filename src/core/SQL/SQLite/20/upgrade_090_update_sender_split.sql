@@ -0,0 +1,3 @@
+UPDATE sender
+SET nick = CASE WHEN instr(sender, '!') > 0 THEN substr(sender, 1, instr(sender, '!') - 1) ELSE sender END,
+    ident = CASE WHEN instr(sender, '!') > 0 THEN substr(sender, instr(sender, '!') + 1) END
@@ -0,0 +1,3 @@
+DELETE FROM backlog
+WHERE bufferid = :bufferid
+    AND messageid <= :lastmsg
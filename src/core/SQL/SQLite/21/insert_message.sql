@@ -0,0 +1,2 @@
+INSERT INTO backlog (time, bufferid, type, flags, senderid, hostid, message, messagedata)
+VALUES (:time, :bufferid, :type, :flags, (SELECT senderid FROM sender WHERE sender = :sender), (SELECT hostid FROM senderhost WHERE host = :host), :message, :messagedata)
@@ -0,0 +1,2 @@
+INSERT OR IGNORE INTO backlog (messageid, time, bufferid, type, flags, senderid, hostid, message, messagedata)
+VALUES (:messageid, :time, :bufferid, :type, :flags, (SELECT senderid FROM sender WHERE sender = :sender), (SELECT hostid FROM senderhost WHERE host = :host), :message, :messagedata)
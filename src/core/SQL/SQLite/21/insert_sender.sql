@@ -0,0 +1,2 @@
+INSERT INTO sender (sender, nick, ident)
+VALUES (:sender, :nick, :ident)
@@ -0,0 +1,4 @@
+SELECT messageid, time, bufferid, type, flags, senderid, hostid, message, messagedata
+FROM backlog
+WHERE messageid > ? AND messageid <= ?
+ORDER BY messageid ASC
@@ -0,0 +1,4 @@
+SELECT hostid, host
+FROM senderhost
+WHERE hostid > ? AND hostid <= ?
+ORDER BY hostid ASC
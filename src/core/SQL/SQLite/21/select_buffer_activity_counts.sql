@@ -0,0 +1,8 @@
+SELECT backlog.bufferid, count(*), sum(CASE WHEN (backlog.flags & :highlightflag) = 0 THEN 0 ELSE 1 END)
+FROM buffer
+JOIN backlog ON backlog.bufferid = buffer.bufferid
+WHERE buffer.userid = :userid
+    AND backlog.messageid > buffer.lastseenmsgid
+    AND (backlog.type & :typemask) <> 0
+    AND (backlog.flags & :selfflag) = 0
+GROUP BY backlog.bufferid
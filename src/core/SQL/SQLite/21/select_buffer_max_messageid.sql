@@ -0,0 +1,3 @@
+SELECT max(messageid)
+FROM backlog
+WHERE bufferid = :bufferid
@@ -0,0 +1,5 @@
+SELECT messageid
+FROM backlog
+WHERE bufferid = :bufferid
+ORDER BY messageid DESC
+LIMIT 1 OFFSET :offset
@@ -0,0 +1,6 @@
+SELECT messageid
+FROM backlog
+WHERE bufferid = :bufferid
+    AND time >= :time
+ORDER BY time ASC, messageid ASC
+LIMIT 1
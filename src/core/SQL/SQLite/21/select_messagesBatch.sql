@@ -0,0 +1,11 @@
+SELECT * FROM (
+    SELECT backlog.bufferid, messageid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
+    FROM backlog
+    JOIN sender ON backlog.senderid = sender.senderid
+    LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
+    WHERE backlog.bufferid = :bufferid
+        AND backlog.messageid >= :firstmsg
+        AND backlog.messageid < :lastmsg
+    ORDER BY messageid DESC
+    LIMIT ifnull(:limit, -1)
+)
@@ -0,0 +1,11 @@
+SELECT messageid, backlog.bufferid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
+FROM backlog
+JOIN sender ON backlog.senderid = sender.senderid
+LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
+JOIN buffer ON backlog.bufferid = buffer.bufferid
+WHERE sender.nick = :nick
+    AND buffer.userid = :userid
+    AND (:bufferid = -1 OR backlog.bufferid = :bufferid)
+    AND backlog.messageid < :lastmsg
+ORDER BY messageid DESC
+LIMIT :limit
@@ -0,0 +1,8 @@
+SELECT messageid, time,  type, flags, sender.sender || COALESCE('@' || senderhost.host, '') AS sender, message, messagedata
+FROM backlog
+JOIN sender ON backlog.senderid = sender.senderid
+LEFT JOIN senderhost ON backlog.hostid = senderhost.hostid
+WHERE bufferid = :bufferid
+    AND backlog.messageid < :lastmsg
+ORDER BY messageid ASC
+LIMIT :limit
@@ -0,0 +1,6 @@
+CREATE TABLE sender ( -- THE SENDER OF IRC MESSAGES, WITHOUT THE HOST
+       senderid INTEGER NOT NULL PRIMARY KEY AUTOINCREMENT,
+       sender TEXT UNIQUE NOT NULL,
+       nick TEXT COLLATE NOCASE,
+       ident TEXT
+)
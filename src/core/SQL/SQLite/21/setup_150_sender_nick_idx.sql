@@ -0,0 +1 @@
+CREATE INDEX sender_nick_idx ON sender(nick)
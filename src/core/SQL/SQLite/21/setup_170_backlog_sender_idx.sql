@@ -0,0 +1 @@
+CREATE INDEX backlog_sender_idx ON backlog(senderid)
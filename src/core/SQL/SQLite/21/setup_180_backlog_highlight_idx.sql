@@ -0,0 +1 @@
+CREATE INDEX backlog_highlight_idx ON backlog(messageid) WHERE (flags & 2) <> 0
@@ -22,6 +22,7 @@
 #include "quassel.h"
 
 #include "logger.h"
+#include "metrics.h"
 
 #include <QMutexLocker>
 #include <QSqlDriver>
@@ -29,10 +30,13 @@
 #include <QSqlField>
 #include <QSqlQuery>
 
+#include <limits>
+
 int AbstractSqlStorage::_nextConnectionId = 0;
 AbstractSqlStorage::AbstractSqlStorage(QObject *parent)
     : Storage(parent),
-    _schemaVersion(0)
+    _schemaVersion(0),
+    _compressContents(Quassel::isOptionSet("compress-backlog"))
 {
 }
 
@@ -150,10 +154,26 @@ QString AbstractSqlStorage::queryString(const QString &queryName, int version)
     QFile queryFile(queryInfo.filePath());
     if (!queryFile.open(QIODevice::ReadOnly | QIODevice::Text))
         return QString();
-    QString query = QTextStream(&queryFile).readAll();
+    QString query = QTextStream(&queryFile).readAll().trimmed();
     queryFile.close();
 
-    return query.trimmed();
+    if (Metrics::isEnabled()) {
+        QMutexLocker locker(&_queryNamesMutex);
+        _queryNames[query] = queryName;
+    }
+
+    return query;
+}
+
+
+void AbstractSqlStorage::recordQueryTime(const QSqlQuery &query, qint64 usecs)
+{
+    QString name;
+    {
+        QMutexLocker locker(&_queryNamesMutex);
+        name = _queryNames.value(query.lastQuery(), QLatin1String("other"));
+    }
+    Metrics::observe("quassel_storage_query_seconds", Metrics::labels("query", name), usecs);
 }
 
 
@@ -168,6 +188,74 @@ QStringList AbstractSqlStorage::setupQueries()
 }
 
 
+void AbstractSqlStorage::prepareMsgsBatchQuery(QSqlQuery &query, const QList<MsgRequest> &requests)
+{
+    Q_ASSERT(requests.count() <= maxMsgsBatchSize);
+
+    static const char *placeholders[] = { ":bufferid", ":firstmsg", ":lastmsg", ":limit" };
+    QString partQuery = queryString("select_messagesBatch");
+    QStringList parts;
+    for (int i = 0; i < requests.count(); i++) {
+        QString part = partQuery;
+        for (int p = 0; p < 4; p++)
+            part.replace(placeholders[p], QString("%1_%2").arg(placeholders[p]).arg(i));
+        parts << part;
+    }
+    query.prepare(parts.join("\nUNION ALL\n"));
+
+    for (int i = 0; i < requests.count(); i++) {
+        const MsgRequest &request = requests.at(i);
+        query.bindValue(QString(":bufferid_%1").arg(i), request.bufferId.toInt());
+        query.bindValue(QString(":firstmsg_%1").arg(i), request.first.toInt());
+        // last == -1 means no upper bound
+        query.bindValue(QString(":lastmsg_%1").arg(i), request.last == -1 ? std::numeric_limits<int>::max() : request.last.toInt());
+        // a NULL limit is treated as unlimited
+        query.bindValue(QString(":limit_%1").arg(i), request.limit < 0 ? QVariant(QVariant::Int) : QVariant(request.limit));
+    }
+}
+
+
+void AbstractSqlStorage::encodeContents(const QString &contents, QVariant &message, QVariant &messageData) const
+{
+    if (_compressContents && contents.size() >= minCompressedSize) {
+        QByteArray raw = contents.toUtf8();
+        QByteArray compressed = qCompress(raw);
+        // don't bother with contents that hardly compress, e.g. already encoded data
+        if (compressed.size() < raw.size() * 9 / 10) {
+            message = QVariant(QVariant::String);
+            messageData = compressed;
+            return;
+        }
+    }
+    message = contents;
+    messageData = QVariant(QVariant::ByteArray);
+}
+
+
+QString AbstractSqlStorage::decodeContents(const QVariant &message, const QVariant &messageData)
+{
+    if (messageData.isNull())
+        return message.toString();
+    return QString::fromUtf8(qUncompress(messageData.toByteArray()));
+}
+
+
+void AbstractSqlStorage::splitSender(const QString &sender, QString &senderWithoutHost, QString &host)
+{
+    // the schema upgrade splits existing senders the same way
+    int bang = sender.indexOf('!');
+    int at = sender.indexOf('@');
+    if (bang >= 0 && at > bang && at < sender.length() - 1) {
+        senderWithoutHost = sender.left(at);
+        host = sender.mid(at + 1);
+    }
+    else {
+        senderWithoutHost = sender;
+        host = QString();
+    }
+}
+
+
 bool AbstractSqlStorage::setup(const QVariantMap &settings)
 {
     setConnectionProperties(settings);
@@ -369,6 +457,8 @@ QString AbstractSqlMigrator::migrationObject(MigrationObject moType)
         return "QuasselUser";
     case Sender:
         return "Sender";
+    case SenderHost:
+        return "SenderHost";
     case Identity:
         return "Identity";
     case IdentityNick:
@@ -464,6 +554,10 @@ bool AbstractSqlMigrationReader::migrateTo(AbstractSqlMigrationWriter *writer)
     if (!transferMo(Sender, senderMo))
         return false;
 
+    SenderHostMO senderHostMo;
+    if (!transferMo(SenderHost, senderHostMo))
+        return false;
+
     BacklogMO backlogMo;
     if (!transferMo(Backlog, backlogMo))
         return false;
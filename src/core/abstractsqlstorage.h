@@ -55,11 +55,40 @@ protected:
 
     QStringList setupQueries();
 
+    //! Prepares a single query fetching the message ranges of all \p requests
+    /** The "select_messagesBatch" query is repeated for every request and combined with UNION ALL.
+     *  Callers must not pass more than maxMsgsBatchSize requests, as the backends limit the number of
+     *  compound terms and bound values per statement.
+     *  Result columns: bufferid, messageid, time, type, flags, sender, message, messagedata
+     */
+    void prepareMsgsBatchQuery(QSqlQuery &query, const QList<MsgRequest> &requests);
+    static const int maxMsgsBatchSize = 100;
+
+    //! Returns the values for the message and messagedata columns of the backlog
+    /** If backlog compression is enabled, long contents are stored zlib compressed in messagedata,
+     *  leaving message NULL. Short lines are always stored as plain text, since for them the
+     *  compression overhead eats up any savings.
+     */
+    void encodeContents(const QString &contents, QVariant &message, QVariant &messageData) const;
+    //! Returns the message contents stored in the message and messagedata columns
+    static QString decodeContents(const QVariant &message, const QVariant &messageData);
+    static const int minCompressedSize = 128;
+
+    //! Splits a sender into the part stored in the sender table and its host
+    /** Hosts are kept in a table of their own and referenced by each message, so a host change
+     *  doesn't create a new sender. The stored sender is "nick!ident" if the sender has a host,
+     *  otherwise the sender as it is; host is empty in the latter case.
+     */
+    static void splitSender(const QString &sender, QString &senderWithoutHost, QString &host);
+
     QStringList upgradeQueries(int ver);
     bool upgradeDb();
 
     bool watchQuery(QSqlQuery &query);
 
+    //! Records the execution time of a query under the name it was loaded with by queryString()
+    void recordQueryTime(const QSqlQuery &query, qint64 usecs);
+
     int schemaVersion();
     virtual int installedSchemaVersion() { return -1; };
     virtual bool updateSchemaVersion(int newVersion) = 0;
@@ -90,9 +119,14 @@ private:
 
     int _schemaVersion;
     bool _debug;
+    bool _compressContents;
 
     static int _nextConnectionId;
     QMutex _connectionPoolMutex;
+
+    // maps query strings back to their names, only filled while metrics are being recorded
+    QHash<QString, QString> _queryNames;
+    QMutex _queryNamesMutex;
     // we let a Connection Object manage each actual db connection
     // those objects reside in the thread the connection belongs to
     // which allows us thread safe termination of a connection
@@ -138,6 +172,12 @@ public:
         SenderMO() : senderId(0) {}
     };
 
+    struct SenderHostMO {
+        int hostId;
+        QString host;
+        SenderHostMO() : hostId(0) {}
+    };
+
     struct IdentityMO {
         IdentityId id;
         UserId userid;
@@ -217,6 +257,7 @@ public:
         int type;
         int flags;
         int senderid;
+        int hostid; // 0 if the sender has no host
         QString message;
     };
 
@@ -246,6 +287,7 @@ public:
     enum MigrationObject {
         QuasselUser,
         Sender,
+        SenderHost,
         Identity,
         IdentityNick,
         Network,
@@ -295,6 +337,7 @@ public:
     virtual bool readMo(NetworkMO &network) = 0;
     virtual bool readMo(BufferMO &buffer) = 0;
     virtual bool readMo(SenderMO &sender) = 0;
+    virtual bool readMo(SenderHostMO &senderHost) = 0;
     virtual bool readMo(BacklogMO &backlog) = 0;
     virtual bool readMo(IrcServerMO &ircserver) = 0;
     virtual bool readMo(UserSettingMO &userSetting) = 0;
@@ -320,6 +363,7 @@ public:
     virtual bool writeMo(const NetworkMO &network) = 0;
     virtual bool writeMo(const BufferMO &buffer) = 0;
     virtual bool writeMo(const SenderMO &sender) = 0;
+    virtual bool writeMo(const SenderHostMO &senderHost) = 0;
     virtual bool writeMo(const BacklogMO &backlog) = 0;
     virtual bool writeMo(const IrcServerMO &ircserver) = 0;
     virtual bool writeMo(const UserSettingMO &userSetting) = 0;
@@ -0,0 +1,62 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef BLOWFISH_H
+#define BLOWFISH_H
+
+#include <QByteArray>
+
+//! A plain Blowfish block cipher, as used by FiSH and mircryption.
+/** The key schedule is computed once in the constructor, so an instance should be kept around
+ *  for as long as the key doesn't change. Blocks are read and written big-endian, which makes the
+ *  output compatible with OpenSSL's (and thus QCA's) implementation.
+ */
+class Blowfish
+{
+public:
+    enum {
+        BlockSize = 8,
+        MaxKeyLength = 72
+    };
+
+    //! Sets up the key schedule. Keys longer than MaxKeyLength bytes are truncated.
+    explicit Blowfish(const QByteArray &key);
+
+    //! En- or decrypts data in ECB mode. The length of data must be a multiple of BlockSize.
+    QByteArray ecb(const QByteArray &data, bool encrypt) const;
+
+    //! En- or decrypts data in CBC mode with an all-zero IV. The length of data must be a multiple of BlockSize.
+    QByteArray cbc(const QByteArray &data, bool encrypt) const;
+
+    void encryptBlock(quint32 &left, quint32 &right) const;
+    void decryptBlock(quint32 &left, quint32 &right) const;
+
+private:
+    inline quint32 f(quint32 x) const
+    {
+        return ((_s[0][x >> 24] + _s[1][(x >> 16) & 0xff]) ^ _s[2][(x >> 8) & 0xff]) + _s[3][x & 0xff];
+    }
+
+    quint32 _p[18];
+    quint32 _s[4][256];
+};
+
+
+#endif
@@ -12,19 +12,28 @@
   Copyright (C) 2009 Johannes Huber <johu@gmx.de>
 */
 
+#include <QDebug>
+#include <QFile>
+
 #include "cipher.h"
 #include "logger.h"
 
 Cipher::Cipher()
+    : m_cbc(false)
 {
+#ifdef HAVE_QCA2
     m_primeNum = QCA::BigInteger("12745216229761186769575009943944198619149164746831579719941140425076456621824834322853258804883232842877311723249782818608677050956745409379781245497526069657222703636504651898833151008222772087491045206203033063108075098874712912417029101508315117935752962862335062591404043092163187352352197487303798807791605274487594646923");
+#endif
     setType("blowfish");
 }
 
 
 Cipher::Cipher(QByteArray key, QString cipherType)
+    : m_cbc(false)
 {
+#ifdef HAVE_QCA2
     m_primeNum = QCA::BigInteger("12745216229761186769575009943944198619149164746831579719941140425076456621824834322853258804883232842877311723249782818608677050956745409379781245497526069657222703636504651898833151008222772087491045206203033063108075098874712912417029101508315117935752962862335062591404043092163187352352197487303798807791605274487594646923");
+#endif
     setKey(key);
     setType(cipherType);
 }
@@ -37,6 +46,7 @@ bool Cipher::setKey(QByteArray key)
 {
     if (key.isEmpty()) {
         m_key.clear();
+        m_blowfish.reset();
         return false;
     }
 
@@ -59,6 +69,7 @@ bool Cipher::setKey(QByteArray key)
         m_cbc = false;
         m_key = key;
     }
+    m_blowfish.reset(new Blowfish(m_key));
     return true;
 }
 
@@ -149,6 +160,7 @@ QByteArray Cipher::decrypt(QByteArray cipherText)
 }
 
 
+#ifdef HAVE_QCA2
 QByteArray Cipher::initKeyExchange()
 {
     QCA::Initializer init;
@@ -247,6 +259,9 @@ bool Cipher::parseFinishKeyX(QByteArray key)
 }
 
 
+#endif
+
+
 QByteArray Cipher::decryptTopic(QByteArray cipherText)
 {
     if (cipherText.mid(0, 4) == "+OK ") // FiSH style topic
@@ -316,16 +331,22 @@ bool Cipher::encrypt(QByteArray &cipherText)
 //THE BELOW WORKS AKA DO NOT TOUCH UNLESS YOU KNOW WHAT YOU'RE DOING
 QByteArray Cipher::blowfishCBC(QByteArray cipherText, bool direction)
 {
-    QCA::Initializer init;
+    if (!m_blowfish)
+        return cipherText;
+
     QByteArray temp = cipherText;
     if (direction)
     {
         // make sure cipherText is an interval of 8 bits. We do this before so that we
-        // know there's at least 8 bytes to en/decryption this ensures QCA doesn't fail
+        // know there's at least 8 bytes to en/decryption
         while ((temp.length() % 8) != 0) temp.append('\0');
 
-        QCA::InitializationVector iv(8);
-        temp.prepend(iv.toByteArray()); // prefix with 8bits of IV for mircryptions *CUSTOM* cbc implementation
+        QByteArray iv = randomIV();
+        if (iv.isEmpty()) {
+            qWarning() << "Cipher: no secure random source available, refusing to encrypt in CBC mode";
+            return cipherText;
+        }
+        temp.prepend(iv); // prefix with 8bits of IV for mircryptions *CUSTOM* cbc implementation
     }
     else
     {
@@ -335,13 +356,8 @@ QByteArray Cipher::blowfishCBC(QByteArray cipherText, bool direction)
         while ((temp.length() % 8) != 0) temp.append('\0');
     }
 
-    QCA::Direction dir = (direction) ? QCA::Encode : QCA::Decode;
-    QCA::Cipher cipher(m_type, QCA::Cipher::CBC, QCA::Cipher::NoPadding, dir, m_key, QCA::InitializationVector(QByteArray("0")));
-    QByteArray temp2 = cipher.update(QCA::MemoryRegion(temp)).toByteArray();
-    temp2 += cipher.final().toByteArray();
-
-    if (!cipher.ok())
-        return cipherText;
+    // the IV is prepended to the message itself, so the cipher runs with a zero IV
+    QByteArray temp2 = m_blowfish->cbc(temp, direction);
 
     if (direction) //send in base64
         temp2 = temp2.toBase64();
@@ -354,7 +370,9 @@ QByteArray Cipher::blowfishCBC(QByteArray cipherText, bool direction)
 
 QByteArray Cipher::blowfishECB(QByteArray cipherText, bool direction)
 {
-    QCA::Initializer init;
+    if (!m_blowfish)
+        return cipherText;
+
     QByteArray temp = cipherText;
 
     //do padding ourselves
@@ -368,13 +386,7 @@ QByteArray Cipher::blowfishECB(QByteArray cipherText, bool direction)
         while ((temp.length() % 8) != 0) temp.append('\0');
     }
 
-    QCA::Direction dir = (direction) ? QCA::Encode : QCA::Decode;
-    QCA::Cipher cipher(m_type, QCA::Cipher::ECB, QCA::Cipher::NoPadding, dir, m_key);
-    QByteArray temp2 = cipher.update(QCA::MemoryRegion(temp)).toByteArray();
-    temp2 += cipher.final().toByteArray();
-
-    if (!cipher.ok())
-        return cipherText;
+    QByteArray temp2 = m_blowfish->ecb(temp, direction);
 
     if (direction)
         temp2 = byteToB64(temp2);
@@ -476,12 +488,47 @@ QByteArray Cipher::b64ToByte(QByteArray text)
 }
 
 
-bool Cipher::neededFeaturesAvailable()
+QByteArray Cipher::randomIV()
+{
+#ifdef HAVE_QCA2
+    QCA::Initializer init;
+    if (QCA::isSupported("random"))
+        return QCA::InitializationVector(Blowfish::BlockSize).toByteArray();
+#endif
+    // predictable IVs weaken CBC, so only use the system's secure random source
+    QFile urandom("/dev/urandom");
+    if (!urandom.open(QIODevice::ReadOnly | QIODevice::Unbuffered))
+        return QByteArray();
+    QByteArray iv = urandom.read(Blowfish::BlockSize);
+    if (iv.length() != Blowfish::BlockSize)
+        return QByteArray();
+    return iv;
+}
+
+
+int Cipher::maxPlainLength(const QByteArray &message, int maxLength) const
+{
+    if (message.startsWith("+p ")) // sent in the clear, see encrypt()
+        return maxLength + 3;
+
+    int blocks;
+    if (m_cbc)
+        blocks = (maxLength - 5) / 4 * 3 / Blowfish::BlockSize - 1;
+    else
+        blocks = (maxLength - 4) / 12;
+
+    return qMax(blocks, 0) * Blowfish::BlockSize;
+}
+
+
+bool Cipher::keyExchangeAvailable()
 {
+#ifdef HAVE_QCA2
     QCA::Initializer init;
 
-    if (QCA::isSupported("blowfish-ecb") && QCA::isSupported("blowfish-cbc") && QCA::isSupported("dh"))
+    if (QCA::isSupported("dh"))
         return true;
+#endif
 
     return false;
 }
@@ -15,7 +15,13 @@
 #ifndef CIPHER_H
 #define CIPHER_H
 
-#include <QtCrypto>
+#include <QScopedPointer>
+
+#ifdef HAVE_QCA2
+#  include <QtCrypto>
+#endif
+
+#include "blowfish.h"
 
 class Cipher
 {
@@ -26,29 +32,39 @@ public:
     QByteArray decrypt(QByteArray cipher);
     QByteArray decryptTopic(QByteArray cipher);
     bool encrypt(QByteArray &cipher);
+#ifdef HAVE_QCA2
     QByteArray initKeyExchange();
     QByteArray parseInitKeyX(QByteArray key);
     bool parseFinishKeyX(QByteArray key);
+#endif
     bool setKey(QByteArray key);
     QByteArray key() { return m_key; }
     bool setType(const QString &type);
     QString type() { return m_type; }
-    static bool neededFeaturesAvailable();
+    //! DH1080 key exchange needs QCA with a provider plugin; en- and decryption work without
+    static bool keyExchangeAvailable();
     inline bool usesCBC() { return m_cbc; }
 
+    //! How many leading bytes of message can be sent such that the encrypted line fits into maxLength bytes
+    int maxPlainLength(const QByteArray &message, int maxLength) const;
+
 private:
     //direction is true for encrypt, false for decrypt
     QByteArray blowfishCBC(QByteArray cipherText, bool direction);
     QByteArray blowfishECB(QByteArray cipherText, bool direction);
+    static QByteArray randomIV();
     QByteArray b64ToByte(QByteArray text);
     QByteArray byteToB64(QByteArray text);
 
-    QCA::Initializer init;
     QByteArray m_key;
-    QCA::DHPrivateKey m_tempKey;
-    QCA::BigInteger m_primeNum;
+    QScopedPointer<Blowfish> m_blowfish; // key schedule for m_key
     QString m_type;
     bool m_cbc;
+#ifdef HAVE_QCA2
+    QCA::Initializer init;
+    QCA::DHPrivateKey m_tempKey;
+    QCA::BigInteger m_primeNum;
+#endif
 };
 
 
@@ -19,13 +19,17 @@
  ***************************************************************************/
 
 #include <QCoreApplication>
+#include <QMutexLocker>
 
 #include "core.h"
+#include "abstractcliparser.h"
 #include "coreauthhandler.h"
+#include "corebacklogpruner.h"
 #include "coresession.h"
 #include "coresettings.h"
 #include "logger.h"
 #include "internalpeer.h"
+#include "metricsserver.h"
 #include "network.h"
 #include "postgresqlstorage.h"
 #include "quassel.h"
@@ -81,9 +85,43 @@ void Core::destroy()
 }
 
 
+void Core::addCliOptions(AbstractCliParser *cliParser)
+{
+    cliParser->addOption("listen <address>[,<address[,...]]>", 0, "The address(es) quasselcore will listen on", "::,0.0.0.0");
+    cliParser->addOption("port <port>", 'p', "The port quasselcore will listen at", QString("4242"));
+    cliParser->addSwitch("norestore", 'n', "Don't restore last core's state");
+    cliParser->addOption("restore-concurrency <count>", 0, "Number of user sessions restored in parallel on startup", QString("4"));
+    cliParser->addOption("backlog-cache-depth <count>", 0, "Number of recent messages per buffer kept in memory to answer backlog requests (0 disables the cache)", QString("500"));
+    cliParser->addOption("backlog-cache-memory <MB>", 0, "Memory limit of the recent message cache per user session", QString("32"));
+    cliParser->addOption("backlog-max-age <days>", 0, "Remove messages older than this from the backlog (0 keeps them, users may override this)", QString("0"));
+    cliParser->addOption("backlog-max-count <count>", 0, "Keep at most this many messages per buffer (0 keeps all, users may override this)", QString("0"));
+    cliParser->addOption("backlog-archive-dir <path>", 0, "Save messages removed from the backlog as compressed archives in this directory");
+    cliParser->addOption("restore-backlog-archive <file>", 0, "Load the messages of a backlog archive back into the storage");
+    cliParser->addSwitch("compress-backlog", 0, "Store long messages compressed in the backlog (compressed messages can always be read)");
+    cliParser->addOption("metrics-port <port>", 0, "Serve core metrics in the Prometheus text format on this port (localhost only)");
+    cliParser->addOption("loglevel <level>", 'L', "Loglevel Debug|Info|Warning|Error", "Info");
+#ifdef HAVE_SYSLOG
+    cliParser->addSwitch("syslog", 0, "Log to syslog");
+#endif
+    cliParser->addOption("logfile <path>", 'l', "Log to a file");
+    cliParser->addOption("select-backend <backendidentifier>", 0, "Switch storage backend (migrating data if possible)");
+    cliParser->addSwitch("add-user", 0, "Starts an interactive session to add a new core user");
+    cliParser->addOption("change-userpass <username>", 0, "Starts an interactive session to change the password of the user identified by username");
+    cliParser->addSwitch("oidentd", 0, "Enable oidentd integration");
+    cliParser->addOption("oidentd-conffile <file>", 0, "Set path to oidentd configuration file");
+#ifdef HAVE_SSL
+    cliParser->addSwitch("require-ssl", 0, "Require SSL for client connections");
+#endif
+    cliParser->addSwitch("enable-experimental-dcc", 0, "Enable highly experimental and unfinished support for CTCP DCC (DANGEROUS)");
+}
+
+
 Core::Core()
     : QObject(),
-      _storage(0)
+      _storage(0),
+      _sessionsToRestore(0),
+      _restoredSessions(0),
+      _nextNetworkConnect(0)
 {
 #ifdef HAVE_UMASK
     umask(S_IRWXG | S_IRWXO);
@@ -207,12 +245,19 @@ void Core::init()
         exit(0);
     }
 
+    if (Quassel::isOptionSet("restore-backlog-archive")) {
+        exit(restoreBacklogArchive(Quassel::optionValue("restore-backlog-archive")) ? 0 : 1);
+    }
+
     connect(&_server, SIGNAL(newConnection()), this, SLOT(incomingConnection()));
     connect(&_v6server, SIGNAL(newConnection()), this, SLOT(incomingConnection()));
     if (!startListening()) exit(1);  // TODO make this less brutal
 
     if (Quassel::isOptionSet("oidentd"))
         _oidentdConfigGenerator = new OidentdConfigGenerator(this);
+
+    if (Quassel::isOptionSet("metrics-port"))
+        new MetricsServer(Quassel::optionValue("metrics-port").toUInt(), this);
 }
 
 
@@ -235,6 +280,8 @@ void Core::saveState()
     QVariantMap state;
     QVariantList activeSessions;
     foreach(UserId user, instance()->sessions.keys()) activeSessions << QVariant::fromValue<UserId>(user);
+    // sessions still waiting to be restored are active, too
+    foreach(UserId user, instance()->_pendingRestores) activeSessions << QVariant::fromValue<UserId>(user);
     state["CoreStateVersion"] = 1;
     state["ActiveSessions"] = activeSessions;
     s.setCoreState(state);
@@ -265,12 +312,54 @@ void Core::restoreState()
         quInfo() << "Restoring previous core state...";
         foreach(QVariant v, activeSessions) {
             UserId user = v.value<UserId>();
-            instance()->createSession(user, true);
+            if (!instance()->_pendingRestores.contains(user))
+                instance()->_pendingRestores << user;
         }
+        instance()->_sessionsToRestore = instance()->_pendingRestores.count();
+        instance()->_restoredSessions = 0;
+        instance()->restoreNextSessions();
     }
 }
 
 
+void Core::restoreNextSessions()
+{
+    int concurrency = Quassel::optionValue("restore-concurrency").toInt();
+    if (concurrency < 1)
+        concurrency = 1;
+
+    while (_restoreTimers.count() < concurrency && !_pendingRestores.isEmpty())
+        createSession(_pendingRestores.takeFirst(), true);
+}
+
+
+void Core::sessionRestored()
+{
+    SessionThread *sess = qobject_cast<SessionThread *>(sender());
+    if (!sess || !_restoreTimers.contains(sess->user()))
+        return;
+
+    int elapsed = _restoreTimers.take(sess->user()).elapsed();
+    _restoredSessions++;
+    quInfo() << qPrintable(tr("Restored session for user %1 in %2 ms (%3 of %4)")
+                           .arg(sess->user().toInt()).arg(elapsed).arg(_restoredSessions).arg(_sessionsToRestore));
+    if (_restoredSessions == _sessionsToRestore)
+        quInfo() << "Core state restored.";
+
+    restoreNextSessions();
+}
+
+
+int Core::networkConnectDelay()
+{
+    QMutexLocker locker(&instance()->_networkConnectMutex);
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    qint64 slot = qMax(now, instance()->_nextNetworkConnect);
+    instance()->_nextNetworkConnect = slot + networkConnectInterval;
+    return slot - now;
+}
+
+
 /*** Core Setup ***/
 
 QString Core::setup(const QString &adminUser, const QString &adminPassword, const QString &backend, const QVariantMap &setupData)
@@ -585,7 +674,8 @@ void Core::setupClientSession(RemotePeer *peer, UserId uid)
         session = sessions[uid];
     }
     else {
-        session = createSession(uid);
+        // if the user's session is still waiting to be restored, do it right away
+        session = createSession(uid, _pendingRestores.removeAll(uid) > 0);
         if (!session) {
             qWarning() << qPrintable(tr("Could not initialize session for client:")) << qPrintable(peer->description());
             peer->close();
@@ -650,7 +740,7 @@ void Core::setupInternalClientSession(InternalPeer *clientPeer)
     if (sessions.contains(uid))
         sessionThread = sessions[uid];
     else
-        sessionThread = createSession(uid);
+        sessionThread = createSession(uid, _pendingRestores.removeAll(uid) > 0);
 
     sessionThread->addClient(corePeer);
 }
@@ -664,6 +754,10 @@ SessionThread *Core::createSession(UserId uid, bool restore)
     }
     SessionThread *sess = new SessionThread(uid, restore, this);
     sessions[uid] = sess;
+    if (restore) {
+        _restoreTimers[uid].start();
+        connect(sess, SIGNAL(initialized()), this, SLOT(sessionRestored()));
+    }
     sess->start();
     return sess;
 }
@@ -845,6 +939,24 @@ void Core::changeUserPass(const QString &username)
 }
 
 
+bool Core::restoreBacklogArchive(const QString &fileName)
+{
+    if (!_configured) {
+        qWarning() << "Core is not configured, cannot restore backlog!";
+        return false;
+    }
+
+    QTextStream out(stdout);
+    int count = CoreBacklogPruner::restoreArchive(fileName);
+    if (count < 0) {
+        qWarning() << "Failed to restore backlog archive" << qPrintable(fileName);
+        return false;
+    }
+    out << "Restored " << count << " messages from " << fileName << endl;
+    return true;
+}
+
+
 AbstractSqlMigrationReader *Core::getMigrationReader(Storage *storage)
 {
     if (!storage)
@@ -22,7 +22,9 @@
 #define CORE_H
 
 #include <QDateTime>
+#include <QMutex>
 #include <QString>
+#include <QTime>
 #include <QVariant>
 #include <QTimer>
 
@@ -41,6 +43,7 @@
 #include "storage.h"
 #include "types.h"
 
+class AbstractCliParser;
 class CoreAuthHandler;
 class CoreSession;
 struct NetworkInfo;
@@ -61,6 +64,9 @@ public:
     static void saveState();
     static void restoreState();
 
+    //! Registers the core-only command line options, for quasselcore, the monolithic client and the benchmarks
+    static void addCliOptions(AbstractCliParser *cliParser);
+
     /*** Storage access ***/
     // These methods are threadsafe.
 
@@ -352,6 +358,30 @@ public:
     }
 
 
+    //! Request messages for several buffers at once
+    /** \param requests The per-buffer ranges to fetch (\sa Storage::MsgRequest)
+     *  \return The requested messages of all buffers
+     */
+    static inline QList<Message> requestMsgsMulti(UserId user, const QList<Storage::MsgRequest> &requests)
+    {
+        return instance()->_storage->requestMsgsMulti(user, requests);
+    }
+
+
+    //! Request messages of a buffer around a point in time
+    /** \param time     The point in time
+     *  \param first    if != -1 split at this MsgId instead of the first message at \p time
+     *  \param last     if != -1 return only messages with a MsgId < last
+     *  \param before   Max amount of messages before the split
+     *  \param after    Max amount of messages from the split on, -1 for all of them
+     *  \return The requested list of messages, newest first
+     */
+    static inline QList<Message> requestMsgsByTime(UserId user, BufferId bufferId, const QDateTime &time, MsgId first = -1, MsgId last = -1, int before = 0, int after = -1)
+    {
+        return instance()->_storage->requestMsgsByTime(user, bufferId, time, first, last, before, after);
+    }
+
+
     //! Request a certain number of messages across all buffers
     /** \param first    if != -1 return only messages with a MsgId >= first
      *  \param last     if != -1 return only messages with a MsgId < last
@@ -364,6 +394,71 @@ public:
     }
 
 
+    //! Request the most recent highlighted messages across all buffers
+    /** \param first    if != -1 return only messages with a MsgId >= first
+     *  \param limit    Max amount of messages
+     *  \return The requested list of messages, newest first
+     */
+    static inline QList<Message> requestHighlightMsgs(UserId user, MsgId first = -1, int limit = -1)
+    {
+        return instance()->_storage->requestHighlightMsgs(user, first, limit);
+    }
+
+
+    //! Request the messages sent by a nick
+    /** \param bufferId if valid return only messages of this buffer, otherwise of all buffers
+     *  \param last     if != -1 return only messages with a MsgId < last
+     *  \param limit    Max amount of messages
+     *  \return The requested list of messages, newest first
+     */
+    static inline QList<Message> requestMsgsBySender(UserId user, BufferId bufferId, const QString &nick, MsgId last = -1, int limit = -1)
+    {
+        return instance()->_storage->requestMsgsBySender(user, bufferId, nick, last, limit);
+    }
+
+
+    //! Find the oldest message of a buffer that is still to be kept
+    /** \param minTime   Keep only messages at or after this time, invalid for no age limit
+     *  \param maxCount  Keep only the newest \p maxCount messages, 0 for no count limit
+     *  \return Messages with a MsgId < the returned one are expired; an invalid MsgId if none are
+     */
+    static inline MsgId expiredMsgsBoundary(UserId user, BufferId bufferId, const QDateTime &minTime, int maxCount)
+    {
+        return instance()->_storage->expiredMsgsBoundary(user, bufferId, minTime, maxCount);
+    }
+
+
+    //! Request the oldest messages of a buffer
+    /** \param last     Return only messages with a MsgId < last
+     *  \param limit    Max amount of messages to return
+     *  \return The requested messages, oldest first
+     */
+    static inline QList<Message> requestExpiredMsgs(UserId user, BufferId bufferId, MsgId last, int limit)
+    {
+        return instance()->_storage->requestExpiredMsgs(user, bufferId, last, limit);
+    }
+
+
+    //! Remove the oldest messages of a buffer
+    /** \param last     Remove all messages with a MsgId <= last
+     *  \return true on success
+     */
+    static inline bool deleteMsgsUntil(UserId user, BufferId bufferId, MsgId last)
+    {
+        return instance()->_storage->deleteMsgsUntil(user, bufferId, last);
+    }
+
+
+    //! Store previously pruned messages again, keeping their MsgIds
+    /** \param msgs     The messages to restore
+     *  \return true on success
+     */
+    static inline bool restoreMsgs(UserId user, BufferId bufferId, const QList<Message> &msgs)
+    {
+        return instance()->_storage->restoreMsgs(user, bufferId, msgs);
+    }
+
+
     //! Request a list of all buffers known to a user.
     /** This method is used to get a list of all buffers we have stored a backlog from.
      *  \note This method is threadsafe.
@@ -482,6 +577,31 @@ public:
     }
 
 
+    //! Count the unread messages in all buffers of a user
+    /** \note This method is threadsafe.
+     *
+     * \param user      The Owner of the buffers
+     * \return The counts of all buffers that have unread messages
+     */
+    static inline QHash<BufferId, Storage::ActivityCount> bufferActivityCounts(UserId user)
+    {
+        return instance()->_storage->bufferActivityCounts(user);
+    }
+
+
+    //! Count the unread messages in a buffer
+    /** \note This method is threadsafe.
+     *
+     * \param user          The Owner of that Buffer
+     * \param bufferId      The buffer id
+     * \param lastSeenMsgId Messages after this one are unread
+     */
+    static inline Storage::ActivityCount bufferActivityCount(UserId user, BufferId bufferId, MsgId lastSeenMsgId)
+    {
+        return instance()->_storage->bufferActivityCount(user, bufferId, lastSeenMsgId);
+    }
+
+
     static inline QDateTime startTime() { return instance()->_startTime; }
     static inline bool isConfigured() { return instance()->_configured; }
     static bool sslSupported();
@@ -491,6 +611,14 @@ public:
 
     static inline QTimer &syncTimer() { return instance()->_storageSyncTimer; }
 
+    //! Reserve a slot for connecting a network to IRC
+    /** Network connects of all sessions are spaced out by networkConnectInterval, so restoring
+     *  many sessions at once doesn't hit all IRC servers at the same time.
+     *  \note This method is threadsafe.
+     *  \return The delay in milliseconds after which the network may connect
+     */
+    static int networkConnectDelay();
+
     inline OidentdConfigGenerator *oidentdConfigGenerator() const { return _oidentdConfigGenerator; }
 
     static const int AddClientEventId;
@@ -524,6 +652,8 @@ private slots:
     void socketError(QAbstractSocket::SocketError err, const QString &errorString);
     void setupClientSession(RemotePeer *, UserId);
 
+    void sessionRestored();
+
 private:
     Core();
     ~Core();
@@ -531,6 +661,7 @@ private:
     static Core *instanceptr;
 
     SessionThread *createSession(UserId userId, bool restoreState = false);
+    void restoreNextSessions();
     void addClientHelper(RemotePeer *peer, UserId uid);
     //void processCoreSetup(QTcpSocket *socket, QVariantMap &msg);
     QString setupCoreForInternalUsage();
@@ -542,6 +673,7 @@ private:
     bool selectBackend(const QString &backend);
     void createUser();
     void changeUserPass(const QString &username);
+    bool restoreBacklogArchive(const QString &fileName);
     void saveBackendSettings(const QString &backend, const QVariantMap &settings);
     QVariantMap promptForSettings(const Storage *storage);
 
@@ -549,6 +681,16 @@ private:
     QSet<CoreAuthHandler *> _connectingClients;
     QHash<UserId, SessionThread *> sessions;
     Storage *_storage;
+
+    // Sessions are restored with bounded concurrency; users with connecting clients jump the queue
+    QList<UserId> _pendingRestores;
+    QHash<UserId, QTime> _restoreTimers;
+    int _sessionsToRestore;
+    int _restoredSessions;
+
+    static const int networkConnectInterval = 200;
+    QMutex _networkConnectMutex;
+    qint64 _nextNetworkConnect;
     QTimer _storageSyncTimer;
 
 #ifdef HAVE_SSL
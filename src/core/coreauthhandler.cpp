@@ -152,6 +152,8 @@ bool CoreAuthHandler::checkClientRegistered()
 
 void CoreAuthHandler::handle(const RegisterClient &msg)
 {
+    _peer->setFeatures(Quassel::Features(msg.clientFeatures));
+
     bool useSsl;
     if (_legacy)
         useSsl = Core::sslSupported() && msg.sslSupported;
@@ -204,6 +206,9 @@ void CoreAuthHandler::handle(const Login &msg)
     }
     _peer->dispatch(LoginSuccess());
 
+    // the session decides whether it can be resumed, but only ever for an authenticated user
+    _peer->setResumeInfo(msg.resumeToken, msg.lastSequence);
+
     quInfo() << qPrintable(tr("Client %1 initialized and authenticated successfully as \"%2\" (UserId: %3).").arg(socket()->peerAddress().toString(), msg.user, QString::number(uid.toInt())));
 
     disconnect(socket(), 0, this, 0);
@@ -36,7 +36,8 @@ QVariantList CoreBacklogManager::requestBacklog(BufferId bufferId, MsgId first,
 {
     QVariantList backlog;
     QList<Message> msgList;
-    msgList = Core::requestMsgs(coreSession()->user(), bufferId, first, last, limit);
+    if (!coreSession()->messageCache()->requestMsgs(bufferId, first, last, limit, msgList))
+        msgList = Core::requestMsgs(coreSession()->user(), bufferId, first, last, limit);
 
     QList<Message>::const_iterator msgIter = msgList.constBegin();
     QList<Message>::const_iterator msgListEnd = msgList.constEnd();
@@ -115,3 +116,98 @@ QVariantList CoreBacklogManager::requestBacklogAll(MsgId first, MsgId last, int
 
     return backlog;
 }
+
+
+QVariantList CoreBacklogManager::requestBacklogMulti(const QVariantList &requests)
+{
+    QVariantList backlog;
+
+    QList<Storage::MsgRequest> msgRequests;
+    QHash<BufferId, int> additionalMsgs;
+    foreach(const QVariant &v, requests) {
+        QVariantList request = v.toList();
+        if (request.count() != 5) {
+            qWarning() << "CoreBacklogManager::requestBacklogMulti(): ignoring malformed request" << request;
+            continue;
+        }
+        Storage::MsgRequest msgRequest(request[0].value<BufferId>(), request[1].value<MsgId>(), request[2].value<MsgId>(), request[3].toInt());
+        msgRequests << msgRequest;
+        if (request[4].toInt() && msgRequest.limit != 0)
+            additionalMsgs[msgRequest.bufferId] = request[4].toInt();
+    }
+
+    // answer what we can from the recent message cache, the rest goes to the storage in one go
+    QList<Message> msgList;
+    QList<Storage::MsgRequest> storageRequests;
+    foreach(const Storage::MsgRequest &msgRequest, msgRequests) {
+        QList<Message> cached;
+        if (coreSession()->messageCache()->requestMsgs(msgRequest.bufferId, msgRequest.first, msgRequest.last, msgRequest.limit, cached))
+            msgList << cached;
+        else
+            storageRequests << msgRequest;
+    }
+    if (!storageRequests.isEmpty())
+        msgList << Core::requestMsgsMulti(coreSession()->user(), storageRequests);
+
+    QHash<BufferId, MsgId> oldestMessages;
+    foreach(const Message &msg, msgList) {
+        backlog << qVariantFromValue(msg);
+        BufferId bufferId = msg.bufferInfo().bufferId();
+        if (!oldestMessages.contains(bufferId) || msg.msgId() < oldestMessages[bufferId])
+            oldestMessages[bufferId] = msg.msgId();
+    }
+
+    if (additionalMsgs.isEmpty())
+        return backlog;
+
+    // same rules as in requestBacklog(), but fetched for all buffers in one go
+    QList<Storage::MsgRequest> additionalRequests;
+    foreach(const Storage::MsgRequest &msgRequest, msgRequests) {
+        if (!additionalMsgs.contains(msgRequest.bufferId))
+            continue;
+
+        MsgId oldestMessage = oldestMessages.value(msgRequest.bufferId, msgRequest.first);
+        MsgId last = msgRequest.first != -1 ? msgRequest.first : oldestMessage;
+
+        // only fetch additional messages if they continue seemlessly
+        if (last == oldestMessage)
+            additionalRequests << Storage::MsgRequest(msgRequest.bufferId, -1, last, additionalMsgs[msgRequest.bufferId]);
+    }
+
+    msgList = Core::requestMsgsMulti(coreSession()->user(), additionalRequests);
+    foreach(const Message &msg, msgList) {
+        backlog << qVariantFromValue(msg);
+    }
+
+    return backlog;
+}
+
+
+QVariantList CoreBacklogManager::requestBacklogHighlights(MsgId first, int limit)
+{
+    QVariantList backlog;
+    foreach(const Message &msg, Core::requestHighlightMsgs(coreSession()->user(), first, limit)) {
+        backlog << qVariantFromValue(msg);
+    }
+    return backlog;
+}
+
+
+QVariantList CoreBacklogManager::requestBacklogByTime(BufferId bufferId, const QDateTime &time, MsgId first, MsgId last, int before, int after)
+{
+    QVariantList backlog;
+    foreach(const Message &msg, Core::requestMsgsByTime(coreSession()->user(), bufferId, time, first, last, before, after)) {
+        backlog << qVariantFromValue(msg);
+    }
+    return backlog;
+}
+
+
+QVariantList CoreBacklogManager::requestBacklogBySender(BufferId bufferId, const QString &nick, MsgId last, int limit)
+{
+    QVariantList backlog;
+    foreach(const Message &msg, Core::requestMsgsBySender(coreSession()->user(), bufferId, nick, last, limit)) {
+        backlog << qVariantFromValue(msg);
+    }
+    return backlog;
+}
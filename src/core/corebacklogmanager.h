@@ -38,6 +38,10 @@ public:
 public slots:
     virtual QVariantList requestBacklog(BufferId bufferId, MsgId first = -1, MsgId last = -1, int limit = -1, int additional = 0);
     virtual QVariantList requestBacklogAll(MsgId first = -1, MsgId last = -1, int limit = -1, int additional = 0);
+    virtual QVariantList requestBacklogMulti(const QVariantList &requests);
+    virtual QVariantList requestBacklogHighlights(MsgId first = -1, int limit = -1);
+    virtual QVariantList requestBacklogByTime(BufferId bufferId, const QDateTime &time, MsgId first = -1, MsgId last = -1, int before = 0, int after = -1);
+    virtual QVariantList requestBacklogBySender(BufferId bufferId, const QString &nick, MsgId last = -1, int limit = -1);
 
 private:
     CoreSession *_coreSession;
@@ -0,0 +1,322 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "corebacklogpruner.h"
+
+#include <QDataStream>
+#include <QDir>
+
+#include "core.h"
+#include "corebuffersyncer.h"
+#include "coresession.h"
+#include "logger.h"
+#include "metrics.h"
+#include "quassel.h"
+
+namespace {
+const quint32 archiveMagic = 0x51424b41;
+const quint32 archiveVersion = 1;
+const int firstRunDelay = 5 * 60 * 1000; // leave the session some time to settle first
+}
+
+CoreBacklogPruner::CoreBacklogPruner(CoreSession *session)
+    : QObject(session),
+    _coreSession(session),
+    _running(false),
+    _currentPruned(0),
+    _buffersTotal(0),
+    _buffersDone(0),
+    _msgsPruned(0)
+{
+    _batchTimer.setSingleShot(true);
+    _batchTimer.setInterval(batchInterval);
+    connect(&_batchTimer, SIGNAL(timeout()), SLOT(pruneNextBatch()));
+
+    connect(&_runTimer, SIGNAL(timeout()), SLOT(start()));
+    _runTimer.start(runInterval);
+    QTimer::singleShot(firstRunDelay, this, SLOT(start()));
+}
+
+
+CoreBacklogPruner::Rule CoreBacklogPruner::readRule(const QVariantMap &map, const Rule &defaults)
+{
+    Rule rule = defaults;
+    if (map.contains("MaxAge"))
+        rule.maxAge = map["MaxAge"].toInt();
+    if (map.contains("MaxCount"))
+        rule.maxCount = map["MaxCount"].toInt();
+    return rule;
+}
+
+
+void CoreBacklogPruner::loadRules()
+{
+    Rule defaults;
+    defaults.maxAge = Quassel::optionValue("backlog-max-age").toInt();
+    defaults.maxCount = Quassel::optionValue("backlog-max-count").toInt();
+
+    QVariantMap settings = Core::getUserSetting(_coreSession->user(), "BacklogRetention").toMap();
+    _userRule = readRule(settings, defaults);
+    _networkRules = settings["Networks"].toMap();
+    _bufferRules = settings["Buffers"].toMap();
+}
+
+
+CoreBacklogPruner::Rule CoreBacklogPruner::rule(const BufferInfo &bufferInfo) const
+{
+    Rule rule = _userRule;
+    QString networkKey = QString::number(bufferInfo.networkId().toInt());
+    if (_networkRules.contains(networkKey))
+        rule = readRule(_networkRules[networkKey].toMap(), rule);
+    QString bufferKey = QString::number(bufferInfo.bufferId().toInt());
+    if (_bufferRules.contains(bufferKey))
+        rule = readRule(_bufferRules[bufferKey].toMap(), rule);
+    return rule;
+}
+
+
+QVariantMap CoreBacklogPruner::stats() const
+{
+    QVariantMap stats;
+    stats["running"] = _running;
+    stats["buffersDone"] = _buffersDone;
+    stats["buffersTotal"] = _buffersTotal;
+    stats["messagesPruned"] = _msgsPruned;
+    stats["lastRun"] = _lastRun;
+    return stats;
+}
+
+
+void CoreBacklogPruner::start()
+{
+    if (_running)
+        return;
+
+    loadRules();
+    _lastRun = QDateTime::currentDateTime();
+    _pendingBuffers.clear();
+    foreach(const BufferInfo &bufferInfo, Core::requestBuffers(_coreSession->user())) {
+        if (!rule(bufferInfo).isEmpty())
+            _pendingBuffers << bufferInfo;
+    }
+    if (_pendingBuffers.isEmpty())
+        return;
+
+    _running = true;
+    _currentBuffer = BufferInfo();
+    _buffersTotal = _pendingBuffers.count();
+    _buffersDone = 0;
+    _msgsPruned = 0;
+    _batchTimer.start();
+}
+
+
+void CoreBacklogPruner::pruneNextBatch()
+{
+    UserId user = _coreSession->user();
+
+    if (!_currentBuffer.isValid()) {
+        if (_pendingBuffers.isEmpty()) {
+            finishRun();
+            return;
+        }
+
+        // determining what to remove is a batch of its own
+        _currentBuffer = _pendingBuffers.takeFirst();
+        _currentPruned = 0;
+        Rule bufferRule = rule(_currentBuffer);
+        QDateTime minTime;
+        if (bufferRule.maxAge > 0)
+            minTime = QDateTime::currentDateTime().addDays(-bufferRule.maxAge);
+        _boundary = Core::expiredMsgsBoundary(user, _currentBuffer.bufferId(), minTime, bufferRule.maxCount);
+        if (!_boundary.isValid())
+            finishBuffer();
+        _batchTimer.start();
+        return;
+    }
+
+    // messages are only deleted once they are safely archived, so a failure never loses any
+    BufferId bufferId = _currentBuffer.bufferId();
+    QList<Message> msgs = Core::requestExpiredMsgs(user, bufferId, _boundary, batchSize);
+    if (!msgs.isEmpty()) {
+        if (Quassel::isOptionSet("backlog-archive-dir") && !archiveMessages(bufferId, msgs)) {
+            // stop until the archive is writable again
+            qWarning() << "CoreBacklogPruner: could not write archive" << _archive.fileName() << "-" << qPrintable(_archive.errorString()) << "- not pruning any further";
+            abortRun();
+            return;
+        }
+        if (!Core::deleteMsgsUntil(user, bufferId, msgs.last().msgId())) {
+            qWarning() << "CoreBacklogPruner: could not remove expired messages from buffer" << _currentBuffer.bufferName() << "of user" << user << "- not pruning any further";
+            abortRun();
+            return;
+        }
+        _currentPruned += msgs.count();
+        _msgsPruned += msgs.count();
+        if (Metrics::isEnabled())
+            Metrics::increment("quassel_backlog_pruned_messages_total", Metrics::labels("user", QString::number(user.toInt())), msgs.count());
+    }
+
+    if (msgs.count() < batchSize)
+        finishBuffer();
+    _batchTimer.start();
+}
+
+
+void CoreBacklogPruner::finishBuffer()
+{
+    if (_currentPruned > 0) {
+        BufferId bufferId = _currentBuffer.bufferId();
+        _coreSession->messageCache()->invalidate(bufferId);
+        // last seen and marker line ids may now point to removed messages, which clients cope with;
+        // the unread counts however have to shrink accordingly
+        _coreSession->bufferSyncer()->messagesPruned(bufferId);
+        qDebug() << "CoreBacklogPruner: removed" << _currentPruned << "messages from buffer" << _currentBuffer.bufferName() << "of user" << _coreSession->user();
+    }
+    _buffersDone++;
+    _currentBuffer = BufferInfo();
+}
+
+
+void CoreBacklogPruner::abortRun()
+{
+    _pendingBuffers.clear();
+    finishBuffer();
+    finishRun();
+}
+
+
+void CoreBacklogPruner::finishRun()
+{
+    _running = false;
+    _batchTimer.stop();
+    _archive.close();
+    if (_msgsPruned > 0)
+        quInfo() << "Pruned" << _msgsPruned << "expired messages in" << _buffersDone << "buffers of user" << _coreSession->user();
+}
+
+
+bool CoreBacklogPruner::openArchive()
+{
+    if (_archive.isOpen())
+        return true;
+
+    QDir dir(Quassel::configDirPath());
+    QString path = dir.absoluteFilePath(Quassel::optionValue("backlog-archive-dir"));
+    if (!dir.mkpath(path))
+        return false;
+
+    // one file per run, so a failed write never damages older archives
+    QString fileName = QString("backlog-%1-%2.archive").arg(_coreSession->user().toInt()).arg(_lastRun.toString("yyyyMMdd-hhmmss"));
+    _archive.setFileName(QDir(path).absoluteFilePath(fileName));
+    if (!_archive.open(QIODevice::WriteOnly | QIODevice::Append))
+        return false;
+
+    if (_archive.size() == 0) {
+        QDataStream out(&_archive);
+        out.setVersion(QDataStream::Qt_4_2);
+        out << archiveMagic << archiveVersion << (qint32)_coreSession->user().toInt();
+        if (out.status() != QDataStream::Ok) {
+            _archive.close();
+            return false;
+        }
+    }
+    return true;
+}
+
+
+bool CoreBacklogPruner::archiveMessages(BufferId bufferId, const QList<Message> &msgs)
+{
+    if (!openArchive())
+        return false;
+
+    QByteArray chunk;
+    QDataStream chunkStream(&chunk, QIODevice::WriteOnly);
+    chunkStream.setVersion(QDataStream::Qt_4_2);
+    chunkStream << (quint32)msgs.count();
+    foreach(const Message &msg, msgs) {
+        chunkStream << (qint32)msg.msgId().toInt() << (qint64)msg.timestamp().toMSecsSinceEpoch()
+                    << (quint32)msg.type() << (quint32)msg.flags() << msg.sender() << msg.contents();
+    }
+
+    QDataStream out(&_archive);
+    out.setVersion(QDataStream::Qt_4_2);
+    out << (qint32)bufferId.toInt() << qCompress(chunk);
+    return out.status() == QDataStream::Ok && _archive.flush();
+}
+
+
+int CoreBacklogPruner::restoreArchive(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        qWarning() << "Could not open backlog archive" << fileName << "-" << qPrintable(file.errorString());
+        return -1;
+    }
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_4_2);
+    quint32 magic, version;
+    qint32 user;
+    in >> magic >> version >> user;
+    if (in.status() != QDataStream::Ok || magic != archiveMagic || version != archiveVersion) {
+        qWarning() << fileName << "is not a backlog archive";
+        return -1;
+    }
+
+    int count = 0;
+    while (!in.atEnd()) {
+        qint32 bufferId;
+        QByteArray compressed;
+        in >> bufferId >> compressed;
+        QByteArray chunk = qUncompress(compressed);
+        if (in.status() != QDataStream::Ok || chunk.isEmpty()) {
+            qWarning() << "Backlog archive" << fileName << "is truncated or corrupt";
+            return -1;
+        }
+
+        QDataStream chunkStream(chunk);
+        chunkStream.setVersion(QDataStream::Qt_4_2);
+        quint32 chunkSize;
+        chunkStream >> chunkSize;
+        QList<Message> msgs;
+        for (quint32 i = 0; i < chunkSize; i++) {
+            qint32 msgId;
+            qint64 time;
+            quint32 type, flags;
+            QString sender, contents;
+            chunkStream >> msgId >> time >> type >> flags >> sender >> contents;
+            if (chunkStream.status() != QDataStream::Ok)
+                break;
+            Message msg(QDateTime::fromMSecsSinceEpoch(time), BufferInfo(), (Message::Type)type, contents, sender, (Message::Flags)flags);
+            msg.setMsgId(msgId);
+            msgs << msg;
+        }
+        if (chunkStream.status() != QDataStream::Ok) {
+            qWarning() << "Backlog archive" << fileName << "is truncated or corrupt";
+            return -1;
+        }
+
+        if (!Core::restoreMsgs(user, bufferId, msgs))
+            qWarning() << "Could not restore" << msgs.count() << "messages of buffer" << bufferId << "(the buffer may have been removed)";
+        else
+            count += msgs.count();
+    }
+    return count;
+}
@@ -0,0 +1,121 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef COREBACKLOGPRUNER_H
+#define COREBACKLOGPRUNER_H
+
+#include <QDateTime>
+#include <QFile>
+#include <QObject>
+#include <QTimer>
+#include <QVariantMap>
+
+#include "bufferinfo.h"
+#include "message.h"
+
+class CoreSession;
+
+//! Removes expired messages from the backlog of a session's buffers
+/** Messages expire by age or by count. The rules are given as core-wide defaults on the command
+ *  line, which the "BacklogRetention" user setting overrides for the user, single networks
+ *  ("Networks", keyed by NetworkId) or single buffers ("Buffers", keyed by BufferId):
+ *  \code
+ *  { "MaxAge": days, "MaxCount": messages, "Networks": { "1": { "MaxAge": 30 } }, "Buffers": { ... } }
+ *  \endcode
+ *  The most specific value wins, and 0 means to keep messages forever.
+ *
+ *  Pruning runs in the event loop in small batches, each removing the oldest messages of one buffer
+ *  in its own short storage transaction, so that it never blocks message logging for long. If an
+ *  archive directory is configured, each batch is appended to a compressed archive file before it is
+ *  removed; the archive can be loaded back into the storage with restoreArchive().
+ */
+class CoreBacklogPruner : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Rule {
+        int maxAge;   //!< in days, 0 for no limit
+        int maxCount; //!< per buffer, 0 for no limit
+        Rule() : maxAge(0), maxCount(0) {}
+        inline bool isEmpty() const { return maxAge <= 0 && maxCount <= 0; }
+    };
+
+    CoreBacklogPruner(CoreSession *session);
+
+    //! The retention rule for a buffer, as of the last loaded settings
+    Rule rule(const BufferInfo &bufferInfo) const;
+
+    //! Progress of the current (or last) run for CoreInfo
+    QVariantMap stats() const;
+
+    //! Stores the messages of an archive file in the backlog again
+    /** Messages that are still in the backlog, and messages of buffers that do not exist
+     *  anymore, are skipped.
+     *  \return The number of restored messages, or -1 if the archive could not be read
+     */
+    static int restoreArchive(const QString &fileName);
+
+public slots:
+    //! Starts a run over all buffers of the session, unless one is in progress already
+    void start();
+
+private slots:
+    void pruneNextBatch();
+
+private:
+    void loadRules();
+    void finishBuffer();
+    void finishRun();
+    void abortRun();
+
+    bool openArchive();
+    bool archiveMessages(BufferId bufferId, const QList<Message> &msgs);
+
+    static Rule readRule(const QVariantMap &map, const Rule &defaults);
+
+    CoreSession *_coreSession;
+    QTimer _runTimer;
+    QTimer _batchTimer;
+
+    Rule _userRule;
+    QVariantMap _networkRules;
+    QVariantMap _bufferRules;
+
+    bool _running;
+    QList<BufferInfo> _pendingBuffers;
+    BufferInfo _currentBuffer;
+    MsgId _boundary;
+    int _currentPruned;
+
+    int _buffersTotal;
+    int _buffersDone;
+    qint64 _msgsPruned;
+    QDateTime _lastRun;
+
+    QFile _archive;
+
+    static const int batchSize = 500;
+    static const int batchInterval = 20;  // ms between two batches
+    static const int runInterval = 60 * 60 * 1000;
+};
+
+
+#endif // COREBACKLOGPRUNER_H
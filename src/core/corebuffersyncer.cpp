@@ -32,19 +32,35 @@ public:
 };
 
 
+class ActivityEvent : public QEvent
+{
+public:
+    ActivityEvent() : QEvent(QEvent::Type(QEvent::User + 1)) {}
+};
+
+
 INIT_SYNCABLE_OBJECT(CoreBufferSyncer)
 CoreBufferSyncer::CoreBufferSyncer(CoreSession *parent)
     : BufferSyncer(Core::bufferLastSeenMsgIds(parent->user()), Core::bufferMarkerLineMsgIds(parent->user()), parent),
     _coreSession(parent),
-    _purgeBuffers(false)
+    _purgeBuffers(false),
+    _updateActivity(false),
+    _counts(Core::bufferActivityCounts(parent->user()))
 {
+    QHash<BufferId, Storage::ActivityCount>::const_iterator iter = _counts.constBegin();
+    while (iter != _counts.constEnd()) {
+        setActivityCount(iter.key(), iter->unread, iter->highlights);
+        ++iter;
+    }
 }
 
 
 void CoreBufferSyncer::requestSetLastSeenMsg(BufferId buffer, const MsgId &msgId)
 {
-    if (setLastSeenMsg(buffer, msgId))
+    if (setLastSeenMsg(buffer, msgId)) {
         dirtyLastSeenBuffers << buffer;
+        recountActivity(buffer);
+    }
 }
 
 
@@ -101,8 +117,13 @@ void CoreBufferSyncer::removeBuffer(BufferId bufferId)
             return;
         }
     }
-    if (Core::removeBuffer(_coreSession->user(), bufferId))
+    if (Core::removeBuffer(_coreSession->user(), bufferId)) {
+        _coreSession->messageCache()->invalidate(bufferId);
+        _counts.remove(bufferId);
+        _changedActivityCounts.remove(bufferId);
+        _recountActivity.remove(bufferId);
         BufferSyncer::removeBuffer(bufferId);
+    }
 }
 
 
@@ -139,17 +160,89 @@ void CoreBufferSyncer::mergeBuffersPermanently(BufferId bufferId1, BufferId buff
     }
 
     if (Core::mergeBuffersPermanently(_coreSession->user(), bufferId1, bufferId2)) {
+        _coreSession->messageCache()->invalidate(bufferId1);
+        _coreSession->messageCache()->invalidate(bufferId2);
+        _counts.remove(bufferId2);
+        _changedActivityCounts.remove(bufferId2);
+        _recountActivity.remove(bufferId2);
         BufferSyncer::mergeBuffersPermanently(bufferId1, bufferId2);
+        recountActivity(bufferId1);
+    }
+}
+
+
+void CoreBufferSyncer::messageStored(const Message &msg)
+{
+    if (!msg.msgId().isValid() || !Storage::countsAsUnread(msg))
+        return;
+
+    BufferId buffer = msg.bufferInfo().bufferId();
+    if (_recountActivity.contains(buffer))
+        return; // the query will include this message
+
+    MsgId lastSeen = lastSeenMsg(buffer);
+    if (lastSeen.isValid() && msg.msgId() <= lastSeen)
+        return;
+
+    Storage::ActivityCount &count = _counts[buffer];
+    count.unread++;
+    if (msg.flags() & Message::Highlight)
+        count.highlights++;
+
+    _changedActivityCounts << buffer;
+    scheduleActivityUpdate();
+}
+
+
+void CoreBufferSyncer::recountActivity(BufferId buffer)
+{
+    _recountActivity << buffer;
+    scheduleActivityUpdate();
+}
+
+
+void CoreBufferSyncer::scheduleActivityUpdate()
+{
+    if (_updateActivity)
+        return;
+
+    // sync the counts once per event loop iteration instead of once per message
+    _updateActivity = true;
+    QCoreApplication::postEvent(this, new ActivityEvent());
+}
+
+
+void CoreBufferSyncer::updateActivityCounts()
+{
+    _updateActivity = false;
+
+    foreach(BufferId buffer, _recountActivity) {
+        Storage::ActivityCount count = Core::bufferActivityCount(_coreSession->user(), buffer, lastSeenMsg(buffer));
+        if (count.unread > 0)
+            _counts[buffer] = count;
+        else
+            _counts.remove(buffer);
+        _changedActivityCounts << buffer;
+    }
+    _recountActivity.clear();
+
+    foreach(BufferId buffer, _changedActivityCounts) {
+        Storage::ActivityCount count = _counts.value(buffer);
+        setActivityCount(buffer, count.unread, count.highlights);
     }
+    _changedActivityCounts.clear();
 }
 
 
 void CoreBufferSyncer::customEvent(QEvent *event)
 {
-    if (event->type() != QEvent::User)
+    if (event->type() == QEvent::User)
+        purgeBufferIds();
+    else if (event->type() == QEvent::User + 1)
+        updateActivityCounts();
+    else
         return;
 
-    purgeBufferIds();
     event->accept();
 }
 
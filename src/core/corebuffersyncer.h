@@ -22,6 +22,8 @@
 #define COREBUFFERSYNCER_H
 
 #include "buffersyncer.h"
+#include "message.h"
+#include "storage.h"
 
 class CoreSession;
 
@@ -52,16 +54,33 @@ public slots:
 
     void storeDirtyIds();
 
+    //! Updates the activity count of the message's buffer after it has been stored
+    void messageStored(const Message &msg);
+
+    //! Updates the activity count of a buffer after messages have been pruned from it
+    inline void messagesPruned(BufferId buffer) { recountActivity(buffer); }
+
 protected:
     virtual void customEvent(QEvent *event);
 
 private:
     CoreSession *_coreSession;
     bool _purgeBuffers;
+    bool _updateActivity;
 
     QSet<BufferId> dirtyLastSeenBuffers;
     QSet<BufferId> dirtyMarkerLineBuffers;
 
+    // unread counts are kept here and synced in batches; buffers that need to be
+    // counted again (e.g. because the last seen message moved) are queried lazily
+    QHash<BufferId, Storage::ActivityCount> _counts;
+    QSet<BufferId> _changedActivityCounts;
+    QSet<BufferId> _recountActivity;
+
+    void recountActivity(BufferId buffer);
+    void scheduleActivityUpdate();
+    void updateActivityCounts();
+
     void purgeBufferIds();
 };
 
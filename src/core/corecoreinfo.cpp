@@ -21,6 +21,7 @@
 #include "corecoreinfo.h"
 
 #include "core.h"
+#include "corebacklogpruner.h"
 #include "coresession.h"
 #include "quassel.h"
 #include "signalproxy.h"
@@ -40,5 +41,7 @@ QVariantMap CoreCoreInfo::coreData() const
     data["quasselBuildDate"] = Quassel::buildInfo().buildDate;
     data["startTime"] = Core::instance()->startTime();
     data["sessionConnectedClients"] = _coreSession->signalProxy()->peerCount();
+    data["backlogCache"] = _coreSession->messageCache()->stats();
+    data["backlogRetention"] = _coreSession->backlogPruner()->stats();
     return data;
 }
@@ -24,6 +24,7 @@
 #include "corenetwork.h"
 #include "coresession.h"
 #include "eventmanager.h"
+#include "metrics.h"
 
 class CoreEventManager : public EventManager
 {
@@ -37,6 +38,7 @@ public:
 
 protected:
     inline Network *networkById(NetworkId id) const { return _coreSession->network(id); }
+    inline QString metricsLabels() const { return Metrics::labels("user", QString::number(_coreSession->user().toInt())); }
 
 private:
     CoreSession *_coreSession;
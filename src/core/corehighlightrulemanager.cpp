@@ -0,0 +1,74 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "corehighlightrulemanager.h"
+
+#include "core.h"
+#include "coreidentity.h"
+#include "corenetwork.h"
+#include "coresession.h"
+
+INIT_SYNCABLE_OBJECT(CoreHighlightRuleManager)
+CoreHighlightRuleManager::CoreHighlightRuleManager(CoreSession *parent)
+    : HighlightRuleManager(parent)
+{
+    CoreSession *session = qobject_cast<CoreSession *>(parent);
+    if (!session) {
+        qWarning() << "CoreHighlightRuleManager: unable to load HighlightRuleList. Parent is not a Coresession!";
+        return;
+    }
+
+    fromVariantMap(Core::getUserSetting(session->user(), "HighlightRuleList").toMap());
+
+    // we store our settings whenever they change
+    connect(this, SIGNAL(updatedRemotely()), SLOT(save()));
+}
+
+
+bool CoreHighlightRuleManager::match(const Message &msg, const CoreNetwork *network)
+{
+    if (!network)
+        return false;
+
+    QStringList nicks;
+    nicks << network->myNick();
+    if (highlightNick() == AllNicks) {
+        const CoreIdentity *identity = network->identityPtr();
+        if (identity) {
+            foreach(const QString &nick, identity->nicks()) {
+                if (nick != network->myNick())
+                    nicks << nick;
+            }
+        }
+    }
+    return HighlightRuleManager::match(msg, nicks);
+}
+
+
+void CoreHighlightRuleManager::save()
+{
+    CoreSession *session = qobject_cast<CoreSession *>(parent());
+    if (!session) {
+        qWarning() << "CoreHighlightRuleManager: unable to save HighlightRuleList. Parent is not a Coresession!";
+        return;
+    }
+
+    Core::setUserSetting(session->user(), "HighlightRuleList", toVariantMap());
+}
@@ -0,0 +1,47 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef COREHIGHLIGHTRULEMANAGER_H
+#define COREHIGHLIGHTRULEMANAGER_H
+
+#include "highlightrulemanager.h"
+
+class CoreNetwork;
+class CoreSession;
+
+class CoreHighlightRuleManager : public HighlightRuleManager
+{
+    SYNCABLE_OBJECT
+        Q_OBJECT
+
+public:
+    explicit CoreHighlightRuleManager(CoreSession *parent);
+
+    inline virtual const QMetaObject *syncMetaObject() const { return &HighlightRuleManager::staticMetaObject; }
+
+    //! Check if a message is a highlight for the given network's nick and identity
+    bool match(const Message &msg, const CoreNetwork *network);
+
+private slots:
+    void save();
+};
+
+
+#endif //COREHIGHLIGHTRULEMANAGER_H
@@ -26,21 +26,16 @@ CoreIrcChannel::CoreIrcChannel(const QString &channelname, Network *network)
     : IrcChannel(channelname, network),
     _receivedWelcomeMsg(false)
 {
-#ifdef HAVE_QCA2
     _cipher = 0;
-#endif
 }
 
 
 CoreIrcChannel::~CoreIrcChannel()
 {
-#ifdef HAVE_QCA2
     delete _cipher;
-#endif
 }
 
 
-#ifdef HAVE_QCA2
 Cipher *CoreIrcChannel::cipher() const
 {
     if (!_cipher)
@@ -54,9 +49,6 @@ void CoreIrcChannel::setEncrypted(bool e)
 {
     IrcChannel::setEncrypted(e);
 
-    if (!Cipher::neededFeaturesAvailable())
-        return;
-
     if (e) {
         if (topic().isEmpty())
             return;
@@ -65,6 +57,3 @@ void CoreIrcChannel::setEncrypted(bool e)
         setTopic(decodeString(decrypted));
     }
 }
-
-
-#endif
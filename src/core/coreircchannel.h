@@ -23,9 +23,7 @@
 
 #include "ircchannel.h"
 
-#ifdef HAVE_QCA2
-#  include "cipher.h"
-#endif
+#include "cipher.h"
 
 class CoreIrcChannel : public IrcChannel
 {
@@ -38,20 +36,15 @@ public:
 
     inline virtual const QMetaObject *syncMetaObject() const { return &IrcChannel::staticMetaObject; }
 
-#ifdef HAVE_QCA2
     Cipher *cipher() const;
     void setEncrypted(bool);
-#endif
 
     inline bool receivedWelcomeMsg() const { return _receivedWelcomeMsg; }
     inline void setReceivedWelcomeMsg() { _receivedWelcomeMsg = true; }
 
 private:
     bool _receivedWelcomeMsg;
-
-#ifdef HAVE_QCA2
     mutable Cipher *_cipher;
-#endif
 };
 
 
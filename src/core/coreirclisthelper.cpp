@@ -20,31 +20,94 @@
 
 #include "coreirclisthelper.h"
 
+#include <QRegExp>
+
 #include "corenetwork.h"
 #include "coreuserinputhandler.h"
 
 INIT_SYNCABLE_OBJECT(CoreIrcListHelper)
 QVariantList CoreIrcListHelper::requestChannelList(const NetworkId &netId, const QStringList &channelFilters)
 {
-    if (_finishedChannelLists.contains(netId))
-        return _finishedChannelLists.take(netId);
+    if (channelFilters.isEmpty()) {
+        // the client is pulling the list we announced with reportFinishedList()
+        QVariantList channelList;
+        if (!_channelLists.contains(netId) || !_channelLists[netId].finished)
+            return channelList;
+
+        foreach(const ChannelDescription &channel, _channelLists[netId].channels) {
+            QVariantList channelVariant;
+            channelVariant << channel.channelName
+                           << channel.userCount
+                           << channel.topic;
+            channelList << qVariantFromValue<QVariant>(channelVariant);
+        }
+        return channelList;
+    }
 
-    if (_channelLists.contains(netId)) {
-        _queuedQuery[netId] = channelFilters.join(",");
+    QString query = channelFilters.join(",");
+    if (requestInProgress(netId)) {
+        if (_channelLists[netId].query == query)
+            _queuedQuery.remove(netId);
+        else
+            _queuedQuery[netId] = query;
+    }
+    else if (isCached(netId, query)) {
+        reportFinishedList(netId);
     }
     else {
-        dispatchQuery(netId, channelFilters.join(","));
+        dispatchQuery(netId, query);
     }
     return QVariantList();
 }
 
 
-bool CoreIrcListHelper::addChannel(const NetworkId &netId, const QString &channelName, quint32 userCount, const QString &topic)
+QVariantMap CoreIrcListHelper::requestChannelListPage(const NetworkId &netId, const QVariantMap &filter, int offset)
 {
+    QVariantMap page;
     if (!_channelLists.contains(netId))
+        return page;
+
+    const ChannelList &list = _channelLists[netId];
+    QRegExp pattern(filter.value("Pattern").toString(), Qt::CaseInsensitive, QRegExp::Wildcard);
+    quint32 minUsers = filter.value("MinUsers").toUInt();
+    QString topic = filter.value("Topic").toString();
+
+    QVariantList channels;
+    int end = qMin(qMax(offset, 0) + pageSize, list.channels.count());
+    for (int i = qMax(offset, 0); i < end; i++) {
+        const ChannelDescription &channel = list.channels.at(i);
+        if (channel.userCount < minUsers)
+            continue;
+        if (!pattern.isEmpty() && !pattern.exactMatch(channel.channelName))
+            continue;
+        if (!topic.isEmpty() && !channel.topic.contains(topic, Qt::CaseInsensitive))
+            continue;
+
+        QVariantList channelVariant;
+        channelVariant << channel.channelName
+                       << channel.userCount
+                       << channel.topic;
+        channels << qVariantFromValue<QVariant>(channelVariant);
+    }
+
+    page["Query"] = list.query;
+    page["Channels"] = channels;
+    page["NextOffset"] = qMax(end, offset);
+    page["Total"] = list.channels.count();
+    page["Finished"] = list.finished;
+    return page;
+}
+
+
+bool CoreIrcListHelper::addChannel(const NetworkId &netId, const QString &channelName, quint32 userCount, const QString &topic)
+{
+    if (!requestInProgress(netId))
         return false;
 
-    _channelLists[netId] << ChannelDescription(channelName, userCount, topic);
+    QList<ChannelDescription> &channels = _channelLists[netId].channels;
+    channels << ChannelDescription(channelName, userCount, topic);
+    if (channels.count() % pageSize == 0)
+        reportChannelListProgress(netId, channels.count());
     return true;
 }
 
@@ -53,7 +116,7 @@ bool CoreIrcListHelper::dispatchQuery(const NetworkId &netId, const QString &que
 {
     CoreNetwork *network = coreSession()->network(netId);
     if (network) {
-        _channelLists[netId] = QList<ChannelDescription>();
+        _channelLists[netId] = ChannelList(query);
         network->userInputHandler()->handleList(BufferInfo(), query);
         _queryTimeout[startTimer(10000)] = netId;
         return true;
@@ -64,23 +127,28 @@ bool CoreIrcListHelper::dispatchQuery(const NetworkId &netId, const QString &que
 }
 
 
+bool CoreIrcListHelper::isCached(const NetworkId &netId, const QString &query) const
+{
+    if (!_channelLists.contains(netId))
+        return false;
+
+    const ChannelList &list = _channelLists[netId];
+    return list.finished && list.query == query
+           && list.finishedAt.secsTo(QDateTime::currentDateTime()) < cacheTimeout;
+}
+
+
 bool CoreIrcListHelper::endOfChannelList(const NetworkId &netId)
 {
     if (_queuedQuery.contains(netId)) {
         // we're no longer interessted in the current data. drop it and issue a new request.
         return dispatchQuery(netId, _queuedQuery.take(netId));
     }
-    else if (_channelLists.contains(netId)) {
-        QVariantList channelList;
-        foreach(ChannelDescription channel, _channelLists[netId]) {
-            QVariantList channelVariant;
-            channelVariant << channel.channelName
-                           << channel.userCount
-                           << channel.topic;
-            channelList << qVariantFromValue<QVariant>(channelVariant);
-        }
-        _finishedChannelLists[netId] = channelList;
-        _channelLists.remove(netId);
+    else if (requestInProgress(netId)) {
+        ChannelList &list = _channelLists[netId];
+        list.finished = true;
+        list.finishedAt = QDateTime::currentDateTime();
+        _cacheTimeout[startTimer(cacheTimeout * 1000)] = netId;
         reportFinishedList(netId);
         return true;
     }
@@ -94,6 +162,12 @@ void CoreIrcListHelper::timerEvent(QTimerEvent *event)
 {
     int timerId = event->timerId();
     killTimer(timerId);
+    if (_cacheTimeout.contains(timerId)) {
+        NetworkId netId = _cacheTimeout.take(timerId);
+        if (_channelLists.contains(netId) && _channelLists[netId].finished && !isCached(netId, _channelLists[netId].query))
+            _channelLists.remove(netId);
+        return;
+    }
     NetworkId netId = _queryTimeout.take(timerId);
     endOfChannelList(netId);
 }
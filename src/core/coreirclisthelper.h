@@ -21,6 +21,8 @@
 #ifndef COREIRCLISTHELPER_H
 #define COREIRCLISTHELPER_H
 
+#include <QDateTime>
+
 #include "irclisthelper.h"
 
 #include "coresession.h"
@@ -39,10 +41,11 @@ public:
 
     inline CoreSession *coreSession() const { return _coreSession; }
 
-    inline bool requestInProgress(const NetworkId &netId) const { return _channelLists.contains(netId); }
+    inline bool requestInProgress(const NetworkId &netId) const { return _channelLists.contains(netId) && !_channelLists[netId].finished; }
 
 public slots:
     virtual QVariantList requestChannelList(const NetworkId &netId, const QStringList &channelFilters);
+    virtual QVariantMap requestChannelListPage(const NetworkId &netId, const QVariantMap &filter, int offset);
     bool addChannel(const NetworkId &netId, const QString &channelName, quint32 userCount, const QString &topic);
     bool endOfChannelList(const NetworkId &netId);
 
@@ -50,15 +53,27 @@ protected:
     void timerEvent(QTimerEvent *event);
 
 private:
+    struct ChannelList {
+        QString query;
+        QList<ChannelDescription> channels;
+        bool finished;
+        QDateTime finishedAt;
+        ChannelList(const QString &query_ = QString()) : query(query_), finished(false) {};
+    };
+
     bool dispatchQuery(const NetworkId &netId, const QString &query);
+    bool isCached(const NetworkId &netId, const QString &query) const;
+
+    static const int pageSize = 500;       //!< Channels per page and per progress report
+    static const int cacheTimeout = 300;   //!< Seconds a finished list is kept for repeated queries
 
 private:
     CoreSession *_coreSession;
 
     QHash<NetworkId, QString> _queuedQuery;
-    QHash<NetworkId, QList<ChannelDescription> > _channelLists;
-    QHash<NetworkId, QVariantList> _finishedChannelLists;
+    QHash<NetworkId, ChannelList> _channelLists;
     QHash<int, NetworkId> _queryTimeout;
+    QHash<int, NetworkId> _cacheTimeout;
 };
 
 
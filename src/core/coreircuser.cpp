@@ -22,21 +22,16 @@
 
 CoreIrcUser::CoreIrcUser(const QString &hostmask, Network *network) : IrcUser(hostmask, network)
 {
-#ifdef HAVE_QCA2
     _cipher = 0;
-#endif
 }
 
 
 CoreIrcUser::~CoreIrcUser()
 {
-#ifdef HAVE_QCA2
     delete _cipher;
-#endif
 }
 
 
-#ifdef HAVE_QCA2
 Cipher *CoreIrcUser::cipher() const
 {
     if (!_cipher)
@@ -44,6 +39,3 @@ Cipher *CoreIrcUser::cipher() const
 
     return _cipher;
 }
-
-
-#endif
@@ -23,9 +23,7 @@
 
 #include "ircuser.h"
 
-#ifdef HAVE_QCA2
-#  include "cipher.h"
-#endif
+#include "cipher.h"
 
 class CoreIrcUser : public IrcUser
 {
@@ -38,14 +36,10 @@ public:
 
     inline virtual const QMetaObject *syncMetaObject() const { return &IrcUser::staticMetaObject; }
 
-#ifdef HAVE_QCA2
     Cipher *cipher() const;
-#endif
 
-#ifdef HAVE_QCA2
 private:
     mutable Cipher *_cipher;
-#endif
 };
 
 
@@ -0,0 +1,141 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "coremessagecache.h"
+
+CoreMessageCache::CoreMessageCache(int depth, qint64 maxMemory)
+    : _depth(depth),
+    _maxMemory(maxMemory),
+    _memory(0),
+    _insertCount(0),
+    _hits(0),
+    _misses(0)
+{
+}
+
+
+qint64 CoreMessageCache::messageMemory(const Message &msg)
+{
+    // rough estimate: the object itself plus the UTF-16 payload of its strings
+    return sizeof(Message) + 2 * (msg.sender().size() + msg.contents().size() + msg.bufferInfo().bufferName().size());
+}
+
+
+void CoreMessageCache::insert(const Message &msg)
+{
+    if (_depth <= 0 || !msg.msgId().isValid())
+        return;
+
+    Ring &ring = _rings[msg.bufferInfo().bufferId()];
+    if (ring.messages.capacity() != _depth)
+        ring.messages.setCapacity(_depth);
+
+    if (!ring.messages.isEmpty() && msg.msgId() <= ring.messages.last().msgId()) {
+        // out of order, we can no longer vouch for the range being complete
+        invalidate(msg.bufferInfo().bufferId());
+        return;
+    }
+
+    if (ring.messages.isFull()) {
+        qint64 size = messageMemory(ring.messages.first());
+        ring.memory -= size;
+        _memory -= size;
+    }
+    qint64 size = messageMemory(msg);
+    ring.messages.append(msg);
+    ring.memory += size;
+    ring.lastInsert = ++_insertCount;
+    _memory += size;
+
+    while (_memory > _maxMemory && _rings.count() > 1)
+        evictOldest();
+}
+
+
+void CoreMessageCache::invalidate(BufferId bufferId)
+{
+    if (_rings.contains(bufferId))
+        _memory -= _rings.take(bufferId).memory;
+}
+
+
+void CoreMessageCache::evictOldest()
+{
+    QHash<BufferId, Ring>::const_iterator oldest = _rings.constBegin();
+    for (QHash<BufferId, Ring>::const_iterator iter = _rings.constBegin(); iter != _rings.constEnd(); ++iter) {
+        if (iter->lastInsert < oldest->lastInsert)
+            oldest = iter;
+    }
+    invalidate(oldest.key());
+}
+
+
+bool CoreMessageCache::requestMsgs(BufferId bufferId, MsgId first, MsgId last, int limit, QList<Message> &messages)
+{
+    // explicit ranges are usually requests for old backlog, leave them to the storage
+    if (last != -1 || limit == 0 || !_rings.contains(bufferId)) {
+        _misses++;
+        return false;
+    }
+
+    const QContiguousCache<Message> &ring = _rings[bufferId].messages;
+
+    // walk from the newest message backwards, the ring always ends at the newest stored message
+    QList<Message> result;
+    for (int i = ring.lastIndex(); i >= ring.firstIndex(); i--) {
+        const Message &msg = ring.at(i);
+        if (first != -1 && msg.msgId() < first)
+            break;
+        if (limit != -1 && result.count() >= limit)
+            break;
+        result << msg;
+    }
+
+    // we can only answer if the limit was reached, or if all messages >= first are in the ring
+    bool complete = (limit != -1 && result.count() >= limit)
+                    || (first != -1 && ring.first().msgId() <= first);
+    if (!complete) {
+        _misses++;
+        return false;
+    }
+
+    _hits++;
+    messages = result;
+    return true;
+}
+
+
+QVariantMap CoreMessageCache::stats() const
+{
+    int count = 0;
+    foreach(const Ring &ring, _rings) {
+        count += ring.messages.count();
+    }
+
+    QVariantMap stats;
+    stats["depth"] = _depth;
+    stats["buffers"] = _rings.count();
+    stats["messages"] = count;
+    stats["memory"] = _memory;
+    stats["maxMemory"] = _maxMemory;
+    stats["hits"] = _hits;
+    stats["misses"] = _misses;
+    return stats;
+}
@@ -0,0 +1,77 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef COREMESSAGECACHE_H
+#define COREMESSAGECACHE_H
+
+#include <QContiguousCache>
+#include <QHash>
+#include <QVariantMap>
+
+#include "message.h"
+#include "types.h"
+
+//! Per-session cache of the most recently stored messages of each buffer
+/** Every message stored by the session is also added to a ring buffer for its buffer. Since all
+ *  messages of a session pass through here, each ring holds a gapless range of the newest messages
+ *  of its buffer, which lets requestMsgs() answer "newest K" and "newer than X" backlog requests
+ *  without touching the storage backend, as long as the requested range is fully covered.
+ *
+ *  Anything that deletes or moves stored messages must call invalidate() for the affected buffers.
+ */
+class CoreMessageCache
+{
+public:
+    CoreMessageCache(int depth, qint64 maxMemory);
+
+    void insert(const Message &msg);
+    void invalidate(BufferId bufferId);
+
+    //! Serves a backlog request from the cache if possible
+    /** Same semantics as Storage::requestMsgs(), i.e. messages are returned newest first.
+     *  \return true if the request could be answered completely from the cache
+     */
+    bool requestMsgs(BufferId bufferId, MsgId first, MsgId last, int limit, QList<Message> &messages);
+
+    //! Statistics for CoreInfo
+    QVariantMap stats() const;
+
+private:
+    struct Ring {
+        QContiguousCache<Message> messages;
+        qint64 memory;
+        quint64 lastInsert;
+        Ring() : memory(0), lastInsert(0) {}
+    };
+
+    static qint64 messageMemory(const Message &msg);
+    void evictOldest();
+
+    int _depth;
+    qint64 _maxMemory;
+    qint64 _memory;
+    quint64 _insertCount;
+    quint64 _hits;
+    quint64 _misses;
+    QHash<BufferId, Ring> _rings;
+};
+
+
+#endif // COREMESSAGECACHE_H
@@ -27,6 +27,7 @@
 #include "corenetworkconfig.h"
 #include "coresession.h"
 #include "coreuserinputhandler.h"
+#include "metrics.h"
 #include "networkevent.h"
 
 INIT_SYNCABLE_OBJECT(CoreNetwork)
@@ -39,6 +40,7 @@ CoreNetwork::CoreNetwork(const NetworkId &networkid, CoreSession *session)
 
     _previousConnectionAttemptFailed(false),
     _lastUsedServerIndex(0),
+    _socketLocalPort(0),
 
     _lastPingTime(0),
     _pingCount(0),
@@ -82,8 +84,8 @@ CoreNetwork::CoreNetwork(const NetworkId &networkid, CoreSession *session)
     connect(this, SIGNAL(newEvent(Event *)), coreSession()->eventManager(), SLOT(postEvent(Event *)));
 
     if (Quassel::isOptionSet("oidentd")) {
-        connect(this, SIGNAL(socketInitialized(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)), Core::instance()->oidentdConfigGenerator(), SLOT(addSocket(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)), Qt::BlockingQueuedConnection);
-        connect(this, SIGNAL(socketDisconnected(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)), Core::instance()->oidentdConfigGenerator(), SLOT(removeSocket(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)));
+        connect(this, SIGNAL(socketInitialized(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)), Core::instance()->oidentdConfigGenerator(), SLOT(addSocket(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)), Qt::DirectConnection);
+        connect(this, SIGNAL(socketDisconnected(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)), Core::instance()->oidentdConfigGenerator(), SLOT(removeSocket(const CoreIdentity*, QHostAddress, quint16, QHostAddress, quint16)), Qt::DirectConnection);
     }
 }
 
@@ -257,8 +259,11 @@ void CoreNetwork::putRawLine(QByteArray s)
 {
     if (_tokenBucket > 0)
         writeToSocket(s);
-    else
+    else {
         _msgQueue.append(s);
+        if (Metrics::isEnabled())
+            Metrics::setGauge("quassel_irc_send_queue_length", metricsLabels(), _msgQueue.count());
+    }
 }
 
 
@@ -319,15 +324,11 @@ void CoreNetwork::removeChannelKey(const QString &channel)
 }
 
 
-#ifdef HAVE_QCA2
 Cipher *CoreNetwork::cipher(const QString &target)
 {
     if (target.isEmpty())
         return 0;
 
-    if (!Cipher::neededFeaturesAvailable())
-        return 0;
-
     CoreIrcChannel *channel = qobject_cast<CoreIrcChannel *>(ircChannel(target));
     if (channel) {
         return channel->cipher();
@@ -386,7 +387,7 @@ bool CoreNetwork::cipherUsesCBC(const QString &target)
 
     return false;
 }
-#endif /* HAVE_QCA2 */
+
 
 bool CoreNetwork::setAutoWhoDone(const QString &channel)
 {
@@ -409,7 +410,9 @@ void CoreNetwork::setMyNick(const QString &mynick)
 
 void CoreNetwork::socketHasData()
 {
+    int lines = 0;
     while (socket.canReadLine()) {
+        lines++;
         QByteArray s = socket.readLine();
         s.chop(2);
         NetworkDataEvent *event = new NetworkDataEvent(EventManager::NetworkIncoming, this, s);
@@ -420,6 +423,8 @@ void CoreNetwork::socketHasData()
 #endif
         emit newEvent(event);
     }
+    if (Metrics::isEnabled())
+        Metrics::increment("quassel_irc_lines_received_total", metricsLabels(), lines);
 }
 
 
@@ -456,7 +461,9 @@ void CoreNetwork::socketInitialized()
         return;
     }
 
-    emit socketInitialized(identity, localAddress(), localPort(), peerAddress(), peerPort());
+    // the socket forgets its port once it is closed, but we need it to tell oidentd about the disconnect
+    _socketLocalPort = localPort();
+    emit socketInitialized(identity, localAddress(), _socketLocalPort, peerAddress(), peerPort());
 
     // TokenBucket to avoid sending too much at once
     _messageDelay = 2200;  // this seems to be a safe value (2.2 seconds delay)
@@ -505,7 +512,8 @@ void CoreNetwork::socketDisconnected()
 
     setConnected(false);
     emit disconnected(networkId());
-    emit socketDisconnected(identityPtr(), localAddress(), localPort(), peerAddress(), peerPort());
+    emit socketDisconnected(identityPtr(), localAddress(), _socketLocalPort, peerAddress(), peerPort());
+    _socketLocalPort = 0;
     if (_quitRequested) {
         _quitRequested = false;
         setConnectionState(Network::Disconnected);
@@ -916,9 +924,12 @@ void CoreNetwork::fillBucketAndProcessQueue()
         _tokenBucket++;
     }
 
+    int queued = _msgQueue.count();
     while (_msgQueue.size() > 0 && _tokenBucket > 0) {
         writeToSocket(_msgQueue.takeFirst());
     }
+    if (Metrics::isEnabled() && _msgQueue.count() != queued)
+        Metrics::setGauge("quassel_irc_send_queue_length", metricsLabels(), _msgQueue.count());
 }
 
 
@@ -927,6 +938,14 @@ void CoreNetwork::writeToSocket(const QByteArray &data)
     socket.write(data);
     socket.write("\r\n");
     _tokenBucket--;
+    if (Metrics::isEnabled())
+        Metrics::increment("quassel_irc_lines_sent_total", metricsLabels());
+}
+
+
+QString CoreNetwork::metricsLabels() const
+{
+    return Metrics::labels("user", QString::number(userId().toInt()), "network", QString::number(networkId().toInt()));
 }
 
 
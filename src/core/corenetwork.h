@@ -34,9 +34,7 @@
 # include <QTcpSocket>
 #endif
 
-#ifdef HAVE_QCA2
-#  include "cipher.h"
-#endif
+#include "cipher.h"
 
 #include "coresession.h"
 
@@ -119,12 +117,10 @@ public slots:
     void removeChannelKey(const QString &channel);
 
     // Blowfish stuff
-#ifdef HAVE_QCA2
     Cipher *cipher(const QString &recipient);
     QByteArray cipherKey(const QString &recipient) const;
     void setCipherKey(const QString &recipient, const QByteArray &key);
     bool cipherUsesCBC(const QString &target);
-#endif
 
     void setAutoWhoEnabled(bool enabled);
     void setAutoWhoInterval(int interval);
@@ -197,6 +193,8 @@ private slots:
     void writeToSocket(const QByteArray &data);
 
 private:
+    QString metricsLabels() const;
+
     CoreSession *_coreSession;
 
 #ifdef HAVE_SSL
@@ -222,6 +220,7 @@ private:
 
     bool _previousConnectionAttemptFailed;
     int _lastUsedServerIndex;
+    quint16 _socketLocalPort;
 
     QTimer _pingTimer;
     uint _lastPingTime;
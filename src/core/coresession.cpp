@@ -21,11 +21,14 @@
 #include "coresession.h"
 
 #include <QtScript>
+#include <QUuid>
 
+#include "bufferviewconfig.h"
 #include "core.h"
 #include "coreuserinputhandler.h"
 #include "corebuffersyncer.h"
 #include "corebacklogmanager.h"
+#include "corebacklogpruner.h"
 #include "corebufferviewmanager.h"
 #include "coreeventmanager.h"
 #include "coreidentity.h"
@@ -44,7 +47,11 @@
 #include "ircuser.h"
 #include "logger.h"
 #include "messageevent.h"
+#include "metrics.h"
+#include "protocols/datastream/datastreampeer.h"
+#include "quassel.h"
 #include "remotepeer.h"
+#include "sessionjournal.h"
 #include "storage.h"
 #include "util.h"
 
@@ -63,6 +70,7 @@ CoreSession::CoreSession(UserId uid, bool restoreState, QObject *parent)
     _aliasManager(this),
     _bufferSyncer(new CoreBufferSyncer(this)),
     _backlogManager(new CoreBacklogManager(this)),
+    _backlogPruner(new CoreBacklogPruner(this)),
     _bufferViewManager(new CoreBufferViewManager(_signalProxy, this)),
     _ircListHelper(new CoreIrcListHelper(this)),
     _networkConfig(new CoreNetworkConfig("GlobalNetworkConfig", this)),
@@ -75,7 +83,9 @@ CoreSession::CoreSession(UserId uid, bool restoreState, QObject *parent)
     _ircParser(new IrcParser(this)),
     scriptEngine(new QScriptEngine(this)),
     _processMessages(false),
-    _ignoreListManager(this)
+    _ignoreListManager(this),
+    _highlightRuleManager(this),
+    _messageCache(Quassel::optionValue("backlog-cache-depth").toInt(), (qint64)Quassel::optionValue("backlog-cache-memory").toInt() * 1024 * 1024)
 {
     SignalProxy *p = signalProxy();
     p->setHeartBeatInterval(30);
@@ -114,6 +124,7 @@ CoreSession::CoreSession(UserId uid, bool restoreState, QObject *parent)
 
     // periodically save our session state
     connect(&(Core::instance()->syncTimer()), SIGNAL(timeout()), this, SLOT(saveSessionState()));
+    connect(&(Core::instance()->syncTimer()), SIGNAL(timeout()), this, SLOT(expireJournals()));
 
     p->synchronize(_bufferSyncer);
     p->synchronize(&aliasManager());
@@ -122,6 +133,7 @@ CoreSession::CoreSession(UserId uid, bool restoreState, QObject *parent)
     p->synchronize(networkConfig());
     p->synchronize(&_coreInfo);
     p->synchronize(&_ignoreListManager);
+    p->synchronize(&_highlightRuleManager);
     p->synchronize(transferManager());
     // Restore session state
     if (restoreState)
@@ -134,6 +146,10 @@ CoreSession::CoreSession(UserId uid, bool restoreState, QObject *parent)
 CoreSession::~CoreSession()
 {
     saveSessionState();
+    foreach(SessionJournal *journal, _journals) {
+        signalProxy()->removeJournal(journal);
+        delete journal;
+    }
     foreach(CoreNetwork *net, _networks.values()) {
         delete net;
     }
@@ -204,15 +220,68 @@ void CoreSession::restoreSessionState()
     foreach(NetworkId id, nets) {
         net = network(id);
         Q_ASSERT(net);
-        net->connectToIrc();
+        // spread out the connects of all sessions being restored
+        QTimer::singleShot(Core::networkConnectDelay(), net, SLOT(connectToIrc()));
     }
 }
 
 
 void CoreSession::addClient(RemotePeer *peer)
 {
-    peer->dispatch(sessionState());
+    bool resumable = peer->protocol() == Protocol::DataStreamProtocol && (peer->enabledFeatures() & DataStreamPeer::SessionResume);
+    if (resumable && !peer->resumeToken().isEmpty() && resumeSession(peer))
+        return;
+
+    Protocol::SessionState state = sessionState();
+    if (peer->protocol() == Protocol::DataStreamProtocol && (peer->enabledFeatures() & DataStreamPeer::SessionSnapshot))
+        state.initDataSnapshot = initDataSnapshot();
+
+    SessionJournal *journal = 0;
+    if (resumable) {
+        journal = new SessionJournal(QUuid::createUuid().toString().toLatin1());
+        _journals[journal->token()] = journal;
+        state.resumeToken = journal->token();
+    }
+
+    peer->dispatch(state);
+    signalProxy()->addPeer(peer);
+    if (journal)
+        signalProxy()->setJournal(peer, journal);
+}
+
+
+bool CoreSession::resumeSession(RemotePeer *peer)
+{
+    SessionJournal *journal = _journals.value(peer->resumeToken());
+    if (!journal)
+        return false;
+
+    if (!journal->canReplayFrom(peer->resumeSequence())) {
+        // the client missed too much, so it starts over with a new session
+        quInfo() << qPrintable(tr("Client")) << peer->description() << qPrintable(tr("could not resume its session, synchronizing from scratch (UserId: %1).").arg(user().toInt()));
+        _journals.remove(journal->token());
+        signalProxy()->removeJournal(journal);
+        delete journal;
+        return false;
+    }
+
+    // the client's old connection may not have timed out yet, but it won't be used anymore
+    Peer *oldPeer = journal->peer();
+
+    Protocol::SessionState state;
+    state.resumeToken = journal->token();
+    state.resumed = true;
+    peer->dispatch(state);
     signalProxy()->addPeer(peer);
+    signalProxy()->setJournal(peer, journal);
+    int count = journal->replay(peer, peer->resumeSequence());
+
+    RemotePeer *oldRemotePeer = qobject_cast<RemotePeer *>(oldPeer);
+    if (oldRemotePeer)
+        oldRemotePeer->close(tr("Session was resumed by another connection"));
+
+    quInfo() << qPrintable(tr("Client")) << peer->description() << qPrintable(tr("resumed its session, replaying %1 messages (UserId: %2).").arg(count).arg(user().toInt()));
+    return true;
 }
 
 
@@ -223,6 +292,23 @@ void CoreSession::addClient(InternalPeer *peer)
 }
 
 
+void CoreSession::expireJournals()
+{
+    QDateTime now = QDateTime::currentDateTime();
+    QHash<QByteArray, SessionJournal *>::iterator it = _journals.begin();
+    while (it != _journals.end()) {
+        SessionJournal *journal = it.value();
+        if (!journal->peer() && journal->detachedSince().secsTo(now) > journalExpirySecs) {
+            signalProxy()->removeJournal(journal);
+            delete journal;
+            it = _journals.erase(it);
+        }
+        else
+            ++it;
+    }
+}
+
+
 void CoreSession::removeClient(Peer *peer)
 {
     RemotePeer *p = qobject_cast<RemotePeer *>(peer);
@@ -310,8 +396,18 @@ void CoreSession::customEvent(QEvent *event)
 }
 
 
+void CoreSession::checkForHighlight(Message &msg)
+{
+    if (_highlightRuleManager.match(msg, network(msg.bufferInfo().networkId())))
+        msg.setFlags(msg.flags() | Message::Highlight);
+}
+
+
 void CoreSession::processMessages()
 {
+    Metrics::Timer timer;
+    int messageCount = _messageQueue.count();
+
     if (_messageQueue.count() == 1) {
         const RawMessage &rawMsg = _messageQueue.first();
         bool createBuffer = !(rawMsg.flags & Message::Redirected);
@@ -321,7 +417,10 @@ void CoreSession::processMessages()
             bufferInfo = Core::bufferInfo(user(), rawMsg.networkId, BufferInfo::StatusBuffer, "");
         }
         Message msg(bufferInfo, rawMsg.type, rawMsg.text, rawMsg.sender, rawMsg.flags);
+        checkForHighlight(msg);
         Core::storeMessage(msg);
+        _messageCache.insert(msg);
+        _bufferSyncer->messageStored(msg);
         emit displayMsg(msg);
     }
     else {
@@ -345,6 +444,7 @@ void CoreSession::processMessages()
                 bufferInfoCache[rawMsg.networkId][rawMsg.target] = bufferInfo;
             }
             Message msg(bufferInfo, rawMsg.type, rawMsg.text, rawMsg.sender, rawMsg.flags);
+            checkForHighlight(msg);
             messages << msg;
         }
 
@@ -361,17 +461,36 @@ void CoreSession::processMessages()
                 bufferInfoCache[rawMsg.networkId][rawMsg.target] = bufferInfo;
             }
             Message msg(bufferInfo, rawMsg.type, rawMsg.text, rawMsg.sender, rawMsg.flags);
+            checkForHighlight(msg);
             messages << msg;
         }
 
         Core::storeMessages(messages);
         // FIXME: extend protocol to a displayMessages(MessageList)
         for (int i = 0; i < messages.count(); i++) {
+            _messageCache.insert(messages[i]);
+            _bufferSyncer->messageStored(messages[i]);
             emit displayMsg(messages[i]);
         }
     }
     _processMessages = false;
     _messageQueue.clear();
+
+    if (Metrics::isEnabled()) {
+        QString labels = Metrics::labels("user", QString::number(user().toInt()));
+        Metrics::increment("quassel_session_messages_stored_total", labels, messageCount);
+        Metrics::observe("quassel_session_process_messages_seconds", labels, timer.elapsed());
+    }
+}
+
+
+bool CoreSession::clientsSupport(Quassel::Features features) const
+{
+    foreach(Peer *peer, signalProxy()->peers()) {
+        if ((peer->features() & features) != features)
+            return false;
+    }
+    return true;
 }
 
 
@@ -392,6 +511,22 @@ Protocol::SessionState CoreSession::sessionState() const
 }
 
 
+QVariantList CoreSession::initDataSnapshot()
+{
+    // identities are already part of the session state, and IrcUsers and IrcChannels are contained in
+    // their network's init data
+    QList<SyncableObject *> objects;
+    foreach(CoreNetwork *net, _networks)
+        objects << net;
+    objects << _bufferSyncer << _bufferViewManager;
+    foreach(BufferViewConfig *config, _bufferViewManager->bufferViewConfigs())
+        objects << config;
+    objects << &_aliasManager << _networkConfig << &_ignoreListManager << &_highlightRuleManager << _transferManager;
+
+    return _signalProxy->initDataSnapshot(objects);
+}
+
+
 void CoreSession::initScriptEngine()
 {
     signalProxy()->attachSlot(SIGNAL(scriptRequest(QString)), this, SLOT(scriptRequest(QString)));
@@ -549,6 +684,7 @@ void CoreSession::destroyNetwork(NetworkId id)
         }
         // remove buffers from syncer
         foreach(BufferId bufferId, removedBuffers) {
+            _messageCache.invalidate(bufferId);
             _bufferSyncer->removeBuffer(bufferId);
         }
         emit networkRemoved(id);
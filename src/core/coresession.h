@@ -26,12 +26,16 @@
 
 #include "corecoreinfo.h"
 #include "corealiasmanager.h"
+#include "corehighlightrulemanager.h"
 #include "coreignorelistmanager.h"
+#include "coremessagecache.h"
 #include "protocol.h"
 #include "message.h"
+#include "quassel.h"
 #include "storage.h"
 
 class CoreBacklogManager;
+class CoreBacklogPruner;
 class CoreBufferSyncer;
 class CoreBufferViewManager;
 class CoreIdentity;
@@ -49,6 +53,7 @@ class Peer;
 class MessageEvent;
 class NetworkConnection;
 class RemotePeer;
+class SessionJournal;
 class SignalProxy;
 
 struct NetworkInfo;
@@ -74,6 +79,9 @@ public:
 
     inline SignalProxy *signalProxy() const { return _signalProxy; }
 
+    //! Check if all connected clients support the given features
+    bool clientsSupport(Quassel::Features features) const;
+
     const AliasManager &aliasManager() const { return _aliasManager; }
     AliasManager &aliasManager() { return _aliasManager; }
 
@@ -86,7 +94,11 @@ public:
     inline CoreIrcListHelper *ircListHelper() const { return _ircListHelper; }
 
     inline CoreIgnoreListManager *ignoreListManager() { return &_ignoreListManager; }
+    inline CoreHighlightRuleManager *highlightRuleManager() { return &_highlightRuleManager; }
     inline CoreTransferManager *transferManager() const { return _transferManager; }
+    inline CoreMessageCache *messageCache() { return &_messageCache; }
+    inline CoreBufferSyncer *bufferSyncer() const { return _bufferSyncer; }
+    inline CoreBacklogPruner *backlogPruner() const { return _backlogPruner; }
 
 //   void attachNetworkConnection(NetworkConnection *conn);
 
@@ -177,9 +189,17 @@ private slots:
     void updateIdentityBySender();
 
     void saveSessionState() const;
+    void expireJournals();
 
 private:
     void processMessages();
+    void checkForHighlight(Message &msg);
+
+    //! The init data of all objects a client synchronizes right after login
+    QVariantList initDataSnapshot();
+
+    //! Continues the client's previous session if the journal still covers what it missed
+    bool resumeSession(RemotePeer *peer);
 
     void loadSettings();
     void initScriptEngine();
@@ -198,6 +218,7 @@ private:
 
     CoreBufferSyncer *_bufferSyncer;
     CoreBacklogManager *_backlogManager;
+    CoreBacklogPruner *_backlogPruner;
     CoreBufferViewManager *_bufferViewManager;
     CoreIrcListHelper *_ircListHelper;
     CoreNetworkConfig *_networkConfig;
@@ -215,6 +236,12 @@ private:
     QList<RawMessage> _messageQueue;
     bool _processMessages;
     CoreIgnoreListManager _ignoreListManager;
+    CoreHighlightRuleManager _highlightRuleManager;
+    CoreMessageCache _messageCache;
+
+    // journals of resumable client sessions, by resume token
+    QHash<QByteArray, SessionJournal *> _journals;
+    static const int journalExpirySecs = 600;
 };
 
 
@@ -411,9 +411,9 @@ void CoreSessionEventProcessor::processIrcEventQuit(IrcEvent *e)
         else {
             n = _netsplits[e->network()][msg];
         }
-        // add this user to the netsplit
-        n->userQuit(e->prefix(), ircuser->channels(), msg);
-        e->setFlag(EventManager::Netsplit);
+        // add this user to the netsplit, unless the netsplit is already tracking too many users
+        if (n->userQuit(e->prefix(), ircuser->channels(), msg))
+            e->setFlag(EventManager::Netsplit);
     }
     // normal quit is handled in lateProcessIrcEventQuit()
 }
@@ -446,7 +446,7 @@ void CoreSessionEventProcessor::processIrcEventTopic(IrcEvent *e)
 #ifdef HAVE_QCA2
 void CoreSessionEventProcessor::processKeyEvent(KeyEvent *e)
 {
-    if (!Cipher::neededFeaturesAvailable()) {
+    if (!Cipher::keyExchangeAvailable()) {
         emit newEvent(new MessageEvent(Message::Error, e->network(), tr("Unable to perform key exchange, missing qca-ossl plugin."), e->prefix(), e->target(), Message::None, e->timestamp()));
         return;
     }
@@ -891,18 +891,16 @@ void CoreSessionEventProcessor::handleNetsplitJoin(Network *net,
         return;
     }
     QList<IrcUser *> ircUsers;
-    QStringList newModes = modes;
-    QStringList newUsers = users;
-
-    foreach(const QString &user, users) {
-        IrcUser *iu = net->ircUser(nickFromMask(user));
-        if (iu)
-            ircUsers.append(iu);
-        else { // the user already quit
-            int idx = users.indexOf(user);
-            newUsers.removeAt(idx);
-            newModes.removeAt(idx);
-        }
+    QStringList newModes;
+    QStringList newUsers;
+
+    for (int i = 0; i < users.count(); i++) {
+        IrcUser *iu = net->ircUser(nickFromMask(users[i]));
+        if (!iu) // the user already quit
+            continue;
+        ircUsers.append(iu);
+        newUsers.append(users[i]);
+        newModes.append(modes.value(i));
     }
 
     ircChannel->joinIrcUsers(ircUsers, newModes);
@@ -915,10 +913,27 @@ void CoreSessionEventProcessor::handleNetsplitQuit(Network *net, const QString &
 {
     NetworkSplitEvent *event = new NetworkSplitEvent(EventManager::NetworkSplitQuit, net, channel, users, quitMessage);
     emit newEvent(event);
-    foreach(QString user, users) {
-        IrcUser *iu = net->ircUser(nickFromMask(user));
-        if (iu)
-            iu->quit();
+
+    if (coreSession()->clientsSupport(Quassel::BatchedChannelParts)) {
+        // one sync call for the channel; users are dropped along with the last channel they split from
+        IrcChannel *ircChannel = net->ircChannel(channel);
+        if (!ircChannel)
+            return;
+        QList<IrcUser *> ircUsers;
+        foreach(QString user, users) {
+            IrcUser *iu = net->ircUser(nickFromMask(user));
+            if (iu)
+                ircUsers.append(iu);
+        }
+        ircChannel->partIrcUsers(ircUsers);
+    }
+    else {
+        // older clients only know how to sync single users
+        foreach(QString user, users) {
+            IrcUser *iu = net->ircUser(nickFromMask(user));
+            if (iu)
+                iu->quit();
+        }
     }
 }
 
@@ -932,18 +947,16 @@ void CoreSessionEventProcessor::handleEarlyNetsplitJoin(Network *net, const QStr
     }
     QList<NetworkEvent *> events;
     QList<IrcUser *> ircUsers;
-    QStringList newModes = modes;
-
-    foreach(QString user, users) {
-        IrcUser *iu = net->updateNickFromMask(user);
-        if (iu) {
-            ircUsers.append(iu);
-            // fake event for scripts that consume join events
-            events << new IrcEvent(EventManager::IrcEventJoin, net, iu->hostmask(), QStringList() << channel);
-        }
-        else {
-            newModes.removeAt(users.indexOf(user));
-        }
+    QStringList newModes;
+
+    for (int i = 0; i < users.count(); i++) {
+        IrcUser *iu = net->updateNickFromMask(users[i]);
+        if (!iu)
+            continue;
+        ircUsers.append(iu);
+        newModes.append(modes.value(i));
+        // fake event for scripts that consume join events
+        events << new IrcEvent(EventManager::IrcEventJoin, net, iu->hostmask(), QStringList() << channel);
     }
     ircChannel->joinIrcUsers(ircUsers, newModes);
     foreach(NetworkEvent *event, events) {
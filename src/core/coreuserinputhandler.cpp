@@ -26,9 +26,7 @@
 
 #include <QRegExp>
 
-#ifdef HAVE_QCA2
-#  include "cipher.h"
-#endif
+#include "cipher.h"
 
 CoreUserInputHandler::CoreUserInputHandler(CoreNetwork *parent)
     : CoreBasicHandler(parent)
@@ -185,15 +183,9 @@ void CoreUserInputHandler::handleCtcp(const BufferInfo &bufferInfo, const QStrin
 void CoreUserInputHandler::handleDelkey(const BufferInfo &bufferInfo, const QString &msg)
 {
     QString bufname = bufferInfo.bufferName().isNull() ? "" : bufferInfo.bufferName();
-#ifdef HAVE_QCA2
     if (!bufferInfo.isValid())
         return;
 
-    if (!Cipher::neededFeaturesAvailable()) {
-        emit displayMsg(Message::Error, typeByTarget(bufname), bufname, tr("Error: QCA provider plugin not found. It is usually provided by the qca-ossl plugin."));
-        return;
-    }
-
     QStringList parms = msg.split(' ', QString::SkipEmptyParts);
 
     if (parms.isEmpty() && !bufferInfo.bufferName().isEmpty() && bufferInfo.acceptsRegularMessages())
@@ -214,14 +206,6 @@ void CoreUserInputHandler::handleDelkey(const BufferInfo &bufferInfo, const QStr
 
     network()->setCipherKey(target, QByteArray());
     emit displayMsg(Message::Info, typeByTarget(bufname), bufname, tr("The key for %1 has been deleted.").arg(target));
-
-#else
-    Q_UNUSED(msg)
-    emit displayMsg(Message::Error, typeByTarget(bufname), bufname, tr("Error: Setting an encryption key requires Quassel to have been built "
-                                                                    "with support for the Qt Cryptographic Architecture (QCA2) library. "
-                                                                    "Contact your distributor about a Quassel package with QCA2 "
-                                                                    "support, or rebuild Quassel with QCA2 present."));
-#endif
 }
 
 void CoreUserInputHandler::doMode(const BufferInfo &bufferInfo, const QChar& addOrRemove, const QChar& mode, const QString &nicks)
@@ -360,7 +344,7 @@ void CoreUserInputHandler::handleKeyx(const BufferInfo &bufferInfo, const QStrin
     if (!bufferInfo.isValid())
         return;
 
-    if (!Cipher::neededFeaturesAvailable()) {
+    if (!Cipher::keyExchangeAvailable()) {
         emit displayMsg(Message::Error, typeByTarget(bufname), bufname, tr("Error: QCA provider plugin not found. It is usually provided by the qca-ossl plugin."));
         return;
     }
@@ -479,11 +463,7 @@ void CoreUserInputHandler::handleMsg(const BufferInfo &bufferInfo, const QString
     QString target = msg.section(' ', 0, 0);
     QByteArray encMsg = userEncode(target, msg.section(' ', 1));
 
-#ifdef HAVE_QCA2
     putPrivmsg(serverEncode(target), encMsg, network()->cipher(target));
-#else
-    putPrivmsg(serverEncode(target), encMsg);
-#endif
 }
 
 
@@ -589,11 +569,7 @@ void CoreUserInputHandler::handleSay(const BufferInfo &bufferInfo, const QString
         return;  // server buffer
 
     QByteArray encMsg = channelEncode(bufferInfo.bufferName(), msg);
-#ifdef HAVE_QCA2
     putPrivmsg(serverEncode(bufferInfo.bufferName()), encMsg, network()->cipher(bufferInfo.bufferName()));
-#else
-    putPrivmsg(serverEncode(bufferInfo.bufferName()), encMsg);
-#endif
     emit displayMsg(Message::Plain, bufferInfo.type(), bufferInfo.bufferName(), msg, network()->myNick(), Message::Self);
 }
 
@@ -601,15 +577,9 @@ void CoreUserInputHandler::handleSay(const BufferInfo &bufferInfo, const QString
 void CoreUserInputHandler::handleSetkey(const BufferInfo &bufferInfo, const QString &msg)
 {
     QString bufname = bufferInfo.bufferName().isNull() ? "" : bufferInfo.bufferName();
-#ifdef HAVE_QCA2
     if (!bufferInfo.isValid())
         return;
 
-    if (!Cipher::neededFeaturesAvailable()) {
-        emit displayMsg(Message::Error, typeByTarget(bufname), bufname, tr("Error: QCA provider plugin not found. It is usually provided by the qca-ossl plugin."));
-        return;
-    }
-
     QStringList parms = msg.split(' ', QString::SkipEmptyParts);
 
     if (parms.count() == 1 && !bufferInfo.bufferName().isEmpty() && bufferInfo.acceptsRegularMessages())
@@ -626,28 +596,15 @@ void CoreUserInputHandler::handleSetkey(const BufferInfo &bufferInfo, const QStr
     network()->setCipherKey(target, key);
 
     emit displayMsg(Message::Info, typeByTarget(bufname), bufname, tr("The key for %1 has been set.").arg(target));
-#else
-    Q_UNUSED(msg)
-    emit displayMsg(Message::Error, typeByTarget(bufname), bufname, tr("Error: Setting an encryption key requires Quassel to have been built "
-                                                                "with support for the Qt Cryptographic Architecture (QCA) library. "
-                                                                "Contact your distributor about a Quassel package with QCA "
-                                                                "support, or rebuild Quassel with QCA present."));
-#endif
 }
 
 
 void CoreUserInputHandler::handleShowkey(const BufferInfo &bufferInfo, const QString &msg)
 {
     QString bufname = bufferInfo.bufferName().isNull() ? "" : bufferInfo.bufferName();
-#ifdef HAVE_QCA2
     if (!bufferInfo.isValid())
         return;
 
-    if (!Cipher::neededFeaturesAvailable()) {
-        emit displayMsg(Message::Error, typeByTarget(bufname), bufname, tr("Error: QCA provider plugin not found. It is usually provided by the qca-ossl plugin."));
-        return;
-    }
-
     QStringList parms = msg.split(' ', QString::SkipEmptyParts);
 
     if (parms.isEmpty() && !bufferInfo.bufferName().isEmpty() && bufferInfo.acceptsRegularMessages())
@@ -667,14 +624,6 @@ void CoreUserInputHandler::handleShowkey(const BufferInfo &bufferInfo, const QSt
     }
 
     emit displayMsg(Message::Info, typeByTarget(bufname), bufname, tr("The key for %1 is %2:%3").arg(target, network()->cipherUsesCBC(target) ? "CBC" : "ECB", QString(key)));
-
-#else
-    Q_UNUSED(msg)
-    emit displayMsg(Message::Error, typeByTarget(bufname), bufname, tr("Error: Setting an encryption key requires Quassel to have been built "
-                                                                    "with support for the Qt Cryptographic Architecture (QCA2) library. "
-                                                                    "Contact your distributor about a Quassel package with QCA2 "
-                                                                    "support, or rebuild Quassel with QCA2 present."));
-#endif
 }
 
 
@@ -687,11 +636,7 @@ void CoreUserInputHandler::handleTopic(const BufferInfo &bufferInfo, const QStri
     params << serverEncode(bufferInfo.bufferName());
 
     if (!msg.isEmpty()) {
-#   ifdef HAVE_QCA2
         params << encrypt(bufferInfo.bufferName(), channelEncode(bufferInfo.bufferName(), msg));
-#   else
-        params << channelEncode(bufferInfo.bufferName(), msg);
-#   endif
     }
 
     emit putCmd("TOPIC", params);
@@ -759,59 +704,55 @@ void CoreUserInputHandler::defaultHandler(QString cmd, const BufferInfo &bufferI
 
 void CoreUserInputHandler::putPrivmsg(const QByteArray &target, const QByteArray &message, Cipher *cipher)
 {
-    // Encrypted messages need special care. There's no clear relation between cleartext and encrypted message length,
-    // so we can't just compute the maxSplitPos. Instead, we need to loop through the splitpoints until the crypted
-    // version is short enough...
-    // TODO: check out how the various possible encryption methods behave length-wise and make
-    //       this clean by predicting the length of the crypted msg.
-    //       For example, blowfish-ebc seems to create 8-char chunks.
-
     static const char *cmd = "PRIVMSG";
     static const char *splitter = " .,-";
 
-    int maxSplitPos = message.count();
-    int splitPos = maxSplitPos;
-    forever {
-        QByteArray crypted = message.left(splitPos);
-        bool isEncrypted = false;
-#ifdef HAVE_QCA2
-        if (cipher && !cipher->key().isEmpty() && !message.isEmpty()) {
-            isEncrypted = cipher->encrypt(crypted);
-        }
-#endif
-        int overrun = lastParamOverrun(cmd, QList<QByteArray>() << target << crypted);
-        if (overrun) {
-            // In case this is not an encrypted msg, we can just cut off at the end
-            if (!isEncrypted)
-                maxSplitPos = message.count() - overrun;
-
-            splitPos = -1;
-            for (const char *splitChar = splitter; *splitChar != 0; splitChar++) {
-                splitPos = qMax(splitPos, message.lastIndexOf(*splitChar, maxSplitPos) + 1); // keep split char on old line
-            }
-            if (splitPos <= 0 || splitPos > maxSplitPos)
-                splitPos = maxSplitPos;
+    bool encrypt = cipher && !cipher->key().isEmpty() && !message.isEmpty();
 
-            maxSplitPos = splitPos - 1;
-            if (maxSplitPos <= 0) { // this should never happen, but who knows...
-                qWarning() << tr("[Error] Could not encrypt your message: %1").arg(message.data());
-                return;
-            }
-            continue; // we never come back here for !encrypted!
-        }
+    // Blowfish works on 8 byte blocks with a fixed encoding, so the cipher can tell us exactly how
+    // much cleartext fits into the line before encrypting anything
+    int maxLength = lastParamMaxLength(cmd, QList<QByteArray>() << target);
+    int maxSplitPos = encrypt ? cipher->maxPlainLength(message, maxLength) : maxLength;
+    if (maxSplitPos <= 0) { // this should never happen, but who knows...
+        qWarning() << tr("[Error] Could not send your message: %1").arg(message.data());
+        return;
+    }
 
-        // now we have found a valid splitpos (or didn't need to split to begin with)
-        putCmd(cmd, QList<QByteArray>() << target << crypted);
-        if (splitPos < message.count())
-            putPrivmsg(target, message.mid(splitPos), cipher);
+    int splitPos = message.count();
+    if (splitPos > maxSplitPos) {
+        splitPos = -1;
+        for (const char *splitChar = splitter; *splitChar != 0; splitChar++) {
+            splitPos = qMax(splitPos, message.lastIndexOf(*splitChar, maxSplitPos - 1) + 1); // keep split char on old line
+        }
+        if (splitPos <= 0)
+            splitPos = maxSplitPos;
+    }
 
+    QByteArray line = message.left(splitPos);
+    if (encrypt && !cipher->encrypt(line)) {
+        qWarning() << tr("[Error] Could not encrypt your message: %1").arg(message.data());
         return;
     }
+
+    putCmd(cmd, QList<QByteArray>() << target << line);
+    if (splitPos < message.count())
+        putPrivmsg(target, message.mid(splitPos), cipher);
 }
 
 
 // returns 0 if the message will not be chopped by the irc server or number of chopped bytes if message is too long
 int CoreUserInputHandler::lastParamOverrun(const QString &cmd, const QList<QByteArray> &params)
+{
+    if (params.isEmpty())
+        return 0;
+
+    int maxLen = lastParamMaxLength(cmd, params.mid(0, params.count() - 1));
+    return qMax(params.last().count() - maxLen, 0);
+}
+
+
+// returns the number of bytes left for the last param after the given leading params
+int CoreUserInputHandler::lastParamMaxLength(const QString &cmd, const QList<QByteArray> &leadingParams)
 {
     // the server will pass our message truncated to 512 bytes including CRLF with the following format:
     // ":prefix COMMAND param0 param1 :lastparam"
@@ -824,26 +765,15 @@ int CoreUserInputHandler::lastParamOverrun(const QString &cmd, const QList<QByte
     if (me)
         maxLen = 512 - serverEncode(me->nick()).count() - serverEncode(me->user()).count() - serverEncode(me->host()).count() - cmd.toLatin1().count() - 6;
 
-    if (!params.isEmpty()) {
-        for (int i = 0; i < params.count() - 1; i++) {
-            maxLen -= (params[i].count() + 1);
-        }
-        maxLen -= 2; // " :" last param separator;
-
-        if (params.last().count() > maxLen) {
-            return params.last().count() - maxLen;
-        }
-        else {
-            return 0;
-        }
-    }
-    else {
-        return 0;
+    foreach(const QByteArray &param, leadingParams) {
+        maxLen -= (param.count() + 1);
     }
+    maxLen -= 2; // " :" last param separator;
+
+    return maxLen;
 }
 
 
-#ifdef HAVE_QCA2
 QByteArray CoreUserInputHandler::encrypt(const QString &target, const QByteArray &message_, bool *didEncrypt) const
 {
     if (didEncrypt)
@@ -852,9 +782,6 @@ QByteArray CoreUserInputHandler::encrypt(const QString &target, const QByteArray
     if (message_.isEmpty())
         return message_;
 
-    if (!Cipher::neededFeaturesAvailable())
-        return message_;
-
     Cipher *cipher = network()->cipher(target);
     if (!cipher || cipher->key().isEmpty())
         return message_;
@@ -868,8 +795,6 @@ QByteArray CoreUserInputHandler::encrypt(const QString &target, const QByteArray
 }
 
 
-#endif
-
 void CoreUserInputHandler::timerEvent(QTimerEvent *event)
 {
     if (!_delayedCommands.contains(event->timerId())) {
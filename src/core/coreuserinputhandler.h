@@ -88,10 +88,9 @@ private:
     void banOrUnban(const BufferInfo &bufferInfo, const QString &text, bool ban);
     void putPrivmsg(const QByteArray &target, const QByteArray &message, Cipher *cipher = 0);
     int lastParamOverrun(const QString &cmd, const QList<QByteArray> &params);
+    int lastParamMaxLength(const QString &cmd, const QList<QByteArray> &leadingParams);
 
-#ifdef HAVE_QCA2
     QByteArray encrypt(const QString &target, const QByteArray &message, bool *didEncrypt = 0) const;
-#endif
 
     struct Command {
         BufferInfo bufferInfo;
@@ -0,0 +1,103 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "metricsserver.h"
+
+#include <QTcpSocket>
+
+#include "logger.h"
+#include "metrics.h"
+
+// we don't care about anything after the request line, but don't let clients fill our memory
+const int maxRequestSize = 8192;
+
+MetricsServer::MetricsServer(quint16 port, QObject *parent)
+    : QObject(parent)
+{
+    Metrics::enable();
+
+    Metrics::describe("quassel_irc_lines_received_total", "Lines received from IRC servers");
+    Metrics::describe("quassel_irc_lines_sent_total", "Lines sent to IRC servers");
+    Metrics::describe("quassel_irc_send_queue_length", "Lines waiting for the flood protection to send them");
+    Metrics::describe("quassel_event_dispatch_seconds", "Time spent dispatching events to their handlers, by event type");
+    Metrics::describe("quassel_event_handler_seconds", "Time spent in event handlers, by handling class (IrcParser, CoreSessionEventProcessor, ...)");
+    Metrics::describe("quassel_event_queue_length", "Events generated while dispatching and waiting to be dispatched");
+    Metrics::describe("quassel_session_messages_stored_total", "Messages stored and forwarded to clients");
+    Metrics::describe("quassel_session_process_messages_seconds", "Time spent storing and forwarding a batch of messages");
+    Metrics::describe("quassel_storage_query_seconds", "Execution time of storage queries, by query name");
+    Metrics::describe("quassel_backlog_pruned_messages_total", "Expired messages removed from the backlog");
+    Metrics::describe("quassel_peer_messages_sent_total", "Protocol messages sent to clients, by protocol and message type");
+    Metrics::describe("quassel_peer_messages_received_total", "Protocol messages received from clients, by protocol and message type");
+    Metrics::describe("quassel_peer_bytes_sent_total", "Uncompressed bytes sent to clients, by protocol");
+    Metrics::describe("quassel_peer_bytes_received_total", "Uncompressed bytes received from clients, by protocol");
+
+    connect(&_server, SIGNAL(newConnection()), this, SLOT(incomingConnection()));
+    if (_server.listen(QHostAddress::LocalHost, port))
+        quInfo() << qPrintable(tr("Serving metrics on http://127.0.0.1:%1/metrics").arg(_server.serverPort()));
+    else
+        quWarning() << qPrintable(tr("Could not open metrics port %1: %2").arg(port).arg(_server.errorString()));
+}
+
+
+void MetricsServer::incomingConnection()
+{
+    while (_server.hasPendingConnections()) {
+        QTcpSocket *socket = _server.nextPendingConnection();
+        connect(socket, SIGNAL(readyRead()), SLOT(readRequest()));
+        connect(socket, SIGNAL(disconnected()), socket, SLOT(deleteLater()));
+    }
+}
+
+
+void MetricsServer::readRequest()
+{
+    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
+    if (!socket)
+        return;
+
+    if (!socket->canReadLine()) {
+        if (socket->bytesAvailable() > maxRequestSize)
+            socket->abort();
+        return;
+    }
+
+    disconnect(socket, SIGNAL(readyRead()), this, SLOT(readRequest()));
+
+    // "GET /metrics HTTP/1.1"
+    QList<QByteArray> request = socket->readLine(maxRequestSize).trimmed().split(' ');
+    if (request.count() < 2 || request.at(0) != "GET")
+        sendResponse(socket, "405 Method Not Allowed", QByteArray());
+    else if (request.at(1) != "/metrics")
+        sendResponse(socket, "404 Not Found", QByteArray());
+    else
+        sendResponse(socket, "200 OK", Metrics::prometheusText());
+}
+
+
+void MetricsServer::sendResponse(QTcpSocket *socket, const QByteArray &status, const QByteArray &body)
+{
+    QByteArray response = "HTTP/1.0 " + status + "\r\n"
+                          "Content-Type: text/plain; version=0.0.4\r\n"
+                          "Content-Length: " + QByteArray::number(body.size()) + "\r\n"
+                          "Connection: close\r\n"
+                          "\r\n";
+    socket->write(response + body);
+    socket->disconnectFromHost();
+}
@@ -0,0 +1,50 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef METRICSSERVER_H
+#define METRICSSERVER_H
+
+#include <QObject>
+#include <QTcpServer>
+
+//! Serves the core's metrics in the Prometheus text format over HTTP
+/** The server only listens on the loopback interface and answers "GET /metrics"; it is meant to
+ *  be scraped by a local Prometheus instance or an agent forwarding the data. Creating the server
+ *  enables recording of metrics (see Metrics::enable()).
+ */
+class MetricsServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    MetricsServer(quint16 port, QObject *parent = 0);
+
+private slots:
+    void incomingConnection();
+    void readRequest();
+
+private:
+    void sendResponse(QTcpSocket *socket, const QByteArray &status, const QByteArray &body);
+
+    QTcpServer _server;
+};
+
+
+#endif
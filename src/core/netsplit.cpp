@@ -26,7 +26,7 @@
 
 Netsplit::Netsplit(Network *network, QObject *parent)
     : QObject(parent),
-    _network(network), _quitMsg(""), _sentQuit(false), _joinCounter(0), _quitCounter(0)
+    _network(network), _quitMsg(""), _trackedUsers(0), _sentQuit(false), _joinCounter(0), _quitCounter(0)
 {
     _discardTimer.setSingleShot(true);
     _joinTimer.setSingleShot(true);
@@ -42,42 +42,47 @@ Netsplit::Netsplit(Network *network, QObject *parent)
 }
 
 
-void Netsplit::userQuit(const QString &sender, const QStringList &channels, const QString &msg)
+bool Netsplit::userQuit(const QString &sender, const QStringList &channels, const QString &msg)
 {
+    // don't let a huge split grow without bounds; everyone beyond the limit simply quits normally
+    if (_trackedUsers + channels.count() > maxTrackedUsers)
+        return false;
+
     if (_quitMsg.isEmpty())
         _quitMsg = msg;
-    foreach(QString channel, channels) {
-        _quits[channel].append(sender);
+    const QString nick = nickFromMask(sender);
+    foreach(const QString &channel, channels) {
+        QHash<QString, QString> &users = _quits[channel];
+        if (!users.contains(nick))
+            _trackedUsers++;
+        users.insert(nick, sender);
+        _pendingQuits[channel].insert(nick);
     }
     _quitCounter++;
     // now let's wait 10s to finish the netsplit-quit
     _quitTimer.start(10000);
+    return true;
 }
 
 
 bool Netsplit::userJoined(const QString &sender, const QString &channel)
 {
-    if (!_quits.contains(channel))
+    QHash<QString, QHash<QString, QString> >::iterator chanIter = _quits.find(channel);
+    if (chanIter == _quits.end())
         return false;
 
-    QStringList &users = _quits[channel];
-
-    QStringList::iterator userIter;
-    const QString senderNick = nickFromMask(sender);
-    for (userIter = users.begin(); userIter != users.end(); ++userIter) {
-        if (nickFromMask(*userIter) == senderNick)
-            break;
-    }
-    if (userIter == users.end())
+    QHash<QString, QString>::iterator userIter = chanIter->find(nickFromMask(sender));
+    if (userIter == chanIter->end())
         return false;
 
-    _joins[channel].first.append(*userIter);
-    _joins[channel].second.append(QString());
+    ChannelJoins &joins = _joins[channel];
+    joins.index.insert(userIter.value(), joins.users.count());
+    joins.users.append(userIter.value());
+    joins.modes.append(QString());
 
-    users.erase(userIter);
-
-    if (users.empty())
-        _quits.remove(channel);
+    chanIter->erase(userIter);
+    if (chanIter->isEmpty())
+        _quits.erase(chanIter);
 
     _joinCounter++;
 
@@ -92,20 +97,20 @@ bool Netsplit::userJoined(const QString &sender, const QString &channel)
 
 bool Netsplit::userAlreadyJoined(const QString &sender, const QString &channel)
 {
-    if (_joins.value(channel).first.contains(sender))
-        return true;
-    return false;
+    QHash<QString, ChannelJoins>::const_iterator joinIter = _joins.constFind(channel);
+    return joinIter != _joins.constEnd() && joinIter->index.contains(sender);
 }
 
 
 void Netsplit::addMode(const QString &sender, const QString &channel, const QString &mode)
 {
-    if (!_joins.contains(channel))
+    QHash<QString, ChannelJoins>::iterator joinIter = _joins.find(channel);
+    if (joinIter == _joins.end())
         return;
-    int idx = _joins.value(channel).first.indexOf(sender);
+    int idx = joinIter->index.value(sender, -1);
     if (idx == -1)
         return;
-    _joins[channel].second[idx].append(mode);
+    joinIter->modes[idx].append(mode);
 }
 
 
@@ -132,7 +137,7 @@ void Netsplit::joinTimeout()
         quitTimeout();
     }
 
-    QHash<QString, QPair<QStringList, QStringList> >::iterator it;
+    QHash<QString, ChannelJoins>::iterator it;
 
     /*
       Try to catch server jumpers.
@@ -143,8 +148,10 @@ void Netsplit::joinTimeout()
       join again.
     */
     if (_joinCounter < _quitCounter/3) {
-        for (it = _joins.begin(); it != _joins.end(); ++it)
-            emit earlyJoin(network(), it.key(), it.value().first, it.value().second);
+        for (it = _joins.begin(); it != _joins.end(); ++it) {
+            emit earlyJoin(network(), it.key(), it->users, it->modes);
+            _trackedUsers -= it->users.count();
+        }
 
         // we don't care about those anymore
         _joins.clear();
@@ -158,7 +165,7 @@ void Netsplit::joinTimeout()
 
     // send netsplitJoin for every recorded channel
     for (it = _joins.begin(); it != _joins.end(); ++it)
-        emit netsplitJoin(network(), it.key(), it.value().first, it.value().second, _quitMsg);
+        emit netsplitJoin(network(), it.key(), it->users, it->modes, _quitMsg);
     _joins.clear();
     _discardTimer.stop();
     emit finished();
@@ -167,21 +174,24 @@ void Netsplit::joinTimeout()
 
 void Netsplit::quitTimeout()
 {
-    // send netsplitQuit for every recorded channel
-    QHash<QString, QStringList>::iterator channelIter;
-    for (channelIter = _quits.begin(); channelIter != _quits.end(); ++channelIter) {
+    // send netsplitQuit for every channel that got new quits since the last timeout
+    QHash<QString, QSet<QString> >::const_iterator pendingIter;
+    for (pendingIter = _pendingQuits.constBegin(); pendingIter != _pendingQuits.constEnd(); ++pendingIter) {
+        QHash<QString, QHash<QString, QString> >::const_iterator chanIter = _quits.constFind(pendingIter.key());
+        if (chanIter == _quits.constEnd())
+            continue;
+
+        // users that joined again in the meantime are no longer in _quits
         QStringList usersToSend;
-
-        foreach(QString user, channelIter.value()) {
-            if (!_quitsWithMessageSent.value(channelIter.key()).contains(user)) {
-                usersToSend << user;
-                _quitsWithMessageSent[channelIter.key()].append(user);
-            }
+        foreach(const QString &nick, pendingIter.value()) {
+            QHash<QString, QString>::const_iterator userIter = chanIter->constFind(nick);
+            if (userIter != chanIter->constEnd())
+                usersToSend << userIter.value();
         }
-        // not yet sure how that could happen, but never send empty netsplit-quits
-        // anyway.
+        // never send empty netsplit-quits
         if (!usersToSend.isEmpty())
-            emit netsplitQuit(network(), channelIter.key(), usersToSend, _quitMsg);
+            emit netsplitQuit(network(), chanIter.key(), usersToSend, _quitMsg);
     }
+    _pendingQuits.clear();
     _sentQuit = true;
 }
@@ -23,7 +23,7 @@
 
 #include <QTimer>
 #include <QHash>
-#include <QPair>
+#include <QSet>
 #include <QStringList>
 
 class Network;
@@ -44,8 +44,9 @@ public:
       * \param sender   The sender string of the quitting user
       * \param channels The channels that user shared with us
       * \param msg      The quit message
+      * \return false if the netsplit is already tracking too many users; handle the quit normally in that case
       */
-    void userQuit(const QString &sender, const QStringList &channels, const QString &msg);
+    bool userQuit(const QString &sender, const QStringList &channels, const QString &msg);
 
     //! Remove a user from the netsplit
     /** Call this method if a user joined after a netsplit occured.
@@ -124,13 +125,22 @@ private slots:
     void quitTimeout();
 
 private:
+    // upper bound for the number of (user, channel) pairs a single netsplit keeps track of
+    static const int maxTrackedUsers = 50000;
+
+    struct ChannelJoins {
+        QStringList users;
+        QStringList modes;
+        QHash<QString, int> index; // sender -> position in users and modes
+    };
+
     Network *_network;
     QString _quitMsg;
     // key: channel name
-    // value: senderstring, list of modes
-    QHash<QString, QPair<QStringList, QStringList> > _joins;
-    QHash<QString, QStringList> _quits;
-    QHash<QString, QStringList> _quitsWithMessageSent;
+    QHash<QString, ChannelJoins> _joins;
+    QHash<QString, QHash<QString, QString> > _quits; // value: nick -> senderstring
+    QHash<QString, QSet<QString> > _pendingQuits; // nicks whose quit has not been emitted yet
+    int _trackedUsers;
     bool _sentQuit;
     QTimer _joinTimer;
     QTimer _quitTimer;
@@ -20,10 +20,16 @@
 
 #include "oidentdconfiggenerator.h"
 
+#include <cstdio>
+
 OidentdConfigGenerator::OidentdConfigGenerator(QObject *parent) :
     QObject(parent),
     _initialized(false)
 {
+    _writeTimer.setSingleShot(true);
+    _writeTimer.setInterval(writeDelay);
+    connect(&_writeTimer, SIGNAL(timeout()), this, SLOT(writeConfig()));
+
     if (!_initialized)
         init();
 }
@@ -31,7 +37,10 @@ OidentdConfigGenerator::OidentdConfigGenerator(QObject *parent) :
 
 OidentdConfigGenerator::~OidentdConfigGenerator()
 {
-    _quasselConfig.clear();
+    _writeTimer.stop();
+    _mutex.lock();
+    _idents.clear();
+    _mutex.unlock();
     writeConfig();
     _configFile->deleteLater();
 }
@@ -59,7 +68,7 @@ bool OidentdConfigGenerator::init()
     _quasselStanzaRx = QRegExp(QString("^lport .* \\{ .* \\} #%1\\r?\\n").arg(_configTag));
 
     // initially remove all Quassel stanzas that might be present
-    if (parseConfig(false) && writeConfig())
+    if (parseConfig() && writeConfig())
         _initialized = true;
 
     return _initialized;
@@ -71,30 +80,45 @@ bool OidentdConfigGenerator::addSocket(const CoreIdentity *identity, const QHost
     Q_UNUSED(localAddress) Q_UNUSED(peerAddress) Q_UNUSED(peerPort)
     QString ident = identity->ident();
 
-    _quasselConfig.append(_quasselStanzaTemplate.arg(localPort).arg(ident).arg(_configTag).toLatin1());
-
-    bool ret = writeConfig();
+    _mutex.lock();
+    _idents[localPort] = ident;
+    _mutex.unlock();
 
-    return ret;
+    // we might be called from a session thread, so let the main thread take care of the file
+    QMetaObject::invokeMethod(this, "scheduleWrite", Qt::QueuedConnection);
+    return true;
 }
 
 
-//! not yet implemented
 bool OidentdConfigGenerator::removeSocket(const CoreIdentity *identity, const QHostAddress &localAddress, quint16 localPort, const QHostAddress &peerAddress, quint16 peerPort)
 {
-    Q_UNUSED(identity) Q_UNUSED(localAddress) Q_UNUSED(localPort) Q_UNUSED(peerAddress) Q_UNUSED(peerPort)
+    Q_UNUSED(identity) Q_UNUSED(localAddress) Q_UNUSED(peerAddress) Q_UNUSED(peerPort)
+
+    _mutex.lock();
+    bool removed = _idents.remove(localPort) > 0;
+    _mutex.unlock();
+
+    if (removed)
+        QMetaObject::invokeMethod(this, "scheduleWrite", Qt::QueuedConnection);
     return true;
 }
 
 
-bool OidentdConfigGenerator::parseConfig(bool readQuasselStanzas)
+void OidentdConfigGenerator::scheduleWrite()
+{
+    // batch all changes arriving within writeDelay into a single rewrite
+    if (!_writeTimer.isActive())
+        _writeTimer.start();
+}
+
+
+bool OidentdConfigGenerator::parseConfig()
 {
     if (!_configFile->exists())
         return true;
 
     if (!_configFile->isOpen() && !_configFile->open(QIODevice::ReadOnly))
         return false;
-    _mutex.lock();
 
     _parsedConfig.clear();
     _configFile->seek(0);
@@ -103,22 +127,30 @@ bool OidentdConfigGenerator::parseConfig(bool readQuasselStanzas)
 
         if (!lineByUs(line))
             _parsedConfig.append(line);
-        else if (readQuasselStanzas)
-            _quasselConfig.append(line);
     }
 
     _configFile->close();
-    _mutex.unlock();
     return true;
 }
 
 
 bool OidentdConfigGenerator::writeConfig()
 {
+    QByteArray quasselConfig;
+    _mutex.lock();
+    QMap<quint16, QString>::const_iterator iter = _idents.constBegin();
+    while (iter != _idents.constEnd()) {
+        quasselConfig.append(_quasselStanzaTemplate.arg(iter.key()).arg(iter.value()).arg(_configTag).toLatin1());
+        ++iter;
+    }
+    _mutex.unlock();
+
+    // write to a temporary file first and rename it over the config, so oidentd never sees a partial file
+    QFile tempFile(_configPath + ".tmp");
 #ifdef HAVE_UMASK
     mode_t prev_umask = umask(S_IXUSR | S_IWGRP | S_IXGRP | S_IWOTH | S_IXOTH); // == 0133, rw-r--r--
 #endif
-    bool not_open = (!_configFile->isOpen() && !_configFile->open(QIODevice::ReadWrite | QIODevice::Text));
+    bool not_open = !tempFile.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text);
 #ifdef HAVE_UMASK
     umask(prev_umask);
 #endif
@@ -126,15 +158,14 @@ bool OidentdConfigGenerator::writeConfig()
     if (not_open)
         return false;
 
-    _mutex.lock();
-
-    _configFile->seek(0);
-    _configFile->resize(0);
-    _configFile->write(_parsedConfig);
-    _configFile->write(_quasselConfig);
+    bool written = tempFile.write(_parsedConfig) == _parsedConfig.size()
+                   && tempFile.write(quasselConfig) == quasselConfig.size();
+    tempFile.close();
 
-    _configFile->close();
-    _mutex.unlock();
+    if (!written || std::rename(QFile::encodeName(tempFile.fileName()).constData(), QFile::encodeName(_configPath).constData()) != 0) {
+        tempFile.remove();
+        return false;
+    }
     return true;
 }
 
@@ -26,8 +26,10 @@
 #include <QFile>
 #include <QDateTime>
 #include <QHostAddress>
+#include <QMap>
 #include <QMutex>
 #include <QByteArray>
+#include <QTimer>
 
 #ifdef HAVE_UMASK
 #  include <sys/types.h>
@@ -41,6 +43,10 @@
 /*!
   Upon IRC connect this class puts the clients' ident data into an oidentd configuration file.
 
+  Sockets are registered in memory from the session threads without blocking them; the file
+  is rewritten from the main thread at most once per writeDelay milliseconds, by writing a
+  temporary file and renaming it over the configuration so oidentd never reads a partial file.
+
   The default path is <~/.oidentd.conf>.
 
   For oidentd to incorporate this file, the global oidentd.conf has to state something like this:
@@ -62,22 +68,29 @@ public:
     ~OidentdConfigGenerator();
 
 public slots:
+    //! Registers the ident for a socket; safe to call from any thread
     bool addSocket(const CoreIdentity *identity, const QHostAddress &localAddress, quint16 localPort, const QHostAddress &peerAddress, quint16 peerPort);
+    //! Unregisters a socket; safe to call from any thread
     bool removeSocket(const CoreIdentity *identity, const QHostAddress &localAddress, quint16 localPort, const QHostAddress &peerAddress, quint16 peerPort);
 
+private slots:
+    void scheduleWrite();
+    bool writeConfig();
+
 private:
     bool init();
-    bool writeConfig();
-    bool parseConfig(bool readQuasselStanzas = false);
+    bool parseConfig();
     bool lineByUs(const QByteArray &line);
 
+    static const int writeDelay = 100;
+
     bool _initialized;
     QDateTime _lastSync;
     QFile *_configFile;
     QByteArray _parsedConfig;
-    QByteArray _quasselConfig;
-    // Mutex isn't strictly necessary at the moment, since with the current invocation in Core only one instance at a time exists
-    QMutex _mutex;
+    QMap<quint16, QString> _idents; // local port -> ident
+    QMutex _mutex; // guards _idents, which is modified from the session threads
+    QTimer _writeTimer;
 
     QDir _configDir;
     QString _configFileName;
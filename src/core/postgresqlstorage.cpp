@@ -22,9 +22,13 @@
 
 #include <QtSql>
 
+#include <limits>
+
 #include "logger.h"
+#include "metrics.h"
 #include "network.h"
 #include "quassel.h"
+#include "util.h"
 
 PostgreSqlStorage::PostgreSqlStorage(QObject *parent)
     : AbstractSqlStorage(parent),
@@ -1340,6 +1344,71 @@ QHash<BufferId, MsgId> PostgreSqlStorage::bufferMarkerLineMsgIds(UserId user)
 }
 
 
+QHash<BufferId, Storage::ActivityCount> PostgreSqlStorage::bufferActivityCounts(UserId user)
+{
+    QHash<BufferId, ActivityCount> countHash;
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::bufferActivityCounts(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return countHash;
+    }
+
+    QSqlQuery query(db);
+    query.prepare(queryString("select_buffer_activity_counts"));
+    query.bindValue(":userid", user.toInt());
+    query.bindValue(":typemask", unreadMessageTypes);
+    query.bindValue(":selfflag", (int)Message::Self);
+    query.bindValue(":highlightflag", (int)Message::Highlight);
+    safeExec(query);
+    if (!watchQuery(query)) {
+        db.rollback();
+        return countHash;
+    }
+
+    while (query.next()) {
+        countHash[query.value(0).toInt()] = ActivityCount(query.value(1).toInt(), query.value(2).toInt());
+    }
+
+    db.commit();
+    return countHash;
+}
+
+
+Storage::ActivityCount PostgreSqlStorage::bufferActivityCount(UserId user, BufferId bufferId, MsgId lastSeenMsgId)
+{
+    ActivityCount count;
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::bufferActivityCount(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return count;
+    }
+
+    QSqlQuery query(db);
+    query.prepare(queryString("select_buffer_activity_count"));
+    query.bindValue(":userid", user.toInt());
+    query.bindValue(":bufferid", bufferId.toInt());
+    query.bindValue(":lastseenmsgid", lastSeenMsgId.isValid() ? lastSeenMsgId.toInt() : 0);
+    query.bindValue(":typemask", unreadMessageTypes);
+    query.bindValue(":selfflag", (int)Message::Self);
+    query.bindValue(":highlightflag", (int)Message::Highlight);
+    safeExec(query);
+    if (!watchQuery(query)) {
+        db.rollback();
+        return count;
+    }
+
+    if (query.first())
+        count = ActivityCount(query.value(0).toInt(), query.value(1).toInt());
+
+    db.commit();
+    return count;
+}
+
+
 bool PostgreSqlStorage::logMessage(Message &msg)
 {
     QSqlDatabase db = logDb();
@@ -1349,7 +1418,10 @@ bool PostgreSqlStorage::logMessage(Message &msg)
         return false;
     }
 
-    QSqlQuery getSenderIdQuery = executePreparedQuery("select_senderid", msg.sender(), db);
+    QString sender, host;
+    splitSender(msg.sender(), sender, host);
+
+    QSqlQuery getSenderIdQuery = executePreparedQuery("select_senderid", sender, db);
     int senderId;
     if (getSenderIdQuery.first()) {
         senderId = getSenderIdQuery.value(0).toInt();
@@ -1358,7 +1430,9 @@ bool PostgreSqlStorage::logMessage(Message &msg)
         // it's possible that the sender was already added by another thread
         // since the insert might fail we're setting a savepoint
         savePoint("sender_sp1", db);
-        QSqlQuery addSenderQuery = executePreparedQuery("insert_sender", msg.sender(), db);
+        QVariantList senderParams;
+        senderParams << sender << nickFromMask(sender) << userFromMask(sender);
+        QSqlQuery addSenderQuery = executePreparedQuery("insert_sender", senderParams, db);
 
         if (addSenderQuery.lastError().isValid()) {
             rollbackSavePoint("sender_sp1", db);
@@ -1373,13 +1447,17 @@ bool PostgreSqlStorage::logMessage(Message &msg)
         }
     }
 
+    QVariant message, messageData;
+    encodeContents(msg.contents(), message, messageData);
     QVariantList params;
     params << msg.timestamp()
            << msg.bufferInfo().bufferId().toInt()
            << msg.type()
            << (int)msg.flags()
            << senderId
-           << msg.contents();
+           << senderHostId(host, db)
+           << message
+           << messageData;
     QSqlQuery logMessageQuery = executePreparedQuery("insert_message", params, db);
 
     if (!watchQuery(logMessageQuery)) {
@@ -1411,10 +1489,17 @@ bool PostgreSqlStorage::logMessages(MessageList &msgs)
 
     QList<int> senderIdList;
     QHash<QString, int> senderIds;
+    QVariantList hostIdList;
+    QHash<QString, QVariant> hostIds;
     QSqlQuery addSenderQuery;
     QSqlQuery selectSenderQuery;;
     for (int i = 0; i < msgs.count(); i++) {
-        const QString &sender = msgs.at(i).sender();
+        QString sender, host;
+        splitSender(msgs.at(i).sender(), sender, host);
+        if (!hostIds.contains(host))
+            hostIds[host] = senderHostId(host, db);
+        hostIdList << hostIds[host];
+
         if (senderIds.contains(sender)) {
             senderIdList << senderIds[sender];
             continue;
@@ -1427,7 +1512,9 @@ bool PostgreSqlStorage::logMessages(MessageList &msgs)
         }
         else {
             savePoint("sender_sp", db);
-            addSenderQuery = executePreparedQuery("insert_sender", sender, db);
+            QVariantList senderParams;
+            senderParams << sender << nickFromMask(sender) << userFromMask(sender);
+            addSenderQuery = executePreparedQuery("insert_sender", senderParams, db);
             if (addSenderQuery.lastError().isValid()) {
                 // seems it was inserted meanwhile... by a different thread
                 rollbackSavePoint("sender_sp", db);
@@ -1449,13 +1536,17 @@ bool PostgreSqlStorage::logMessages(MessageList &msgs)
     bool error = false;
     for (int i = 0; i < msgs.count(); i++) {
         Message &msg = msgs[i];
+        QVariant message, messageData;
+        encodeContents(msg.contents(), message, messageData);
         QVariantList params;
         params << msg.timestamp()
                << msg.bufferInfo().bufferId().toInt()
                << msg.type()
                << (int)msg.flags()
                << senderIdList.at(i)
-               << msg.contents();
+               << hostIdList.at(i)
+               << message
+               << messageData;
         QSqlQuery logMessageQuery = executePreparedQuery("insert_message", params, db);
         if (!watchQuery(logMessageQuery)) {
             db.rollback();
@@ -1533,7 +1624,7 @@ QList<Message> PostgreSqlStorage::requestMsgs(UserId user, BufferId bufferId, Ms
         Message msg(timestamp,
             bufferInfo,
             (Message::Type)query.value(2).toUInt(),
-            query.value(5).toString(),
+            decodeContents(query.value(5), query.value(6)),
             query.value(4).toString(),
             (Message::Flags)query.value(3).toUInt());
         msg.setMsgId(query.value(0).toInt());
@@ -1545,6 +1636,171 @@ QList<Message> PostgreSqlStorage::requestMsgs(UserId user, BufferId bufferId, Ms
 }
 
 
+QList<Message> PostgreSqlStorage::requestMsgsByTime(UserId user, BufferId bufferId, const QDateTime &time, MsgId first, MsgId last, int before, int after)
+{
+    QList<Message> messagelist;
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::requestMsgsByTime(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return messagelist;
+    }
+
+    BufferInfo bufferInfo = getBufferInfo(user, bufferId);
+    if (!bufferInfo.isValid()) {
+        db.rollback();
+        return messagelist;
+    }
+
+    // page by MsgId from the first message at the requested time, so that equal timestamps can't split a page
+    QVariantList params;
+    MsgId start = first;
+    if (start == -1) {
+        params << bufferId.toInt()
+               << time.toUTC();
+        QSqlQuery startQuery = executePreparedQuery("select_messageid_from_time", params, db);
+        if (!watchQuery(startQuery)) {
+            db.rollback();
+            return messagelist;
+        }
+        if (startQuery.first()) {
+            start = startQuery.value(0).toInt();
+        }
+        else {
+            // nothing at or after the requested time, so only the messages before it are left
+            startQuery = executePreparedQuery("select_buffer_max_messageid", bufferId.toInt(), db);
+            if (!watchQuery(startQuery) || !startQuery.first()) {
+                db.rollback();
+                return messagelist;
+            }
+            start = startQuery.value(0).toInt() + 1;
+        }
+    }
+
+    params.clear();
+    params << bufferId.toInt()
+           << start.toInt()
+           << (last == -1 ? std::numeric_limits<int>::max() : last.toInt());
+    if (after != -1)
+        params << after;
+    else
+        params << "ALL";
+
+    QSqlQuery query = executePreparedQuery("select_messagesFromId", params, db);
+    if (!watchQuery(query)) {
+        db.rollback();
+        return messagelist;
+    }
+
+    QDateTime timestamp;
+    while (query.next()) {
+        timestamp = query.value(1).toDateTime();
+        timestamp.setTimeSpec(Qt::UTC);
+        Message msg(timestamp,
+            bufferInfo,
+            (Message::Type)query.value(2).toUInt(),
+            decodeContents(query.value(5), query.value(6)),
+            query.value(4).toString(),
+            (Message::Flags)query.value(3).toUInt());
+        msg.setMsgId(query.value(0).toInt());
+        messagelist.prepend(msg);
+    }
+
+    if (before) {
+        params.clear();
+        params << bufferId.toInt()
+               << start.toInt()
+               << before;
+        query = executePreparedQuery("select_messagesBeforeId", params, db);
+        if (!watchQuery(query)) {
+            db.rollback();
+            return messagelist;
+        }
+
+        while (query.next()) {
+            timestamp = query.value(1).toDateTime();
+            timestamp.setTimeSpec(Qt::UTC);
+            Message msg(timestamp,
+                bufferInfo,
+                (Message::Type)query.value(2).toUInt(),
+                decodeContents(query.value(5), query.value(6)),
+                query.value(4).toString(),
+                (Message::Flags)query.value(3).toUInt());
+            msg.setMsgId(query.value(0).toInt());
+            messagelist << msg;
+        }
+    }
+
+    db.commit();
+    return messagelist;
+}
+
+
+QList<Message> PostgreSqlStorage::requestMsgsMulti(UserId user, const QList<MsgRequest> &requests)
+{
+    QList<Message> messagelist;
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::requestMsgsMulti(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return messagelist;
+    }
+
+    // one lookup for all buffers instead of one getBufferInfo() per request
+    QHash<BufferId, BufferInfo> bufferInfos;
+    {
+        QSqlQuery bufferQuery(db);
+        bufferQuery.prepare(queryString("select_buffers"));
+        bufferQuery.bindValue(":userid", user.toInt());
+        safeExec(bufferQuery);
+        if (!watchQuery(bufferQuery)) {
+            db.rollback();
+            return messagelist;
+        }
+        while (bufferQuery.next()) {
+            BufferInfo bufferInfo(bufferQuery.value(0).toInt(), bufferQuery.value(1).toInt(), (BufferInfo::Type)bufferQuery.value(2).toInt(), bufferQuery.value(3).toInt(), bufferQuery.value(4).toString());
+            bufferInfos[bufferInfo.bufferId()] = bufferInfo;
+        }
+    }
+
+    QList<MsgRequest> validRequests;
+    foreach(const MsgRequest &request, requests) {
+        if (bufferInfos.contains(request.bufferId))
+            validRequests << request;
+    }
+
+    QDateTime timestamp;
+    for (int offset = 0; offset < validRequests.count(); offset += maxMsgsBatchSize) {
+        QSqlQuery query(db);
+        prepareMsgsBatchQuery(query, validRequests.mid(offset, maxMsgsBatchSize));
+
+        safeExec(query);
+        if (!watchQuery(query)) {
+            db.rollback();
+            return messagelist;
+        }
+
+        while (query.next()) {
+            timestamp = query.value(2).toDateTime();
+            timestamp.setTimeSpec(Qt::UTC);
+            Message msg(timestamp,
+                bufferInfos.value(query.value(0).toInt()),
+                (Message::Type)query.value(3).toUInt(),
+                decodeContents(query.value(6), query.value(7)),
+                query.value(5).toString(),
+                (Message::Flags)query.value(4).toUInt());
+            msg.setMsgId(query.value(1).toInt());
+            messagelist << msg;
+        }
+    }
+
+    db.commit();
+    return messagelist;
+}
+
+
 QList<Message> PostgreSqlStorage::requestAllMsgs(UserId user, MsgId first, MsgId last, int limit)
 {
     QList<Message> messagelist;
@@ -1585,7 +1841,105 @@ QList<Message> PostgreSqlStorage::requestAllMsgs(UserId user, MsgId first, MsgId
         Message msg(timestamp,
             bufferInfoHash[query.value(1).toInt()],
             (Message::Type)query.value(3).toUInt(),
-            query.value(6).toString(),
+            decodeContents(query.value(6), query.value(7)),
+            query.value(5).toString(),
+            (Message::Flags)query.value(4).toUInt());
+        msg.setMsgId(query.value(0).toInt());
+        messagelist << msg;
+    }
+
+    db.commit();
+    return messagelist;
+}
+
+
+QList<Message> PostgreSqlStorage::requestHighlightMsgs(UserId user, MsgId first, int limit)
+{
+    QList<Message> messagelist;
+
+    // requestBuffers uses it's own transaction.
+    QHash<BufferId, BufferInfo> bufferInfoHash;
+    foreach(BufferInfo bufferInfo, requestBuffers(user)) {
+        bufferInfoHash[bufferInfo.bufferId()] = bufferInfo;
+    }
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::requestHighlightMsgs(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return messagelist;
+    }
+
+    QSqlQuery query(db);
+    query.prepare(queryString("select_messagesHighlights"));
+    query.bindValue(":userid", user.toInt());
+    query.bindValue(":firstmsg", first.toInt());
+    safeExec(query);
+    if (!watchQuery(query)) {
+        db.rollback();
+        return messagelist;
+    }
+
+    QDateTime timestamp;
+    for (int i = 0; (limit < 0 || i < limit) && query.next(); i++) {
+        timestamp = query.value(2).toDateTime();
+        timestamp.setTimeSpec(Qt::UTC);
+        Message msg(timestamp,
+            bufferInfoHash[query.value(1).toInt()],
+            (Message::Type)query.value(3).toUInt(),
+            decodeContents(query.value(6), query.value(7)),
+            query.value(5).toString(),
+            (Message::Flags)query.value(4).toUInt());
+        msg.setMsgId(query.value(0).toInt());
+        messagelist << msg;
+    }
+
+    db.commit();
+    return messagelist;
+}
+
+
+QList<Message> PostgreSqlStorage::requestMsgsBySender(UserId user, BufferId bufferId, const QString &nick, MsgId last, int limit)
+{
+    QList<Message> messagelist;
+
+    // requestBuffers uses it's own transaction.
+    QHash<BufferId, BufferInfo> bufferInfoHash;
+    foreach(BufferInfo bufferInfo, requestBuffers(user)) {
+        bufferInfoHash[bufferInfo.bufferId()] = bufferInfo;
+    }
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::requestMsgsBySender(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return messagelist;
+    }
+
+    QVariantList params;
+    params << nick
+           << user.toInt()
+           << (bufferId.isValid() ? bufferId.toInt() : -1)
+           << (last == -1 ? std::numeric_limits<int>::max() : last.toInt());
+    if (limit != -1)
+        params << limit;
+    else
+        params << "ALL";
+
+    QSqlQuery query = executePreparedQuery("select_messagesBySender", params, db);
+    if (!watchQuery(query)) {
+        db.rollback();
+        return messagelist;
+    }
+
+    QDateTime timestamp;
+    while (query.next()) {
+        timestamp = query.value(2).toDateTime();
+        timestamp.setTimeSpec(Qt::UTC);
+        Message msg(timestamp,
+            bufferInfoHash[query.value(1).toInt()],
+            (Message::Type)query.value(3).toUInt(),
+            decodeContents(query.value(6), query.value(7)),
             query.value(5).toString(),
             (Message::Flags)query.value(4).toUInt());
         msg.setMsgId(query.value(0).toInt());
@@ -1597,6 +1951,234 @@ QList<Message> PostgreSqlStorage::requestAllMsgs(UserId user, MsgId first, MsgId
 }
 
 
+MsgId PostgreSqlStorage::expiredMsgsBoundary(UserId user, BufferId bufferId, const QDateTime &minTime, int maxCount)
+{
+    MsgId boundary;
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::expiredMsgsBoundary(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return boundary;
+    }
+
+    if (!getBufferInfo(user, bufferId).isValid()) {
+        db.rollback();
+        return boundary;
+    }
+
+    if (maxCount > 0) {
+        QVariantList params;
+        params << bufferId.toInt()
+               << maxCount - 1;
+        QSqlQuery query = executePreparedQuery("select_messageid_by_offset", params, db);
+        if (watchQuery(query) && query.first())
+            boundary = query.value(0).toInt();
+    }
+
+    if (minTime.isValid()) {
+        QVariantList params;
+        params << bufferId.toInt()
+               << minTime.toUTC();
+        QSqlQuery query = executePreparedQuery("select_messageid_from_time", params, db);
+        if (watchQuery(query)) {
+            MsgId firstKept;
+            if (query.first()) {
+                firstKept = query.value(0).toInt();
+            }
+            else {
+                // no message at or after minTime means all of them are expired, but not those stored while we prune
+                QSqlQuery maxQuery = executePreparedQuery("select_buffer_max_messageid", bufferId.toInt(), db);
+                if (watchQuery(maxQuery) && maxQuery.first() && !maxQuery.value(0).isNull())
+                    firstKept = maxQuery.value(0).toInt() + 1;
+            }
+            if (firstKept > boundary)
+                boundary = firstKept;
+        }
+    }
+
+    db.commit();
+    return boundary;
+}
+
+
+QList<Message> PostgreSqlStorage::requestExpiredMsgs(UserId user, BufferId bufferId, MsgId last, int limit)
+{
+    QList<Message> messagelist;
+
+    QSqlDatabase db = logDb();
+    if (!beginReadOnlyTransaction(db)) {
+        qWarning() << "PostgreSqlStorage::requestExpiredMsgs(): cannot start read only transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return messagelist;
+    }
+
+    BufferInfo bufferInfo = getBufferInfo(user, bufferId);
+    if (!bufferInfo.isValid()) {
+        db.rollback();
+        return messagelist;
+    }
+
+    QVariantList params;
+    params << bufferId.toInt()
+           << last.toInt()
+           << limit;
+    QSqlQuery query = executePreparedQuery("select_messagesOldest", params, db);
+    if (!watchQuery(query)) {
+        db.rollback();
+        return messagelist;
+    }
+
+    QDateTime timestamp;
+    while (query.next()) {
+        timestamp = query.value(1).toDateTime();
+        timestamp.setTimeSpec(Qt::UTC);
+        Message msg(timestamp,
+            bufferInfo,
+            (Message::Type)query.value(2).toUInt(),
+            decodeContents(query.value(5), query.value(6)),
+            query.value(4).toString(),
+            (Message::Flags)query.value(3).toUInt());
+        msg.setMsgId(query.value(0).toInt());
+        messagelist << msg;
+    }
+
+    db.commit();
+    return messagelist;
+}
+
+
+bool PostgreSqlStorage::deleteMsgsUntil(UserId user, BufferId bufferId, MsgId last)
+{
+    QSqlDatabase db = logDb();
+    if (!db.transaction()) {
+        qWarning() << "PostgreSqlStorage::deleteMsgsUntil(): cannot start transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return false;
+    }
+
+    if (!getBufferInfo(user, bufferId).isValid()) {
+        db.rollback();
+        return false;
+    }
+
+    QVariantList params;
+    params << bufferId.toInt()
+           << last.toInt();
+    QSqlQuery deleteQuery = executePreparedQuery("delete_backlog_for_buffer_until", params, db);
+    if (!watchQuery(deleteQuery)) {
+        db.rollback();
+        return false;
+    }
+
+    db.commit();
+    return true;
+}
+
+
+bool PostgreSqlStorage::restoreMsgs(UserId user, BufferId bufferId, const QList<Message> &msgs)
+{
+    QSqlDatabase db = logDb();
+    if (!db.transaction()) {
+        qWarning() << "PostgreSqlStorage::restoreMsgs(): cannot start transaction!";
+        qWarning() << " -" << qPrintable(db.lastError().text());
+        return false;
+    }
+
+    if (!getBufferInfo(user, bufferId).isValid()) {
+        db.rollback();
+        return false;
+    }
+
+    QHash<QString, int> senderIds;
+    QHash<QString, QVariant> hostIds;
+    QSqlQuery addSenderQuery;
+    QSqlQuery selectSenderQuery;
+    for (int i = 0; i < msgs.count(); i++) {
+        QString sender, host;
+        splitSender(msgs.at(i).sender(), sender, host);
+        if (!hostIds.contains(host))
+            hostIds[host] = senderHostId(host, db);
+
+        if (senderIds.contains(sender))
+            continue;
+
+        selectSenderQuery = executePreparedQuery("select_senderid", sender, db);
+        if (selectSenderQuery.first()) {
+            senderIds[sender] = selectSenderQuery.value(0).toInt();
+        }
+        else {
+            savePoint("sender_sp", db);
+            QVariantList senderParams;
+            senderParams << sender << nickFromMask(sender) << userFromMask(sender);
+            addSenderQuery = executePreparedQuery("insert_sender", senderParams, db);
+            if (addSenderQuery.lastError().isValid()) {
+                // seems it was inserted meanwhile... by a different thread
+                rollbackSavePoint("sender_sp", db);
+                selectSenderQuery = db.exec(selectSenderQuery.lastQuery());
+                selectSenderQuery.first();
+                senderIds[sender] = selectSenderQuery.value(0).toInt();
+            }
+            else {
+                releaseSavePoint("sender_sp", db);
+                addSenderQuery.first();
+                senderIds[sender] = addSenderQuery.value(0).toInt();
+            }
+        }
+    }
+
+    for (int i = 0; i < msgs.count(); i++) {
+        const Message &msg = msgs.at(i);
+        QString sender, host;
+        splitSender(msg.sender(), sender, host);
+        QVariant message, messageData;
+        encodeContents(msg.contents(), message, messageData);
+        QVariantList params;
+        params << msg.msgId().toInt()
+               << msg.timestamp()
+               << bufferId.toInt()
+               << msg.type()
+               << (int)msg.flags()
+               << senderIds[sender]
+               << hostIds[host]
+               << message
+               << messageData;
+        QSqlQuery restoreQuery = executePreparedQuery("insert_message_with_id", params, db);
+        if (!watchQuery(restoreQuery)) {
+            db.rollback();
+            return false;
+        }
+    }
+
+    db.commit();
+    return true;
+}
+
+
+QVariant PostgreSqlStorage::senderHostId(const QString &host, const QSqlDatabase &db)
+{
+    if (host.isEmpty())
+        return QVariant(QVariant::Int);
+
+    QSqlQuery selectHostQuery = executePreparedQuery("select_senderhostid", host, db);
+    if (selectHostQuery.first())
+        return selectHostQuery.value(0).toInt();
+
+    // like senders, hosts may be added by another thread at the same time
+    savePoint("host_sp", db);
+    QSqlQuery addHostQuery = executePreparedQuery("insert_senderhost", host, db);
+    if (addHostQuery.lastError().isValid()) {
+        rollbackSavePoint("host_sp", db);
+        selectHostQuery = db.exec(selectHostQuery.lastQuery());
+        selectHostQuery.first();
+        return selectHostQuery.value(0).toInt();
+    }
+    releaseSavePoint("host_sp", db);
+    addHostQuery.first();
+    return addHostQuery.value(0).toInt();
+}
+
+
 // void PostgreSqlStorage::safeExec(QSqlQuery &query) {
 //   qDebug() << "PostgreSqlStorage::safeExec";
 //   qDebug() << "   executing:\n" << query.executedQuery();
@@ -1627,10 +2209,20 @@ bool PostgreSqlStorage::beginReadOnlyTransaction(QSqlDatabase &db)
 }
 
 
+void PostgreSqlStorage::safeExec(QSqlQuery &query)
+{
+    Metrics::Timer timer;
+    query.exec();
+    if (Metrics::isEnabled())
+        recordQueryTime(query, timer.elapsed());
+}
+
+
 QSqlQuery PostgreSqlStorage::prepareAndExecuteQuery(const QString &queryname, const QString &paramstring, const QSqlDatabase &db)
 {
     // Query preparing is done lazily. That means that instead of always checking if the query is already prepared
     // we just EXECUTE and catch the error
+    Metrics::Timer timer;
     QSqlQuery query;
 
     db.exec("SAVEPOINT quassel_prepare_query");
@@ -1670,6 +2262,9 @@ QSqlQuery PostgreSqlStorage::prepareAndExecuteQuery(const QString &queryname, co
         // only release the SAVEPOINT
         db.exec("RELEASE SAVEPOINT quassel_prepare_query");
     }
+
+    if (Metrics::isEnabled())
+        Metrics::observe("quassel_storage_query_seconds", Metrics::labels("query", queryname), timer.elapsed());
     return query;
 }
 
@@ -1739,6 +2334,9 @@ bool PostgreSqlMigrationWriter::prepareQuery(MigrationObject mo)
     case Sender:
         query = queryString("migrate_write_sender");
         break;
+    case SenderHost:
+        query = queryString("migrate_write_senderhost");
+        break;
     case Identity:
         _validIdentities.clear();
         query = queryString("migrate_write_identity");
@@ -1782,6 +2380,16 @@ bool PostgreSqlMigrationWriter::writeMo(const SenderMO &sender)
 {
     bindValue(0, sender.senderId);
     bindValue(1, sender.sender);
+    bindValue(2, nickFromMask(sender.sender));
+    bindValue(3, userFromMask(sender.sender));
+    return exec();
+}
+
+
+bool PostgreSqlMigrationWriter::writeMo(const SenderHostMO &senderHost)
+{
+    bindValue(0, senderHost.hostId);
+    bindValue(1, senderHost.host);
     return exec();
 }
 
@@ -1887,7 +2495,8 @@ bool PostgreSqlMigrationWriter::writeMo(const BacklogMO &backlog)
     bindValue(3, backlog.type);
     bindValue(4, (int)backlog.flags);
     bindValue(5, backlog.senderid);
-    bindValue(6, backlog.message);
+    bindValue(6, backlog.hostid ? QVariant(backlog.hostid) : QVariant(QVariant::Int));
+    bindValue(7, backlog.message);
     return exec();
 }
 
@@ -1934,7 +2543,8 @@ bool PostgreSqlMigrationWriter::postProcess()
               << Sequence("ircserver", "serverid")
               << Sequence("network", "networkid")
               << Sequence("quasseluser", "userid")
-              << Sequence("sender", "senderid");
+              << Sequence("sender", "senderid")
+              << Sequence("senderhost", "hostid");
     QList<Sequence>::const_iterator iter;
     for (iter = sequences.constBegin(); iter != sequences.constEnd(); iter++) {
         resetQuery();
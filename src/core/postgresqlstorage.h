@@ -95,12 +95,22 @@ public slots:
     virtual QHash<BufferId, MsgId> bufferLastSeenMsgIds(UserId user);
     virtual void setBufferMarkerLineMsg(UserId user, const BufferId &bufferId, const MsgId &msgId);
     virtual QHash<BufferId, MsgId> bufferMarkerLineMsgIds(UserId user);
+    virtual QHash<BufferId, ActivityCount> bufferActivityCounts(UserId user);
+    virtual ActivityCount bufferActivityCount(UserId user, BufferId bufferId, MsgId lastSeenMsgId);
 
     /* Message handling */
     virtual bool logMessage(Message &msg);
     virtual bool logMessages(MessageList &msgs);
     virtual QList<Message> requestMsgs(UserId user, BufferId bufferId, MsgId first = -1, MsgId last = -1, int limit = -1);
+    virtual QList<Message> requestMsgsMulti(UserId user, const QList<MsgRequest> &requests);
+    virtual QList<Message> requestMsgsByTime(UserId user, BufferId bufferId, const QDateTime &time, MsgId first = -1, MsgId last = -1, int before = 0, int after = -1);
     virtual QList<Message> requestAllMsgs(UserId user, MsgId first = -1, MsgId last = -1, int limit = -1);
+    virtual QList<Message> requestHighlightMsgs(UserId user, MsgId first = -1, int limit = -1);
+    virtual QList<Message> requestMsgsBySender(UserId user, BufferId bufferId, const QString &nick, MsgId last = -1, int limit = -1);
+    virtual MsgId expiredMsgsBoundary(UserId user, BufferId bufferId, const QDateTime &minTime, int maxCount);
+    virtual QList<Message> requestExpiredMsgs(UserId user, BufferId bufferId, MsgId last, int limit);
+    virtual bool deleteMsgsUntil(UserId user, BufferId bufferId, MsgId last);
+    virtual bool restoreMsgs(UserId user, BufferId bufferId, const QList<Message> &msgs);
 
 protected:
     virtual bool initDbSession(QSqlDatabase &db);
@@ -129,6 +139,8 @@ protected:
 private:
     void bindNetworkInfo(QSqlQuery &query, const NetworkInfo &info);
     void bindServerInfo(QSqlQuery &query, const Network::Server &server);
+    //! Returns the id of a sender's host, adding it if necessary, or a NULL id for an empty host
+    QVariant senderHostId(const QString &host, const QSqlDatabase &db);
     QSqlQuery prepareAndExecuteQuery(const QString &queryname, const QString &paramstring, const QSqlDatabase &db);
     inline QSqlQuery prepareAndExecuteQuery(const QString &queryname, const QSqlDatabase &db) { return prepareAndExecuteQuery(queryname, QString(), db); }
 
@@ -140,8 +152,6 @@ private:
 };
 
 
-inline void PostgreSqlStorage::safeExec(QSqlQuery &query) { query.exec(); }
-
 // ========================================
 //  PostgreSqlMigration
 // ========================================
@@ -154,6 +164,7 @@ public:
 
     virtual bool writeMo(const QuasselUserMO &user);
     virtual bool writeMo(const SenderMO &sender);
+    virtual bool writeMo(const SenderHostMO &senderHost);
     virtual bool writeMo(const IdentityMO &identity);
     virtual bool writeMo(const IdentityNickMO &identityNick);
     virtual bool writeMo(const NetworkMO &network);
@@ -22,9 +22,13 @@
 
 #include <QtSql>
 
+#include <limits>
+
 #include "logger.h"
+#include "metrics.h"
 #include "network.h"
 #include "quassel.h"
+#include "util.h"
 
 int SqliteStorage::_maxRetryCount = 150;
 
@@ -1455,6 +1459,67 @@ QHash<BufferId, MsgId> SqliteStorage::bufferMarkerLineMsgIds(UserId user)
 }
 
 
+QHash<BufferId, Storage::ActivityCount> SqliteStorage::bufferActivityCounts(UserId user)
+{
+    QHash<BufferId, ActivityCount> countHash;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    bool error = false;
+    {
+        QSqlQuery query(db);
+        query.prepare(queryString("select_buffer_activity_counts"));
+        query.bindValue(":userid", user.toInt());
+        query.bindValue(":typemask", unreadMessageTypes);
+        query.bindValue(":selfflag", (int)Message::Self);
+        query.bindValue(":highlightflag", (int)Message::Highlight);
+
+        lockForRead();
+        safeExec(query);
+        error = !watchQuery(query);
+        if (!error) {
+            while (query.next()) {
+                countHash[query.value(0).toInt()] = ActivityCount(query.value(1).toInt(), query.value(2).toInt());
+            }
+        }
+    }
+
+    db.commit();
+    unlock();
+    return countHash;
+}
+
+
+Storage::ActivityCount SqliteStorage::bufferActivityCount(UserId user, BufferId bufferId, MsgId lastSeenMsgId)
+{
+    ActivityCount count;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    {
+        QSqlQuery query(db);
+        query.prepare(queryString("select_buffer_activity_count"));
+        query.bindValue(":userid", user.toInt());
+        query.bindValue(":bufferid", bufferId.toInt());
+        query.bindValue(":lastseenmsgid", lastSeenMsgId.isValid() ? lastSeenMsgId.toInt() : 0);
+        query.bindValue(":typemask", unreadMessageTypes);
+        query.bindValue(":selfflag", (int)Message::Self);
+        query.bindValue(":highlightflag", (int)Message::Highlight);
+
+        lockForRead();
+        safeExec(query);
+        if (watchQuery(query) && query.first())
+            count = ActivityCount(query.value(0).toInt(), query.value(1).toInt());
+    }
+
+    db.commit();
+    unlock();
+    return count;
+}
+
+
 bool SqliteStorage::logMessage(Message &msg)
 {
     QSqlDatabase db = logDb();
@@ -1462,17 +1527,31 @@ bool SqliteStorage::logMessage(Message &msg)
 
     bool error = false;
     {
+        QString sender, host;
+        splitSender(msg.sender(), sender, host);
+
         QSqlQuery logMessageQuery(db);
         logMessageQuery.prepare(queryString("insert_message"));
 
-        logMessageQuery.bindValue(":time", msg.timestamp().toTime_t());
+        logMessageQuery.bindValue(":time", msg.timestamp().toMSecsSinceEpoch());
         logMessageQuery.bindValue(":bufferid", msg.bufferInfo().bufferId().toInt());
         logMessageQuery.bindValue(":type", msg.type());
         logMessageQuery.bindValue(":flags", (int)msg.flags());
-        logMessageQuery.bindValue(":sender", msg.sender());
-        logMessageQuery.bindValue(":message", msg.contents());
+        logMessageQuery.bindValue(":sender", sender);
+        logMessageQuery.bindValue(":host", host);
+        QVariant message, messageData;
+        encodeContents(msg.contents(), message, messageData);
+        logMessageQuery.bindValue(":message", message);
+        logMessageQuery.bindValue(":messagedata", messageData);
 
         lockForWrite();
+        if (!host.isEmpty()) {
+            // the host is optional, so unlike the sender a missing one wouldn't make the insert fail
+            QSqlQuery addHostQuery(db);
+            addHostQuery.prepare(queryString("insert_senderhost"));
+            addHostQuery.bindValue(":host", host);
+            safeExec(addHostQuery);
+        }
         safeExec(logMessageQuery);
 
         if (logMessageQuery.lastError().isValid()) {
@@ -1480,7 +1559,9 @@ bool SqliteStorage::logMessage(Message &msg)
             if (logMessageQuery.lastError().number() == 19) {
                 QSqlQuery addSenderQuery(db);
                 addSenderQuery.prepare(queryString("insert_sender"));
-                addSenderQuery.bindValue(":sender", msg.sender());
+                addSenderQuery.bindValue(":sender", sender);
+                addSenderQuery.bindValue(":nick", nickFromMask(sender));
+                addSenderQuery.bindValue(":ident", userFromMask(sender));
                 safeExec(addSenderQuery);
                 safeExec(logMessageQuery);
                 error = !watchQuery(logMessageQuery);
@@ -1519,17 +1600,27 @@ bool SqliteStorage::logMessages(MessageList &msgs)
 
     {
         QSet<QString> senders;
+        QSet<QString> hosts;
         QSqlQuery addSenderQuery(db);
         addSenderQuery.prepare(queryString("insert_sender"));
+        QSqlQuery addHostQuery(db);
+        addHostQuery.prepare(queryString("insert_senderhost"));
         lockForWrite();
         for (int i = 0; i < msgs.count(); i++) {
-            const QString &sender = msgs.at(i).sender();
-            if (senders.contains(sender))
-                continue;
-            senders << sender;
-
-            addSenderQuery.bindValue(":sender", sender);
-            safeExec(addSenderQuery);
+            QString sender, host;
+            splitSender(msgs.at(i).sender(), sender, host);
+            if (!senders.contains(sender)) {
+                senders << sender;
+                addSenderQuery.bindValue(":sender", sender);
+                addSenderQuery.bindValue(":nick", nickFromMask(sender));
+                addSenderQuery.bindValue(":ident", userFromMask(sender));
+                safeExec(addSenderQuery);
+            }
+            if (!host.isEmpty() && !hosts.contains(host)) {
+                hosts << host;
+                addHostQuery.bindValue(":host", host);
+                safeExec(addHostQuery);
+            }
         }
     }
 
@@ -1540,12 +1631,18 @@ bool SqliteStorage::logMessages(MessageList &msgs)
         for (int i = 0; i < msgs.count(); i++) {
             Message &msg = msgs[i];
 
-            logMessageQuery.bindValue(":time", msg.timestamp().toTime_t());
+            logMessageQuery.bindValue(":time", msg.timestamp().toMSecsSinceEpoch());
             logMessageQuery.bindValue(":bufferid", msg.bufferInfo().bufferId().toInt());
             logMessageQuery.bindValue(":type", msg.type());
             logMessageQuery.bindValue(":flags", (int)msg.flags());
-            logMessageQuery.bindValue(":sender", msg.sender());
-            logMessageQuery.bindValue(":message", msg.contents());
+            QString sender, host;
+            splitSender(msg.sender(), sender, host);
+            logMessageQuery.bindValue(":sender", sender);
+            logMessageQuery.bindValue(":host", host);
+            QVariant message, messageData;
+            encodeContents(msg.contents(), message, messageData);
+            logMessageQuery.bindValue(":message", message);
+            logMessageQuery.bindValue(":messagedata", messageData);
 
             safeExec(logMessageQuery);
             if (!watchQuery(logMessageQuery)) {
@@ -1626,10 +1723,10 @@ QList<Message> SqliteStorage::requestMsgs(UserId user, BufferId bufferId, MsgId
         watchQuery(query);
 
         while (query.next()) {
-            Message msg(QDateTime::fromTime_t(query.value(1).toInt()),
+            Message msg(QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong()),
                 bufferInfo,
                 (Message::Type)query.value(2).toUInt(),
-                query.value(5).toString(),
+                decodeContents(query.value(5), query.value(6)),
                 query.value(4).toString(),
                 (Message::Flags)query.value(3).toUInt());
             msg.setMsgId(query.value(0).toInt());
@@ -1643,6 +1740,152 @@ QList<Message> SqliteStorage::requestMsgs(UserId user, BufferId bufferId, MsgId
 }
 
 
+QList<Message> SqliteStorage::requestMsgsByTime(UserId user, BufferId bufferId, const QDateTime &time, MsgId first, MsgId last, int before, int after)
+{
+    QList<Message> messagelist;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    bool error = false;
+    BufferInfo bufferInfo;
+    {
+        // code dupication from getBufferInfo:
+        // this is due to the impossibility of nesting transactions and recursive locking
+        QSqlQuery bufferInfoQuery(db);
+        bufferInfoQuery.prepare(queryString("select_buffer_by_id"));
+        bufferInfoQuery.bindValue(":userid", user.toInt());
+        bufferInfoQuery.bindValue(":bufferid", bufferId.toInt());
+
+        lockForRead();
+        safeExec(bufferInfoQuery);
+        error = !watchQuery(bufferInfoQuery) || !bufferInfoQuery.first();
+        if (!error) {
+            bufferInfo = BufferInfo(bufferInfoQuery.value(0).toInt(), bufferInfoQuery.value(1).toInt(), (BufferInfo::Type)bufferInfoQuery.value(2).toInt(), 0, bufferInfoQuery.value(4).toString());
+            error = !bufferInfo.isValid();
+        }
+    }
+    if (error) {
+        db.rollback();
+        unlock();
+        return messagelist;
+    }
+
+    {
+        // page by MsgId from the first message at the requested time, so that equal timestamps can't split a page
+        QSqlQuery query(db);
+        MsgId start = first;
+        if (start == -1) {
+            query.prepare(queryString("select_messageid_from_time"));
+            query.bindValue(":bufferid", bufferId.toInt());
+            query.bindValue(":time", time.toMSecsSinceEpoch());
+            safeExec(query);
+            if (watchQuery(query) && query.first()) {
+                start = query.value(0).toInt();
+            }
+            else {
+                // nothing at or after the requested time, so only the messages before it are left
+                query.prepare(queryString("select_buffer_max_messageid"));
+                query.bindValue(":bufferid", bufferId.toInt());
+                safeExec(query);
+                if (watchQuery(query) && query.first())
+                    start = query.value(0).toInt() + 1;
+            }
+        }
+
+        query.prepare(queryString("select_messagesFromId"));
+        query.bindValue(":bufferid", bufferId.toInt());
+        query.bindValue(":firstmsg", start.toInt());
+        query.bindValue(":lastmsg", last == -1 ? std::numeric_limits<int>::max() : last.toInt());
+        query.bindValue(":limit", after);
+        safeExec(query);
+        watchQuery(query);
+
+        while (query.next()) {
+            Message msg(QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong()),
+                bufferInfo,
+                (Message::Type)query.value(2).toUInt(),
+                decodeContents(query.value(5), query.value(6)),
+                query.value(4).toString(),
+                (Message::Flags)query.value(3).toUInt());
+            msg.setMsgId(query.value(0).toInt());
+            messagelist.prepend(msg);
+        }
+
+        if (before) {
+            query.prepare(queryString("select_messagesBeforeId"));
+            query.bindValue(":bufferid", bufferId.toInt());
+            query.bindValue(":lastmsg", start.toInt());
+            query.bindValue(":limit", before);
+            safeExec(query);
+            watchQuery(query);
+
+            while (query.next()) {
+                Message msg(QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong()),
+                    bufferInfo,
+                    (Message::Type)query.value(2).toUInt(),
+                    decodeContents(query.value(5), query.value(6)),
+                    query.value(4).toString(),
+                    (Message::Flags)query.value(3).toUInt());
+                msg.setMsgId(query.value(0).toInt());
+                messagelist << msg;
+            }
+        }
+    }
+    db.commit();
+    unlock();
+
+    return messagelist;
+}
+
+
+QList<Message> SqliteStorage::requestMsgsMulti(UserId user, const QList<MsgRequest> &requests)
+{
+    QList<Message> messagelist;
+
+    // one lookup for all buffers instead of one select_buffer_by_id per request
+    QHash<BufferId, BufferInfo> bufferInfos;
+    foreach(const BufferInfo &bufferInfo, requestBuffers(user)) {
+        bufferInfos[bufferInfo.bufferId()] = bufferInfo;
+    }
+
+    QList<MsgRequest> validRequests;
+    foreach(const MsgRequest &request, requests) {
+        if (bufferInfos.contains(request.bufferId))
+            validRequests << request;
+    }
+    if (validRequests.isEmpty())
+        return messagelist;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+    lockForRead();
+    for (int offset = 0; offset < validRequests.count(); offset += maxMsgsBatchSize) {
+        QSqlQuery query(db);
+        prepareMsgsBatchQuery(query, validRequests.mid(offset, maxMsgsBatchSize));
+
+        safeExec(query);
+        if (!watchQuery(query))
+            break;
+
+        while (query.next()) {
+            Message msg(QDateTime::fromMSecsSinceEpoch(query.value(2).toLongLong()),
+                bufferInfos.value(query.value(0).toInt()),
+                (Message::Type)query.value(3).toUInt(),
+                decodeContents(query.value(6), query.value(7)),
+                query.value(5).toString(),
+                (Message::Flags)query.value(4).toUInt());
+            msg.setMsgId(query.value(1).toInt());
+            messagelist << msg;
+        }
+    }
+    db.commit();
+    unlock();
+
+    return messagelist;
+}
+
+
 QList<Message> SqliteStorage::requestAllMsgs(UserId user, MsgId first, MsgId last, int limit)
 {
     QList<Message> messagelist;
@@ -1680,10 +1923,106 @@ QList<Message> SqliteStorage::requestAllMsgs(UserId user, MsgId first, MsgId las
         watchQuery(query);
 
         while (query.next()) {
-            Message msg(QDateTime::fromTime_t(query.value(2).toInt()),
+            Message msg(QDateTime::fromMSecsSinceEpoch(query.value(2).toLongLong()),
+                bufferInfoHash[query.value(1).toInt()],
+                (Message::Type)query.value(3).toUInt(),
+                decodeContents(query.value(6), query.value(7)),
+                query.value(5).toString(),
+                (Message::Flags)query.value(4).toUInt());
+            msg.setMsgId(query.value(0).toInt());
+            messagelist << msg;
+        }
+    }
+    db.commit();
+    unlock();
+    return messagelist;
+}
+
+
+QList<Message> SqliteStorage::requestHighlightMsgs(UserId user, MsgId first, int limit)
+{
+    QList<Message> messagelist;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    QHash<BufferId, BufferInfo> bufferInfoHash;
+    {
+        QSqlQuery bufferInfoQuery(db);
+        bufferInfoQuery.prepare(queryString("select_buffers"));
+        bufferInfoQuery.bindValue(":userid", user.toInt());
+
+        lockForRead();
+        safeExec(bufferInfoQuery);
+        watchQuery(bufferInfoQuery);
+        while (bufferInfoQuery.next()) {
+            BufferInfo bufferInfo = BufferInfo(bufferInfoQuery.value(0).toInt(), bufferInfoQuery.value(1).toInt(), (BufferInfo::Type)bufferInfoQuery.value(2).toInt(), bufferInfoQuery.value(3).toInt(), bufferInfoQuery.value(4).toString());
+            bufferInfoHash[bufferInfo.bufferId()] = bufferInfo;
+        }
+
+        QSqlQuery query(db);
+        query.prepare(queryString("select_messagesHighlights"));
+        query.bindValue(":userid", user.toInt());
+        query.bindValue(":firstmsg", first.toInt());
+        query.bindValue(":limit", limit);
+        safeExec(query);
+
+        watchQuery(query);
+
+        while (query.next()) {
+            Message msg(QDateTime::fromMSecsSinceEpoch(query.value(2).toLongLong()),
+                bufferInfoHash[query.value(1).toInt()],
+                (Message::Type)query.value(3).toUInt(),
+                decodeContents(query.value(6), query.value(7)),
+                query.value(5).toString(),
+                (Message::Flags)query.value(4).toUInt());
+            msg.setMsgId(query.value(0).toInt());
+            messagelist << msg;
+        }
+    }
+    db.commit();
+    unlock();
+    return messagelist;
+}
+
+
+QList<Message> SqliteStorage::requestMsgsBySender(UserId user, BufferId bufferId, const QString &nick, MsgId last, int limit)
+{
+    QList<Message> messagelist;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    QHash<BufferId, BufferInfo> bufferInfoHash;
+    {
+        QSqlQuery bufferInfoQuery(db);
+        bufferInfoQuery.prepare(queryString("select_buffers"));
+        bufferInfoQuery.bindValue(":userid", user.toInt());
+
+        lockForRead();
+        safeExec(bufferInfoQuery);
+        watchQuery(bufferInfoQuery);
+        while (bufferInfoQuery.next()) {
+            BufferInfo bufferInfo = BufferInfo(bufferInfoQuery.value(0).toInt(), bufferInfoQuery.value(1).toInt(), (BufferInfo::Type)bufferInfoQuery.value(2).toInt(), bufferInfoQuery.value(3).toInt(), bufferInfoQuery.value(4).toString());
+            bufferInfoHash[bufferInfo.bufferId()] = bufferInfo;
+        }
+
+        QSqlQuery query(db);
+        query.prepare(queryString("select_messagesBySender"));
+        query.bindValue(":nick", nick);
+        query.bindValue(":userid", user.toInt());
+        query.bindValue(":bufferid", bufferId.isValid() ? bufferId.toInt() : -1);
+        query.bindValue(":lastmsg", last == -1 ? std::numeric_limits<int>::max() : last.toInt());
+        query.bindValue(":limit", limit);
+        safeExec(query);
+
+        watchQuery(query);
+
+        while (query.next()) {
+            Message msg(QDateTime::fromMSecsSinceEpoch(query.value(2).toLongLong()),
                 bufferInfoHash[query.value(1).toInt()],
                 (Message::Type)query.value(3).toUInt(),
-                query.value(6).toString(),
+                decodeContents(query.value(6), query.value(7)),
                 query.value(5).toString(),
                 (Message::Flags)query.value(4).toUInt());
             msg.setMsgId(query.value(0).toInt());
@@ -1696,6 +2035,252 @@ QList<Message> SqliteStorage::requestAllMsgs(UserId user, MsgId first, MsgId las
 }
 
 
+MsgId SqliteStorage::expiredMsgsBoundary(UserId user, BufferId bufferId, const QDateTime &minTime, int maxCount)
+{
+    MsgId boundary;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    bool error = false;
+    {
+        QSqlQuery bufferInfoQuery(db);
+        bufferInfoQuery.prepare(queryString("select_buffer_by_id"));
+        bufferInfoQuery.bindValue(":userid", user.toInt());
+        bufferInfoQuery.bindValue(":bufferid", bufferId.toInt());
+
+        lockForRead();
+        safeExec(bufferInfoQuery);
+        error = !watchQuery(bufferInfoQuery) || !bufferInfoQuery.first();
+    }
+    if (error) {
+        db.rollback();
+        unlock();
+        return boundary;
+    }
+
+    if (maxCount > 0) {
+        QSqlQuery query(db);
+        query.prepare(queryString("select_messageid_by_offset"));
+        query.bindValue(":bufferid", bufferId.toInt());
+        query.bindValue(":offset", maxCount - 1);
+        safeExec(query);
+        if (watchQuery(query) && query.first())
+            boundary = query.value(0).toInt();
+    }
+
+    if (minTime.isValid()) {
+        QSqlQuery query(db);
+        query.prepare(queryString("select_messageid_from_time"));
+        query.bindValue(":bufferid", bufferId.toInt());
+        query.bindValue(":time", minTime.toMSecsSinceEpoch());
+        safeExec(query);
+        if (watchQuery(query)) {
+            MsgId firstKept;
+            if (query.first()) {
+                firstKept = query.value(0).toInt();
+            }
+            else {
+                // no message at or after minTime means all of them are expired, but not those stored while we prune
+                QSqlQuery maxQuery(db);
+                maxQuery.prepare(queryString("select_buffer_max_messageid"));
+                maxQuery.bindValue(":bufferid", bufferId.toInt());
+                safeExec(maxQuery);
+                if (watchQuery(maxQuery) && maxQuery.first() && !maxQuery.value(0).isNull())
+                    firstKept = maxQuery.value(0).toInt() + 1;
+            }
+            if (firstKept > boundary)
+                boundary = firstKept;
+        }
+    }
+
+    db.commit();
+    unlock();
+    return boundary;
+}
+
+
+QList<Message> SqliteStorage::requestExpiredMsgs(UserId user, BufferId bufferId, MsgId last, int limit)
+{
+    QList<Message> messagelist;
+
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    bool error = false;
+    BufferInfo bufferInfo;
+    {
+        // code dupication from getBufferInfo:
+        // this is due to the impossibility of nesting transactions and recursive locking
+        QSqlQuery bufferInfoQuery(db);
+        bufferInfoQuery.prepare(queryString("select_buffer_by_id"));
+        bufferInfoQuery.bindValue(":userid", user.toInt());
+        bufferInfoQuery.bindValue(":bufferid", bufferId.toInt());
+
+        lockForRead();
+        safeExec(bufferInfoQuery);
+        error = !watchQuery(bufferInfoQuery) || !bufferInfoQuery.first();
+        if (!error) {
+            bufferInfo = BufferInfo(bufferInfoQuery.value(0).toInt(), bufferInfoQuery.value(1).toInt(), (BufferInfo::Type)bufferInfoQuery.value(2).toInt(), 0, bufferInfoQuery.value(4).toString());
+            error = !bufferInfo.isValid();
+        }
+    }
+    if (error) {
+        db.rollback();
+        unlock();
+        return messagelist;
+    }
+
+    {
+        QSqlQuery query(db);
+        query.prepare(queryString("select_messagesOldest"));
+        query.bindValue(":bufferid", bufferId.toInt());
+        query.bindValue(":lastmsg", last.toInt());
+        query.bindValue(":limit", limit);
+        safeExec(query);
+        error = !watchQuery(query);
+
+        while (query.next()) {
+            Message msg(QDateTime::fromMSecsSinceEpoch(query.value(1).toLongLong()),
+                bufferInfo,
+                (Message::Type)query.value(2).toUInt(),
+                decodeContents(query.value(5), query.value(6)),
+                query.value(4).toString(),
+                (Message::Flags)query.value(3).toUInt());
+            msg.setMsgId(query.value(0).toInt());
+            messagelist << msg;
+        }
+    }
+
+    db.commit();
+    unlock();
+    if (error)
+        messagelist.clear();
+    return messagelist;
+}
+
+
+bool SqliteStorage::deleteMsgsUntil(UserId user, BufferId bufferId, MsgId last)
+{
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    bool error = false;
+    {
+        QSqlQuery bufferInfoQuery(db);
+        bufferInfoQuery.prepare(queryString("select_buffer_by_id"));
+        bufferInfoQuery.bindValue(":userid", user.toInt());
+        bufferInfoQuery.bindValue(":bufferid", bufferId.toInt());
+
+        lockForWrite();
+        safeExec(bufferInfoQuery);
+        error = !watchQuery(bufferInfoQuery) || !bufferInfoQuery.first();
+    }
+
+    if (!error) {
+        QSqlQuery deleteQuery(db);
+        deleteQuery.prepare(queryString("delete_backlog_for_buffer_until"));
+        deleteQuery.bindValue(":bufferid", bufferId.toInt());
+        deleteQuery.bindValue(":lastmsg", last.toInt());
+        safeExec(deleteQuery);
+        error = !watchQuery(deleteQuery);
+    }
+
+    if (error)
+        db.rollback();
+    else
+        db.commit();
+    unlock();
+    return !error;
+}
+
+
+bool SqliteStorage::restoreMsgs(UserId user, BufferId bufferId, const QList<Message> &msgs)
+{
+    QSqlDatabase db = logDb();
+    db.transaction();
+
+    bool error = false;
+    {
+        QSqlQuery bufferInfoQuery(db);
+        bufferInfoQuery.prepare(queryString("select_buffer_by_id"));
+        bufferInfoQuery.bindValue(":userid", user.toInt());
+        bufferInfoQuery.bindValue(":bufferid", bufferId.toInt());
+
+        lockForWrite();
+        safeExec(bufferInfoQuery);
+        error = !watchQuery(bufferInfoQuery) || !bufferInfoQuery.first();
+    }
+    if (error) {
+        db.rollback();
+        unlock();
+        return false;
+    }
+
+    {
+        QSet<QString> senders;
+        QSet<QString> hosts;
+        QSqlQuery addSenderQuery(db);
+        addSenderQuery.prepare(queryString("insert_sender"));
+        QSqlQuery addHostQuery(db);
+        addHostQuery.prepare(queryString("insert_senderhost"));
+        for (int i = 0; i < msgs.count(); i++) {
+            QString sender, host;
+            splitSender(msgs.at(i).sender(), sender, host);
+            if (!senders.contains(sender)) {
+                senders << sender;
+                addSenderQuery.bindValue(":sender", sender);
+                addSenderQuery.bindValue(":nick", nickFromMask(sender));
+                addSenderQuery.bindValue(":ident", userFromMask(sender));
+                safeExec(addSenderQuery);
+            }
+            if (!host.isEmpty() && !hosts.contains(host)) {
+                hosts << host;
+                addHostQuery.bindValue(":host", host);
+                safeExec(addHostQuery);
+            }
+        }
+    }
+
+    {
+        QSqlQuery restoreQuery(db);
+        restoreQuery.prepare(queryString("insert_message_with_id"));
+        for (int i = 0; i < msgs.count(); i++) {
+            const Message &msg = msgs.at(i);
+
+            restoreQuery.bindValue(":messageid", msg.msgId().toInt());
+            restoreQuery.bindValue(":time", msg.timestamp().toMSecsSinceEpoch());
+            restoreQuery.bindValue(":bufferid", bufferId.toInt());
+            restoreQuery.bindValue(":type", msg.type());
+            restoreQuery.bindValue(":flags", (int)msg.flags());
+            QString sender, host;
+            splitSender(msg.sender(), sender, host);
+            restoreQuery.bindValue(":sender", sender);
+            restoreQuery.bindValue(":host", host);
+            QVariant message, messageData;
+            encodeContents(msg.contents(), message, messageData);
+            restoreQuery.bindValue(":message", message);
+            restoreQuery.bindValue(":messagedata", messageData);
+
+            safeExec(restoreQuery);
+            if (!watchQuery(restoreQuery)) {
+                error = true;
+                break;
+            }
+        }
+    }
+
+    if (error) {
+        db.rollback();
+    }
+    else {
+        db.commit();
+    }
+    unlock();
+    return !error;
+}
+
+
 QString SqliteStorage::backlogFile()
 {
     return Quassel::configDirPath() + "quassel-storage.sqlite";
@@ -1704,7 +2289,10 @@ QString SqliteStorage::backlogFile()
 
 bool SqliteStorage::safeExec(QSqlQuery &query, int retryCount)
 {
+    Metrics::Timer timer;
     query.exec();
+    if (Metrics::isEnabled())
+        recordQueryTime(query, timer.elapsed());
 
     if (!query.lastError().isValid())
         return true;
@@ -1737,6 +2325,9 @@ void SqliteMigrationReader::setMaxId(MigrationObject mo)
     case Sender:
         queryString = "SELECT max(senderid) FROM sender";
         break;
+    case SenderHost:
+        queryString = "SELECT max(hostid) FROM senderhost";
+        break;
     case Backlog:
         queryString = "SELECT max(messageid) FROM backlog";
         break;
@@ -1775,6 +2366,11 @@ bool SqliteMigrationReader::prepareQuery(MigrationObject mo)
         bindValue(0, 0);
         bindValue(1, stepSize());
         break;
+    case SenderHost:
+        newQuery(queryString("migrate_read_senderhost"), logDb());
+        bindValue(0, 0);
+        bindValue(1, stepSize());
+        break;
     case Backlog:
         newQuery(queryString("migrate_read_backlog"), logDb());
         bindValue(0, 0);
@@ -1921,6 +2517,28 @@ bool SqliteMigrationReader::readMo(SenderMO &sender)
 }
 
 
+bool SqliteMigrationReader::readMo(SenderHostMO &senderHost)
+{
+    int skipSteps = 0;
+    while (!next()) {
+        if (senderHost.hostId < _maxId) {
+            bindValue(0, senderHost.hostId + (skipSteps * stepSize()));
+            bindValue(1, senderHost.hostId + ((skipSteps + 1) * stepSize()));
+            skipSteps++;
+            if (!exec())
+                return false;
+        }
+        else {
+            return false;
+        }
+    }
+
+    senderHost.hostId = value(0).toInt();
+    senderHost.host = value(1).toString();
+    return true;
+}
+
+
 bool SqliteMigrationReader::readMo(BacklogMO &backlog)
 {
     int skipSteps = 0;
@@ -1938,12 +2556,13 @@ bool SqliteMigrationReader::readMo(BacklogMO &backlog)
     }
 
     backlog.messageid = value(0).toInt();
-    backlog.time = QDateTime::fromTime_t(value(1).toInt()).toUTC();
+    backlog.time = QDateTime::fromMSecsSinceEpoch(value(1).toLongLong()).toUTC();
     backlog.bufferid = value(2).toInt();
     backlog.type = value(3).toInt();
     backlog.flags = value(4).toInt();
     backlog.senderid = value(5).toInt();
-    backlog.message = value(6).toString();
+    backlog.hostid = value(6).toInt();
+    backlog.message = decodeContents(value(7), value(8));
     return true;
 }
 
@@ -96,12 +96,22 @@ public slots:
     virtual QHash<BufferId, MsgId> bufferLastSeenMsgIds(UserId user);
     virtual void setBufferMarkerLineMsg(UserId user, const BufferId &bufferId, const MsgId &msgId);
     virtual QHash<BufferId, MsgId> bufferMarkerLineMsgIds(UserId user);
+    virtual QHash<BufferId, ActivityCount> bufferActivityCounts(UserId user);
+    virtual ActivityCount bufferActivityCount(UserId user, BufferId bufferId, MsgId lastSeenMsgId);
 
     /* Message handling */
     virtual bool logMessage(Message &msg);
     virtual bool logMessages(MessageList &msgs);
     virtual QList<Message> requestMsgs(UserId user, BufferId bufferId, MsgId first = -1, MsgId last = -1, int limit = -1);
+    virtual QList<Message> requestMsgsMulti(UserId user, const QList<MsgRequest> &requests);
+    virtual QList<Message> requestMsgsByTime(UserId user, BufferId bufferId, const QDateTime &time, MsgId first = -1, MsgId last = -1, int before = 0, int after = -1);
     virtual QList<Message> requestAllMsgs(UserId user, MsgId first = -1, MsgId last = -1, int limit = -1);
+    virtual QList<Message> requestHighlightMsgs(UserId user, MsgId first = -1, int limit = -1);
+    virtual QList<Message> requestMsgsBySender(UserId user, BufferId bufferId, const QString &nick, MsgId last = -1, int limit = -1);
+    virtual MsgId expiredMsgsBoundary(UserId user, BufferId bufferId, const QDateTime &minTime, int maxCount);
+    virtual QList<Message> requestExpiredMsgs(UserId user, BufferId bufferId, MsgId last, int limit);
+    virtual bool deleteMsgsUntil(UserId user, BufferId bufferId, MsgId last);
+    virtual bool restoreMsgs(UserId user, BufferId bufferId, const QList<Message> &msgs);
 
 protected:
     inline virtual void setConnectionProperties(const QVariantMap & /* properties */) {}
@@ -137,6 +147,7 @@ public:
 
     virtual bool readMo(QuasselUserMO &user);
     virtual bool readMo(SenderMO &sender);
+    virtual bool readMo(SenderHostMO &senderHost);
     virtual bool readMo(IdentityMO &identity);
     virtual bool readMo(IdentityNickMO &identityNick);
     virtual bool readMo(NetworkMO &network);
@@ -32,3 +32,13 @@ QString Storage::cryptedPassword(const QString &password)
 {
     return QString(QCryptographicHash::hash(password.toUtf8(), QCryptographicHash::Sha1).toHex());
 }
+
+
+QList<Message> Storage::requestMsgsMulti(UserId user, const QList<MsgRequest> &requests)
+{
+    QList<Message> messagelist;
+    foreach(const MsgRequest &request, requests) {
+        messagelist << requestMsgs(user, request.bufferId, request.first, request.last, request.limit);
+    }
+    return messagelist;
+}
@@ -42,6 +42,31 @@ public:
         NotAvailable // remove the storage backend from the list of avaliable backends
     };
 
+    //! A single per-buffer range as used by requestMsgsMulti()
+    /** The members have the same meaning as the corresponding parameters of requestMsgs(). */
+    struct MsgRequest {
+        BufferId bufferId;
+        MsgId first;
+        MsgId last;
+        int limit;
+        MsgRequest(BufferId bufferId_ = BufferId(), MsgId first_ = -1, MsgId last_ = -1, int limit_ = -1)
+            : bufferId(bufferId_), first(first_), last(last_), limit(limit_) {}
+    };
+
+    //! Unread messages of a buffer, and how many of them are highlights (\sa bufferActivityCounts())
+    struct ActivityCount {
+        int unread;
+        int highlights;
+        ActivityCount(int unread_ = 0, int highlights_ = 0) : unread(unread_), highlights(highlights_) {}
+    };
+
+    //! The message types counted as unread; messages sent by the user never count
+    static const int unreadMessageTypes = Message::Plain | Message::Notice | Message::Action;
+    static inline bool countsAsUnread(const Message &msg)
+    {
+        return (msg.type() & unreadMessageTypes) && !(msg.flags() & Message::Self);
+    }
+
 public slots:
     /* General */
 
@@ -364,6 +389,20 @@ public slots:
      */
     virtual QHash<BufferId, MsgId> bufferMarkerLineMsgIds(UserId user) = 0;
 
+    //! Count the unread messages in all buffers of a user
+    /** Messages after the stored last seen message id are unread (\sa countsAsUnread()).
+     *  \param user      The Owner of the buffers
+     *  \return The counts of all buffers that have unread messages
+     */
+    virtual QHash<BufferId, ActivityCount> bufferActivityCounts(UserId user) = 0;
+
+    //! Count the unread messages in a buffer
+    /** \param user          The Owner of that Buffer
+     *  \param bufferId      The buffer id
+     *  \param lastSeenMsgId Messages after this one are unread
+     */
+    virtual ActivityCount bufferActivityCount(UserId user, BufferId bufferId, MsgId lastSeenMsgId) = 0;
+
     /* Message handling */
 
     //! Store a Message in the storage backend and set its unique Id.
@@ -387,6 +426,25 @@ public slots:
      */
     virtual QList<Message> requestMsgs(UserId user, BufferId bufferId, MsgId first = -1, MsgId last = -1, int limit = -1) = 0;
 
+    //! Request messages for several buffers at once.
+    /** The default implementation calls requestMsgs() for every request; backends should
+     *  reimplement this with a set-based query. Requests for buffers not owned by \p user are ignored.
+     *  \param requests The per-buffer ranges to fetch
+     *  \return The requested messages of all buffers; the order between buffers is unspecified
+     */
+    virtual QList<Message> requestMsgsMulti(UserId user, const QList<MsgRequest> &requests);
+
+    //! Request messages of a buffer around a point in time
+    /** Messages are split at the first message at or after \p time and paged by MsgId from there.
+     *  \param time     The point in time
+     *  \param first    if != -1 split at this MsgId instead, ignoring \p time
+     *  \param last     if != -1 return only messages with a MsgId < last
+     *  \param before   Max amount of messages before the split
+     *  \param after    Max amount of messages from the split on, -1 for all of them
+     *  \return The requested list of messages, newest first
+     */
+    virtual QList<Message> requestMsgsByTime(UserId user, BufferId bufferId, const QDateTime &time, MsgId first = -1, MsgId last = -1, int before = 0, int after = -1) = 0;
+
     //! Request a certain number of messages across all buffers
     /** \param first    if != -1 return only messages with a MsgId >= first
      *  \param last     if != -1 return only messages with a MsgId < last
@@ -395,6 +453,56 @@ public slots:
      */
     virtual QList<Message> requestAllMsgs(UserId user, MsgId first = -1, MsgId last = -1, int limit = -1) = 0;
 
+    //! Request the most recent highlighted messages across all buffers
+    /** Highlights are flagged by the core when a message is stored.
+     *  \param first    if != -1 return only messages with a MsgId >= first
+     *  \param limit    Max amount of messages
+     *  \return The requested list of messages, newest first
+     */
+    virtual QList<Message> requestHighlightMsgs(UserId user, MsgId first = -1, int limit = -1) = 0;
+
+    //! Request the messages sent by a nick
+    /** The nick is compared case insensitively and looked up through an index, independent of the
+     *  ident and host the messages were sent from.
+     *  \param bufferId if valid return only messages of this buffer, otherwise of all buffers
+     *  \param last     if != -1 return only messages with a MsgId < last
+     *  \param limit    Max amount of messages
+     *  \return The requested list of messages, newest first
+     */
+    virtual QList<Message> requestMsgsBySender(UserId user, BufferId bufferId, const QString &nick, MsgId last = -1, int limit = -1) = 0;
+
+    /* Backlog retention */
+
+    //! Find the oldest message of a buffer that is still to be kept
+    /** \param minTime   Keep only messages at or after this time, invalid for no age limit
+     *  \param maxCount  Keep only the newest \p maxCount messages, 0 for no count limit
+     *  \return Messages with a MsgId < the returned one are expired; an invalid MsgId if none are
+     */
+    virtual MsgId expiredMsgsBoundary(UserId user, BufferId bufferId, const QDateTime &minTime, int maxCount) = 0;
+
+    //! Request the oldest messages of a buffer
+    /** Used to archive expired messages before deleteMsgsUntil() removes them.
+     *  \param last     Return only messages with a MsgId < last
+     *  \param limit    Max amount of messages to return
+     *  \return The requested messages, oldest first
+     */
+    virtual QList<Message> requestExpiredMsgs(UserId user, BufferId bufferId, MsgId last, int limit) = 0;
+
+    //! Remove the oldest messages of a buffer
+    /** This runs in one short transaction, so callers should remove large backlogs in batches
+     *  to not block other accesses to the storage for long.
+     *  \param last     Remove all messages with a MsgId <= last
+     *  \return true on success
+     */
+    virtual bool deleteMsgsUntil(UserId user, BufferId bufferId, MsgId last) = 0;
+
+    //! Store previously pruned messages again
+    /** The messages keep their original MsgId; messages whose MsgId is in use already are skipped.
+     *  \param msgs     The messages to restore
+     *  \return true on success
+     */
+    virtual bool restoreMsgs(UserId user, BufferId bufferId, const QList<Message> &msgs) = 0;
+
 signals:
     //! Sent when a new BufferInfo is created, or an existing one changed somehow.
     void bufferInfoUpdated(UserId user, const BufferInfo &);
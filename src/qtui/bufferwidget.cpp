@@ -18,6 +18,9 @@
  *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
  ***************************************************************************/
 
+#include <QDateTimeEdit>
+#include <QDialog>
+#include <QDialogButtonBox>
 #include <QLayout>
 #include <QKeyEvent>
 #include <QMenu>
@@ -98,6 +101,9 @@ BufferWidget::BufferWidget(QWidget *parent)
     jumpToMarkerLine->setText(tr("Go to Marker Line"));
     jumpToMarkerLine->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_K));
 
+    Action *jumpToDate = QtUi::actionCollection("Navigation")->add<Action>("JumpToDate", this, SLOT(jumpToDate()));
+    jumpToDate->setText(tr("Go to Date..."));
+
     ChatViewSettings s;
     s.initAndNotify("AutoMarkerLine", this, SLOT(setAutoMarkerLine(QVariant)), true);
     s.initAndNotify("AutoMarkerLineOnLostFocus", this, SLOT(setAutoMarkerLineOnLostFocus(QVariant)), true);
@@ -199,6 +205,10 @@ void BufferWidget::addActionsToMenu(QMenu *menu, const QPointF &pos)
     menu->addAction(coll->action("ZoomInChatView"));
     menu->addAction(coll->action("ZoomOutChatView"));
     menu->addAction(coll->action("ZoomOriginalChatView"));
+    if (Client::coreFeatures() & Quassel::BacklogByTime) {
+        menu->addSeparator();
+        menu->addAction(QtUi::actionCollection("Navigation")->action("JumpToDate"));
+    }
 }
 
 
@@ -298,3 +308,28 @@ void BufferWidget::jumpToMarkerLine(ChatView *view, bool requestBacklog)
 
     view->jumpToMarkerLine(requestBacklog);
 }
+
+
+void BufferWidget::jumpToDate(ChatView *view)
+{
+    if (!view)
+        view = qobject_cast<ChatView *>(ui.stackedWidget->currentWidget());
+    if (!view)
+        return;
+
+    QDialog dialog(this);
+    dialog.setWindowTitle(tr("Go to Date"));
+    QDateTimeEdit *dateTimeEdit = new QDateTimeEdit(QDateTime::currentDateTime(), &dialog);
+    dateTimeEdit->setCalendarPopup(true);
+    QDialogButtonBox *buttonBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, Qt::Horizontal, &dialog);
+    connect(buttonBox, SIGNAL(accepted()), &dialog, SLOT(accept()));
+    connect(buttonBox, SIGNAL(rejected()), &dialog, SLOT(reject()));
+    QVBoxLayout *layout = new QVBoxLayout(&dialog);
+    layout->addWidget(dateTimeEdit);
+    layout->addWidget(buttonBox);
+
+    if (dialog.exec() != QDialog::Accepted)
+        return;
+
+    view->jumpToDate(dateTimeEdit->dateTime());
+}
@@ -47,6 +47,7 @@ public:
 public slots:
     virtual void setMarkerLine(ChatView *view = 0, bool allowGoingBack = true);
     virtual void jumpToMarkerLine(ChatView *view = 0, bool requestBacklog = true);
+    virtual void jumpToDate(ChatView *view = 0);
 
 protected:
     virtual AbstractChatView *createChatView(BufferId);
@@ -63,6 +63,8 @@ ChannelListDlg::ChannelListDlg(QWidget *parent)
     connect(ui.filterLineEdit, SIGNAL(textChanged(QString)), &_sortFilter, SLOT(setFilterFixedString(QString)));
     connect(Client::ircListHelper(), SIGNAL(channelListReceived(const NetworkId &, const QStringList &, QList<IrcListHelper::ChannelDescription> )),
         this, SLOT(receiveChannelList(NetworkId, QStringList, QList<IrcListHelper::ChannelDescription> )));
+    connect(Client::ircListHelper(), SIGNAL(channelListPageReceived(const NetworkId &, QList<IrcListHelper::ChannelDescription> )),
+        this, SLOT(receiveChannelListPage(NetworkId, QList<IrcListHelper::ChannelDescription> )));
     connect(Client::ircListHelper(), SIGNAL(finishedListReported(const NetworkId &)), this, SLOT(reportFinishedList()));
     connect(Client::ircListHelper(), SIGNAL(errorReported(const QString &)), this, SLOT(showError(const QString &)));
     connect(ui.channelListView, SIGNAL(activated(QModelIndex)), this, SLOT(joinChannel(QModelIndex)));
@@ -92,7 +94,17 @@ void ChannelListDlg::requestSearch()
     showErrors(false);
     QStringList channelFilters;
     channelFilters << ui.channelNameLineEdit->text().trimmed();
-    Client::ircListHelper()->requestChannelList(_netId, channelFilters);
+
+    if (Client::coreFeatures() & Quassel::PagedChannelList) {
+        // pages are appended as they arrive, so start with an empty list
+        _ircListModel.setChannelList();
+        showFilterLine(false);
+    }
+
+    QVariantMap filter;
+    if (ui.minUsersSpinBox->value() > 0)
+        filter["MinUsers"] = ui.minUsersSpinBox->value();
+    Client::ircListHelper()->requestFilteredChannelList(_netId, channelFilters, filter);
 }
 
 
@@ -108,6 +120,16 @@ void ChannelListDlg::receiveChannelList(const NetworkId &netId, const QStringLis
 }
 
 
+void ChannelListDlg::receiveChannelListPage(const NetworkId &netId, const QList<IrcListHelper::ChannelDescription> &channelList)
+{
+    if (netId != _netId)
+        return;
+
+    showFilterLine(true);
+    _ircListModel.appendChannelList(channelList);
+}
+
+
 void ChannelListDlg::showFilterLine(bool show)
 {
     ui.line->setVisible(show);
@@ -119,6 +141,7 @@ void ChannelListDlg::showFilterLine(bool show)
 void ChannelListDlg::enableQuery(bool enable)
 {
     ui.channelNameLineEdit->setEnabled(enable);
+    ui.minUsersSpinBox->setEnabled(enable);
     ui.searchChannelsButton->setEnabled(enable);
 }
 
@@ -146,6 +169,12 @@ void ChannelListDlg::setAdvancedMode(bool advanced)
     ui.channelNameLineEdit->clear();
     ui.channelNameLineEdit->setVisible(advanced);
     ui.searchPatternLabel->setVisible(advanced);
+
+    // filtering by user count is done by the core
+    bool minUsers = advanced && (Client::coreFeatures() & Quassel::PagedChannelList);
+    ui.minUsersSpinBox->setValue(0);
+    ui.minUsersSpinBox->setVisible(minUsers);
+    ui.minUsersLabel->setVisible(minUsers);
 }
 
 
@@ -162,6 +191,8 @@ void ChannelListDlg::showErrors(bool show)
 void ChannelListDlg::reportFinishedList()
 {
     _listFinished = true;
+    if (Client::coreFeatures() & Quassel::PagedChannelList)
+        enableQuery(true);
 }
 
 
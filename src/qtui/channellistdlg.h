@@ -43,6 +43,7 @@ public:
 protected slots:
     void requestSearch();
     void receiveChannelList(const NetworkId &netId, const QStringList &channelFilters, const QList<IrcListHelper::ChannelDescription> &channelList);
+    void receiveChannelListPage(const NetworkId &netId, const QList<IrcListHelper::ChannelDescription> &channelList);
     void reportFinishedList();
     void joinChannel(const QModelIndex &);
 
@@ -39,12 +39,39 @@ ChatLineModel::ChatLineModel(QObject *parent)
 void ChatLineModel::insertMessages__(int pos, const QList<Message> &messages)
 {
     for (int i = 0; i < messages.count(); i++) {
-        _messageList.insert(pos, ChatLineModelItem(messages[i]));
+        _messageList.insert(pos, createItem(messages[i]));
         pos++;
     }
 }
 
 
+void ChatLineModel::insertPrecomputedMessages(const QList<Message> &messages, const QList<ChatLineModelItem> &items)
+{
+    Q_ASSERT(messages.count() == items.count());
+    for (int i = 0; i < items.count(); i++) {
+        if (items[i].msgId().isValid())
+            _precomputedItems.insert(items[i].msgId(), items[i]);
+    }
+    insertMessages(messages);
+    // messages the model buffers for later will simply be styled lazily
+    _precomputedItems.clear();
+}
+
+
+ChatLineModelItem ChatLineModel::createItem(const Message &msg)
+{
+    if (!_precomputedItems.isEmpty()) {
+        QHash<MsgId, ChatLineModelItem>::iterator iter = _precomputedItems.find(msg.msgId());
+        if (iter != _precomputedItems.end()) {
+            ChatLineModelItem item = *iter;
+            _precomputedItems.erase(iter);
+            return item;
+        }
+    }
+    return ChatLineModelItem(msg);
+}
+
+
 Message ChatLineModel::takeMessageAt(int i)
 {
     Message msg = _messageList[i].message();
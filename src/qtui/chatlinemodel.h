@@ -23,6 +23,7 @@
 
 #include "messagemodel.h"
 
+#include <QHash>
 #include <QList>
 #include "chatlinemodelitem.h"
 
@@ -42,6 +43,11 @@ public:
     typedef ChatLineModelItem::Word Word;
     typedef ChatLineModelItem::WrapList WrapList;
     virtual inline const MessageModelItem *messageItemAt(int i) const { return &_messageList[i]; }
+
+    //! Inserts messages for which the items have already been built and precomputed elsewhere
+    /** \param items The precomputed items, in the same order as \p messages */
+    void insertPrecomputedMessages(const QList<Message> &messages, const QList<ChatLineModelItem> &items);
+
 protected:
 //   virtual MessageModelItem *createMessageModelItem(const Message &);
 
@@ -52,7 +58,7 @@ protected:
     virtual inline MessageModelItem *firstMessageItem() { return &_messageList.first(); }
     virtual inline const MessageModelItem *lastMessageItem() const { return &_messageList.last(); }
     virtual inline MessageModelItem *lastMessageItem() { return &_messageList.last(); }
-    virtual inline void insertMessage__(int pos, const Message &msg) { _messageList.insert(pos, ChatLineModelItem(msg)); }
+    virtual inline void insertMessage__(int pos, const Message &msg) { _messageList.insert(pos, createItem(msg)); }
     virtual void insertMessages__(int pos, const QList<Message> &);
     virtual inline void removeMessageAt(int i) { _messageList.removeAt(i); }
     virtual inline void removeAllMessages() { _messageList.clear(); }
@@ -62,7 +68,10 @@ protected slots:
     virtual void styleChanged();
 
 private:
+    ChatLineModelItem createItem(const Message &msg);
+
     QList<ChatLineModelItem> _messageList;
+    QHash<MsgId, ChatLineModelItem> _precomputedItems;
 };
 
 
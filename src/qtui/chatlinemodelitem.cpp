@@ -169,7 +169,17 @@ QVariant ChatLineModelItem::backgroundBrush(UiStyle::FormatType subelement, bool
 }
 
 
-void ChatLineModelItem::computeWrapList() const
+void ChatLineModelItem::precompute()
+{
+    _styledMsg.plainContents();
+#if QT_VERSION >= 0x050000
+    if (_wrapList.isEmpty())
+        computeWrapList(false);
+#endif
+}
+
+
+void ChatLineModelItem::computeWrapList(bool useSharedBuffer) const
 {
     QString text = _styledMsg.plainContents();
     int length = text.length();
@@ -177,8 +187,9 @@ void ChatLineModelItem::computeWrapList() const
         return;
 
     QList<ChatLineModel::Word> wplist; // use a temp list which we'll later copy into a QVector for efficiency
+    // the shared buffer may only be used from the GUI thread, otherwise QTextBoundaryFinder allocates its own
     QTextBoundaryFinder finder(QTextBoundaryFinder::Line, _styledMsg.plainContents().unicode(), length,
-        TextBoundaryFinderBuffer, TextBoundaryFinderBufferSize);
+        useSharedBuffer ? TextBoundaryFinderBuffer : 0, useSharedBuffer ? TextBoundaryFinderBufferSize : 0);
 
     int idx;
     int oldidx = 0;
@@ -43,6 +43,12 @@ public:
 
     virtual inline void invalidateWrapList() { _wrapList.clear(); }
 
+    //! Styles the message (and on Qt5 also computes its wrap list) ahead of time
+    /** Safe to call from worker threads, as long as the item isn't accessed concurrently.
+     *  With Qt4, fonts must not be used outside the GUI thread, so the wrap list is left for later.
+     */
+    void precompute();
+
     /// Used to store information about words to be used for wrapping
     struct Word {
         quint16 start;
@@ -60,7 +66,7 @@ private:
     QVariant backgroundBrush(UiStyle::FormatType subelement, bool selected = false) const;
     quint32 messageLabel() const;
 
-    void computeWrapList() const;
+    void computeWrapList(bool useSharedBuffer = true) const;
 
     mutable WrapList _wrapList;
     UiStyle::StyledMessage _styledMsg;
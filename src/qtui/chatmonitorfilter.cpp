@@ -24,7 +24,6 @@
 #include "chatlinemodel.h"
 #include "networkmodel.h"
 #include "chatviewsettings.h"
-#include "clientignorelistmanager.h"
 
 ChatMonitorFilter::ChatMonitorFilter(MessageModel *model, QObject *parent)
     : MessageFilter(model, parent)
@@ -62,18 +61,18 @@ bool ChatMonitorFilter::filterAcceptsRow(int sourceRow, const QModelIndex &sourc
 {
     Q_UNUSED(sourceParent)
 
-    QModelIndex source_index = sourceModel()->index(sourceRow, 0);
-    BufferId bufferId = source_index.data(MessageModel::BufferIdRole).value<BufferId>();
+    const MessageModel::MessageAttributes &attributes = messageModel()->messageAttributes(sourceRow);
+    BufferId bufferId = attributes.bufferId;
 
-    Message::Flags flags = (Message::Flags)source_index.data(MessageModel::FlagsRole).toInt();
+    Message::Flags flags = attributes.flags;
     if ((flags & Message::Backlog) && (!_showBacklog || (!_includeRead &&
-        (Client::networkModel()->lastSeenMsgId(bufferId) >= sourceModel()->data(source_index, MessageModel::MsgIdRole).value<MsgId>()))))
+        (Client::networkModel()->lastSeenMsgId(bufferId) >= attributes.msgId))))
         return false;
 
     if (!_showOwnMessages && flags & Message::Self)
         return false;
 
-    Message::Type type = (Message::Type)source_index.data(MessageModel::TypeRole).toInt();
+    Message::Type type = attributes.type;
     if (!(type & (Message::Plain | Message::Notice | Message::Action)))
         return false;
 
@@ -88,9 +87,7 @@ bool ChatMonitorFilter::filterAcceptsRow(int sourceRow, const QModelIndex &sourc
         return false;
 
     // ignorelist handling
-    // only match if message is not flagged as server msg
-    if (!(flags & Message::ServerMsg) && Client::ignoreListManager()
-        && Client::ignoreListManager()->match(source_index.data(MessageModel::MessageRole).value<Message>(), Client::networkModel()->networkName(bufferId)))
+    if (messageModel()->isIgnored(sourceRow))
         return false;
     return true;
 }
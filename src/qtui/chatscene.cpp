@@ -39,6 +39,7 @@
 #  include <QWebView>
 #endif
 
+#include "backlogsettings.h"
 #include "chatitem.h"
 #include "chatline.h"
 #include "chatlinemodelitem.h"
@@ -322,6 +323,67 @@ void ChatScene::jumpToMarkerLine(bool requestBacklog)
 }
 
 
+void ChatScene::jumpToDate(const QDateTime &time)
+{
+    if (!isSingleBufferScene())
+        return;
+
+    _dateJumpPending = QDateTime();
+    if (jumpToLoadedDate(time, false))
+        return;
+
+    _dateJumpPending = time;
+    if (Client::coreFeatures() & Quassel::BacklogByTime) {
+        // fetch a page before the date and everything from there up to the lines we already have,
+        // so the buffer stays contiguous. The second part is its own request, so the backlog manager
+        // can tell when it needs to page forward in chunks of the same size.
+        MsgId oldestMsgId = -1;
+        foreach(ChatLine *line, _lines) {
+            if (line->msgType() != Message::DayChange) {
+                oldestMsgId = line->msgId();
+                break;
+            }
+        }
+        BacklogSettings backlogSettings;
+        int pageSize = backlogSettings.dynamicBacklogAmount();
+        Client::backlogManager()->requestBacklogByTime(singleBufferId(), time.toUTC(), -1, oldestMsgId, pageSize, 0);
+        Client::backlogManager()->requestBacklogByTime(singleBufferId(), time.toUTC(), -1, oldestMsgId, 0, pageSize);
+    }
+    else {
+        // older cores only allow paging backwards; every fetched page retries the jump
+        requestBacklog();
+    }
+}
+
+
+// jumps to the first line at or after the given time, unless older lines might still be missing
+bool ChatScene::jumpToLoadedDate(const QDateTime &time, bool force)
+{
+    if (_lines.isEmpty())
+        return false;
+
+    if (!force && _lines.first()->timestamp() > time)
+        return false;
+
+    // lines are sorted by MsgId, and thus (almost) by time
+    int start = 0;
+    int n = _lines.count();
+    while (n > 0) {
+        int half = n >> 1;
+        if (_lines.at(start + half)->timestamp() < time) {
+            start += half + 1;
+            n -= half + 1;
+        }
+        else {
+            n = half;
+        }
+    }
+    ChatLine *line = _lines.at(qMin(start, _lines.count() - 1));
+    line->ensureVisible(QRectF(), 50, 50);
+    return true;
+}
+
+
 void ChatScene::rowsInserted(const QModelIndex &index, int start, int end)
 {
     Q_UNUSED(index);
@@ -460,6 +522,15 @@ void ChatScene::rowsInserted(const QModelIndex &index, int start, int end)
     // now move the marker line if necessary. we don't need to do anything if we appended lines though...
     if (!_markerLineValid)
         setMarkerLine();
+
+    if (_dateJumpPending.isValid() && atTop) {
+        // a reply to a request by time reaches back as far as the buffer does
+        bool byTime = Client::coreFeatures() & Quassel::BacklogByTime;
+        if (jumpToLoadedDate(_dateJumpPending, byTime))
+            _dateJumpPending = QDateTime();
+        else
+            requestBacklog();
+    }
 }
 
 
@@ -23,6 +23,7 @@
 
 #include <QAbstractItemModel>
 #include <QClipboard>
+#include <QDateTime>
 #include <QGraphicsItem>
 #include <QGraphicsScene>
 #include <QSet>
@@ -135,6 +136,7 @@ public slots:
     void setMarkerLineVisible(bool visible = true);
     void setMarkerLine(MsgId msgId = MsgId());
     void jumpToMarkerLine(bool requestBacklog);
+    void jumpToDate(const QDateTime &time);
 
     // these are used by the chatitems to notify the scene and manage selections
     void setSelectingItem(ChatItem *item);
@@ -206,6 +208,9 @@ private:
     MarkerLineItem *_markerLine;
     bool _markerLineVisible, _markerLineValid, _markerLineJumpPending;
 
+    QDateTime _dateJumpPending;
+    bool jumpToLoadedDate(const QDateTime &time, bool force);
+
     ColumnHandleItem *_firstColHandle, *_secondColHandle;
     qreal _firstColHandlePos, _secondColHandlePos;
     int _defaultFirstColHandlePos, _defaultSecondColHandlePos;
@@ -325,6 +325,12 @@ void ChatView::jumpToMarkerLine(bool requestBacklog)
 }
 
 
+void ChatView::jumpToDate(const QDateTime &time)
+{
+    scene()->jumpToDate(time);
+}
+
+
 void ChatView::addActionsToMenu(QMenu *menu, const QPointF &pos)
 {
     // zoom actions
@@ -88,6 +88,7 @@ public slots:
     void setMarkerLineVisible(bool visible = true);
     void setMarkerLine(MsgId msgId);
     void jumpToMarkerLine(bool requestBacklog);
+    void jumpToDate(const QDateTime &time);
 
 protected:
     virtual bool event(QEvent *event);
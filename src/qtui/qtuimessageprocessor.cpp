@@ -20,16 +20,62 @@
 
 #include "qtuimessageprocessor.h"
 
+#include <QAtomicInt>
+#include <QRunnable>
+#include <QThread>
+#include <QVector>
+
+#include "chatlinemodel.h"
 #include "client.h"
 #include "clientsettings.h"
 #include "identity.h"
 #include "messagemodel.h"
 #include "network.h"
 
+struct QtUiMessageProcessor::PrecomputeBatch {
+    int generation;
+    QList<Message> messages;
+    QVector<QList<ChatLineModelItem> > chunks;
+    QAtomicInt pendingChunks;
+};
+
+
+class QtUiMessageProcessor::PrecomputeTask : public QRunnable
+{
+public:
+    PrecomputeTask(QtUiMessageProcessor *processor, QSharedPointer<PrecomputeBatch> batch, int chunk, int first, int count)
+        : _processor(processor), _batch(batch), _chunk(chunk), _first(first), _count(count) {}
+
+    void run()
+    {
+        QList<ChatLineModelItem> items;
+        for (int i = _first; i < _first + _count; i++) {
+            ChatLineModelItem item(_batch->messages.at(i));
+            item.precompute();
+            items << item;
+        }
+        // every task writes its own, preallocated slot
+        _batch->chunks.data()[_chunk] = items;
+
+        if (!_batch->pendingChunks.deref())
+            _processor->batchFinished(_batch);
+    }
+
+private:
+    QtUiMessageProcessor *_processor;
+    QSharedPointer<PrecomputeBatch> _batch;
+    int _chunk;
+    int _first;
+    int _count;
+};
+
+
 QtUiMessageProcessor::QtUiMessageProcessor(QObject *parent)
     : AbstractMessageProcessor(parent),
     _processing(false),
-    _processMode(TimerBased)
+    _processMode(QThread::idealThreadCount() > 1 ? Concurrent : TimerBased),
+    _pendingBatches(0),
+    _generation(0)
 {
     NotificationSettings notificationSettings;
     _nicksCaseSensitive = notificationSettings.nicksCaseSensitive();
@@ -44,6 +90,13 @@ QtUiMessageProcessor::QtUiMessageProcessor(QObject *parent)
 }
 
 
+QtUiMessageProcessor::~QtUiMessageProcessor()
+{
+    // running tasks still report back to us
+    _threadPool.waitForDone();
+}
+
+
 void QtUiMessageProcessor::reset()
 {
     if (processMode() == TimerBased) {
@@ -52,6 +105,16 @@ void QtUiMessageProcessor::reset()
         _currentBatch.clear();
         _processQueue.clear();
     }
+    else {
+        // batches still being precomputed belong to the old session and will be dropped
+        _generation++;
+    }
+}
+
+
+bool QtUiMessageProcessor::hasPendingMessages() const
+{
+    return _pendingBatches > 0;
 }
 
 
@@ -72,6 +135,10 @@ void QtUiMessageProcessor::process(QList<Message> &msgs)
         preProcess(*msgIter);
         msgIter++;
     }
+    if (processMode() == Concurrent && msgs.count() >= minConcurrentBatchSize) {
+        precompute(msgs);
+        return;
+    }
     Client::messageModel()->insertMessages(msgs);
     return;
 
@@ -109,11 +176,76 @@ void QtUiMessageProcessor::processNextMessage()
 }
 
 
+void QtUiMessageProcessor::precompute(const QList<Message> &msgs)
+{
+    QSharedPointer<PrecomputeBatch> batch(new PrecomputeBatch);
+    batch->generation = _generation;
+    batch->messages = msgs;
+
+    int threads = _threadPool.maxThreadCount();
+    int chunkSize = qMax(minChunkSize, (msgs.count() + threads - 1) / threads);
+    int chunkCount = (msgs.count() + chunkSize - 1) / chunkSize;
+    batch->chunks.resize(chunkCount);
+    batch->pendingChunks = chunkCount;
+    _pendingBatches++;
+
+    for (int i = 0; i < chunkCount; i++) {
+        int first = i * chunkSize;
+        _threadPool.start(new PrecomputeTask(this, batch, i, first, qMin(chunkSize, msgs.count() - first)));
+    }
+}
+
+
+// called from the worker thread that finished the last chunk of a batch
+void QtUiMessageProcessor::batchFinished(QSharedPointer<PrecomputeBatch> batch)
+{
+    QMutexLocker locker(&_finishedBatchesMutex);
+    _finishedBatches << batch;
+    if (_finishedBatches.count() == 1)
+        QMetaObject::invokeMethod(this, "insertPrecomputedBatches", Qt::QueuedConnection);
+}
+
+
+void QtUiMessageProcessor::insertPrecomputedBatches()
+{
+    QList<QSharedPointer<PrecomputeBatch> > batches;
+    {
+        QMutexLocker locker(&_finishedBatchesMutex);
+        batches = _finishedBatches;
+        _finishedBatches.clear();
+    }
+
+    ChatLineModel *chatLineModel = qobject_cast<ChatLineModel *>(Client::messageModel());
+    foreach(QSharedPointer<PrecomputeBatch> batch, batches) {
+        _pendingBatches--;
+        if (batch->generation != _generation)
+            continue;
+
+        if (!chatLineModel) {
+            Client::messageModel()->insertMessages(batch->messages);
+            continue;
+        }
+        QList<ChatLineModelItem> items;
+        foreach(const QList<ChatLineModelItem> &chunk, batch->chunks) {
+            items << chunk;
+        }
+        chatLineModel->insertPrecomputedMessages(batch->messages, items);
+    }
+
+    if (!batches.isEmpty() && !_pendingBatches)
+        emit pendingMessagesInserted();
+}
+
+
 void QtUiMessageProcessor::checkForHighlight(Message &msg)
 {
     if (!((msg.type() & (Message::Plain | Message::Notice | Message::Action)) && !(msg.flags() & Message::Self)))
         return;
 
+    // the core flags new messages itself; backlog may have been stored before it could
+    if ((Client::coreFeatures() & Quassel::CoreSideHighlights) && !(msg.flags() & Message::Backlog))
+        return;
+
     // TODO: Cache this (per network)
     const Network *net = Client::network(msg.bufferInfo().networkId());
     if (net && !net->myNick().isEmpty()) {
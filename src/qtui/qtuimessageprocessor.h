@@ -21,6 +21,9 @@
 #ifndef QTUIMESSAGEPROCESSOR_H_
 #define QTUIMESSAGEPROCESSOR_H_
 
+#include <QMutex>
+#include <QSharedPointer>
+#include <QThreadPool>
 #include <QTimer>
 
 #include "abstractmessageprocessor.h"
@@ -36,11 +39,13 @@ public:
     };
 
     QtUiMessageProcessor(QObject *parent);
+    ~QtUiMessageProcessor();
 
     inline bool isProcessing() const { return _processing; }
     inline Mode processMode() const { return _processMode; }
 
     void reset();
+    bool hasPendingMessages() const;
 
 public slots:
     void process(Message &msg);
@@ -48,6 +53,7 @@ public slots:
 
 private slots:
     void processNextMessage();
+    void insertPrecomputedBatches();
     void nicksCaseSensitiveChanged(const QVariant &variant);
     void highlightListChanged(const QVariant &variant);
     void highlightNickChanged(const QVariant &variant);
@@ -56,12 +62,28 @@ private:
     void checkForHighlight(Message &msg);
     void startProcessing();
 
+    // Concurrent mode: larger batches are styled and laid out by the thread pool before
+    // they are inserted into the model, so the GUI thread only has to do the insertion
+    struct PrecomputeBatch;
+    class PrecomputeTask;
+    void precompute(const QList<Message> &msgs);
+    void batchFinished(QSharedPointer<PrecomputeBatch> batch);
+
+    static const int minConcurrentBatchSize = 64;
+    static const int minChunkSize = 32;
+
     QList<QList<Message> > _processQueue;
     QList<Message> _currentBatch;
     QTimer _processTimer;
     bool _processing;
     Mode _processMode;
 
+    QThreadPool _threadPool;
+    QMutex _finishedBatchesMutex;
+    QList<QSharedPointer<PrecomputeBatch> > _finishedBatches;
+    int _pendingBatches; // precomputing or waiting for insertion
+    int _generation;
+
     struct HighlightRule {
         QString name;
         bool isEnabled;
@@ -232,7 +232,7 @@ bool BufferViewFilter::dropMimeData(const QMimeData *data, Qt::DropAction action
             if (row < rowCount(parent)) {
                 QModelIndex source_child = mapToSource(index(row, 0, parent));
                 BufferId beforeBufferId = sourceModel()->data(source_child, NetworkModel::BufferIdRole).value<BufferId>();
-                pos = config()->bufferList().indexOf(beforeBufferId);
+                pos = config()->bufferIndex(beforeBufferId);
                 if (_sortOrder == Qt::DescendingOrder)
                     pos++;
             }
@@ -243,8 +243,8 @@ bool BufferViewFilter::dropMimeData(const QMimeData *data, Qt::DropAction action
                     pos = 0;
             }
 
-            if (config()->bufferList().contains(bufferId) && !config()->sortAlphabetically()) {
-                if (config()->bufferList().indexOf(bufferId) < pos)
+            if (config()->containsBuffer(bufferId) && !config()->sortAlphabetically()) {
+                if (config()->bufferIndex(bufferId) < pos)
                     pos--;
                 ClientBufferViewConfig *clientConf = qobject_cast<ClientBufferViewConfig *>(config());
                 if (!clientConf || !clientConf->isLocked())
@@ -271,7 +271,7 @@ void BufferViewFilter::sort(int column, Qt::SortOrder order)
 
 void BufferViewFilter::addBuffer(const BufferId &bufferId) const
 {
-    if (!config() || config()->bufferList().contains(bufferId))
+    if (!config() || config()->containsBuffer(bufferId))
         return;
 
     int pos = config()->bufferList().count();
@@ -331,7 +331,7 @@ bool BufferViewFilter::filterAcceptBuffer(const QModelIndex &source_bufferIndex)
 
     int activityLevel = sourceModel()->data(source_bufferIndex, NetworkModel::BufferActivityRole).toInt();
 
-    if (!config()->bufferList().contains(bufferId) && !_editMode) {
+    if (!config()->containsBuffer(bufferId) && !_editMode) {
         // add the buffer if...
         if (config()->isInitialized()
             && !config()->removedBuffers().contains(bufferId) // it hasn't been manually removed and either
@@ -432,8 +432,8 @@ bool BufferViewFilter::bufferLessThan(const QModelIndex &source_left, const QMod
     BufferId leftBufferId = sourceModel()->data(source_left, NetworkModel::BufferIdRole).value<BufferId>();
     BufferId rightBufferId = sourceModel()->data(source_right, NetworkModel::BufferIdRole).value<BufferId>();
     if (config()) {
-        int leftPos = config()->bufferList().indexOf(leftBufferId);
-        int rightPos = config()->bufferList().indexOf(rightBufferId);
+        int leftPos = config()->bufferIndex(leftBufferId);
+        int rightPos = config()->bufferIndex(rightBufferId);
         if (leftPos == -1 && rightPos == -1)
             return QSortFilterProxyModel::lessThan(source_left, source_right);
         if (leftPos == -1 || rightPos == -1)
@@ -491,7 +491,7 @@ QVariant BufferViewFilter::checkedState(const QModelIndex &index) const
     if (_toRemove.contains(bufferId))
         return Qt::Unchecked;
 
-    if (config()->bufferList().contains(bufferId))
+    if (config()->containsBuffer(bufferId))
         return Qt::Checked;
 
     if (config()->temporarilyRemovedBuffers().contains(bufferId))
@@ -27,6 +27,7 @@
 #include "multilineedit.h"
 #include "network.h"
 #include "networkmodel.h"
+#include "tabcompletionindex.h"
 #include "uisettings.h"
 #include "action.h"
 #include "actioncollection.h"
@@ -83,12 +84,13 @@ void TabCompleter::buildCompletionList()
     QString tabAbbrev = _lineEdit->text().left(_lineEdit->cursorPosition()).section(QRegExp("[^#\\w\\d-_\\[\\]{}|`^.\\\\]"), -1, -1);
     QRegExp regex(QString("^[-_\\[\\]{}|`^.\\\\]*").append(QRegExp::escape(tabAbbrev)), Qt::CaseInsensitive);
 
-    // channel completion - add all channels of the current network to the map
+    // channel completion - add all matching channels of the current network to the map
     if (tabAbbrev.startsWith('#')) {
         _completionType = ChannelTab;
-        foreach(IrcChannel *ircChannel, _currentNetwork->ircChannels()) {
-            if (regex.indexIn(ircChannel->name()) > -1)
-                _completionMap[ircChannel->name()] = ircChannel->name();
+        Network *network = const_cast<Network *>(_currentNetwork);
+        foreach(QObject *match, TabCompletionIndex::forNetwork(network)->matches(tabAbbrev)) {
+            IrcChannel *ircChannel = static_cast<IrcChannel *>(match);
+            _completionMap[ircChannel->name()] = ircChannel->name();
         }
     }
     else {
@@ -100,9 +102,10 @@ void TabCompleter::buildCompletionList()
             IrcChannel *channel = _currentNetwork->ircChannel(_currentBufferName);
             if (!channel)
                 return;
-            foreach(IrcUser *ircUser, channel->ircUsers()) {
-                if (regex.indexIn(ircUser->nick()) > -1)
-                    _completionMap[ircUser->nick().toLower()] = ircUser->nick();
+            // the index only yields the matching users, so we don't have to scan the whole channel
+            foreach(QObject *match, TabCompletionIndex::forChannel(channel)->matches(tabAbbrev)) {
+                IrcUser *ircUser = static_cast<IrcUser *>(match);
+                _completionMap[CompletionKey(ircUser->nick().toLower(), ircUser)] = ircUser->nick();
             }
         }
         break;
@@ -195,11 +198,11 @@ bool TabCompleter::CompletionKey::operator<(const CompletionKey &other) const
     switch (_completionType) {
     case UserTab:
     {
-        IrcUser *thisUser = _currentNetwork->ircUser(this->contents);
+        IrcUser *thisUser = this->user ? this->user : _currentNetwork->ircUser(this->contents);
         if (thisUser && _currentNetwork->isMe(thisUser))
             return false;
 
-        IrcUser *thatUser = _currentNetwork->ircUser(other.contents);
+        IrcUser *thatUser = other.user ? other.user : _currentNetwork->ircUser(other.contents);
         if (thatUser && _currentNetwork->isMe(thatUser))
             return true;
 
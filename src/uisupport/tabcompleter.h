@@ -54,9 +54,10 @@ public slots:
 private:
 
     struct CompletionKey {
-        inline CompletionKey(const QString &n) { contents = n; }
+        inline CompletionKey(const QString &n, IrcUser *u = 0) { contents = n; user = u; }
         bool operator<(const CompletionKey &other) const;
         QString contents;
+        IrcUser *user;
     };
 
     QPointer<MultiLineEdit> _lineEdit;
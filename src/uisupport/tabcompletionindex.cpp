@@ -0,0 +1,194 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#include "tabcompletionindex.h"
+
+#include "ircchannel.h"
+#include "ircuser.h"
+#include "network.h"
+
+QHash<QObject *, TabCompletionIndex *> TabCompletionIndex::_indexes;
+
+TabCompletionIndex::TabCompletionIndex(const Network *network, QObject *parent)
+    : QObject(parent),
+    _owner(parent),
+    _network(network)
+{
+    _indexes[_owner] = this;
+}
+
+
+TabCompletionIndex::~TabCompletionIndex()
+{
+    _indexes.remove(_owner);
+}
+
+
+TabCompletionIndex *TabCompletionIndex::forChannel(IrcChannel *channel)
+{
+    if (_indexes.contains(channel))
+        return _indexes[channel];
+
+    TabCompletionIndex *index = new TabCompletionIndex(channel->network(), channel);
+    connect(channel, SIGNAL(ircUsersJoined(QList<IrcUser *>)), index, SLOT(addUsers(QList<IrcUser *>)));
+    connect(channel, SIGNAL(ircUserParted(IrcUser *)), index, SLOT(removeUser(IrcUser *)));
+    connect(channel, SIGNAL(ircUserNickSet(IrcUser *, QString)), index, SLOT(renameUser(IrcUser *, QString)));
+    index->addUsers(channel->ircUsers());
+    return index;
+}
+
+
+TabCompletionIndex *TabCompletionIndex::forNetwork(Network *network)
+{
+    if (_indexes.contains(network))
+        return _indexes[network];
+
+    TabCompletionIndex *index = new TabCompletionIndex(network, network);
+    connect(network, SIGNAL(ircChannelAdded(IrcChannel *)), index, SLOT(addChannel(IrcChannel *)));
+    foreach(IrcChannel *channel, network->ircChannels())
+        index->addChannel(channel);
+    return index;
+}
+
+
+QList<QObject *> TabCompletionIndex::matches(const QString &abbreviation) const
+{
+    QList<QObject *> result;
+    QString folded = caseFold(abbreviation);
+    QString prefix = key(abbreviation);
+
+    QMultiMap<QString, QObject *>::const_iterator iter = _index.lowerBound(prefix);
+    while (iter != _index.constEnd() && iter.key().startsWith(prefix)) {
+        // leading special chars may only be skipped in the name, not in the abbreviation
+        QString name = _keys.value(iter.value());
+        int pos = name.indexOf(folded);
+        int i = 0;
+        while (i < pos && isSpecialChar(name.at(i)))
+            i++;
+        if (pos >= 0 && i == pos)
+            result << iter.value();
+        ++iter;
+    }
+    return result;
+}
+
+
+void TabCompletionIndex::addUsers(const QList<IrcUser *> &users)
+{
+    foreach(IrcUser *user, users)
+        insert(user, user->nick());
+}
+
+
+void TabCompletionIndex::removeUser(IrcUser *user)
+{
+    removeObject(user);
+}
+
+
+void TabCompletionIndex::renameUser(IrcUser *user, const QString &nick)
+{
+    removeObject(user);
+    insert(user, nick);
+}
+
+
+void TabCompletionIndex::addChannel(IrcChannel *channel)
+{
+    insert(channel, channel->name());
+}
+
+
+void TabCompletionIndex::removeObject(QObject *object)
+{
+    if (!_keys.contains(object))
+        return;
+
+    _index.remove(key(_keys.take(object)), object);
+    disconnect(object, SIGNAL(destroyed(QObject *)), this, SLOT(removeObject(QObject *)));
+}
+
+
+void TabCompletionIndex::insert(QObject *object, const QString &name)
+{
+    if (_keys.contains(object))
+        return;
+
+    // _keys holds the case-folded name, from which the index key can be derived again
+    QString folded = caseFold(name);
+    _keys[object] = folded;
+    _index.insert(key(folded), object);
+    connect(object, SIGNAL(destroyed(QObject *)), this, SLOT(removeObject(QObject *)));
+}
+
+
+QString TabCompletionIndex::caseFold(const QString &name) const
+{
+    QString folded = name.toLower();
+    QString caseMapping = _network->support("CASEMAPPING").toLower();
+    if (caseMapping == "ascii")
+        return folded;
+
+    // rfc1459 (the default): []\~ are the upper case forms of {}|^
+    bool strict = caseMapping == "strict-rfc1459";
+    for (int i = 0; i < folded.length(); i++) {
+        switch (folded.at(i).unicode()) {
+        case '[':
+            folded[i] = '{';
+            break;
+        case ']':
+            folded[i] = '}';
+            break;
+        case '\\':
+            folded[i] = '|';
+            break;
+        case '~':
+            if (!strict)
+                folded[i] = '^';
+            break;
+        default:
+            break;
+        }
+    }
+    return folded;
+}
+
+
+QString TabCompletionIndex::key(const QString &name) const
+{
+    QString folded = caseFold(name);
+    int i = 0;
+    while (i < folded.length() && isSpecialChar(folded.at(i)))
+        i++;
+    return folded.mid(i);
+}
+
+
+bool TabCompletionIndex::isSpecialChar(const QChar &c)
+{
+    // these may precede the typed abbreviation, e.g. "foo" completes to "_foo_"
+    switch (c.unicode()) {
+    case '-': case '_': case '[': case ']': case '{': case '}':
+    case '|': case '`': case '^': case '.': case '\\':
+        return true;
+    default:
+        return false;
+    }
+}
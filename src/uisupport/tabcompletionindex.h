@@ -0,0 +1,81 @@
+/***************************************************************************
+ *   Copyright (C) 2005-2014 by the Quassel Project                        *
+ *   devel@quassel-irc.org                                                 *
+ *                                                                         *
+ *   This program is free software; you can redistribute it and/or modify  *
+ *   it under the terms of the GNU General Public License as published by  *
+ *   the Free Software Foundation; either version 2 of the License, or     *
+ *   (at your option) version 3.                                           *
+ *                                                                         *
+ *   This program is distributed in the hope that it will be useful,       *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU General Public License for more details.                          *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the                         *
+ *   Free Software Foundation, Inc.,                                       *
+ *   51 Franklin Street, Fifth Floor, Boston, MA  02110-1301, USA.         *
+ ***************************************************************************/
+
+#ifndef TABCOMPLETIONINDEX_H_
+#define TABCOMPLETIONINDEX_H_
+
+#include <QHash>
+#include <QList>
+#include <QMultiMap>
+#include <QObject>
+#include <QString>
+
+class IrcChannel;
+class IrcUser;
+class Network;
+
+//! Sorted index of completion candidates, maintained incrementally
+/** An index either holds the users of a channel or the channels of a network. Entries are keyed
+ *  by their name, case-folded according to the network's CASEMAPPING and stripped of leading
+ *  special characters, so finding all candidates for a prefix is a logarithmic lookup.
+ *  Indexes are created on demand and destroyed together with their channel or network.
+ */
+class TabCompletionIndex : public QObject
+{
+    Q_OBJECT
+
+public:
+    //! Get the index of the users in the given channel, creating it if needed
+    static TabCompletionIndex *forChannel(IrcChannel *channel);
+
+    //! Get the index of the channels in the given network, creating it if needed
+    static TabCompletionIndex *forNetwork(Network *network);
+
+    ~TabCompletionIndex();
+
+    //! Returns the indexed objects (IrcUser or IrcChannel) whose name matches the given abbreviation
+    QList<QObject *> matches(const QString &abbreviation) const;
+
+private slots:
+    void addUsers(const QList<IrcUser *> &users);
+    void removeUser(IrcUser *user);
+    void renameUser(IrcUser *user, const QString &nick);
+    void addChannel(IrcChannel *channel);
+    void removeObject(QObject *object);
+
+private:
+    TabCompletionIndex(const Network *network, QObject *parent);
+
+    QString caseFold(const QString &name) const;
+    QString key(const QString &name) const;
+    void insert(QObject *object, const QString &name);
+
+    static bool isSpecialChar(const QChar &c);
+
+    QObject *_owner;
+    const Network *_network;
+    QMultiMap<QString, QObject *> _index;
+    QHash<QObject *, QString> _keys;
+
+    static QHash<QObject *, TabCompletionIndex *> _indexes;
+};
+
+
+#endif
@@ -19,6 +19,7 @@
  ***************************************************************************/
 
 #include <QApplication>
+#include <QMutexLocker>
 
 #include "buffersettings.h"
 #include "iconloader.h"
@@ -96,8 +97,11 @@ void UiStyle::loadStyleSheet()
 {
     qDeleteAll(_metricsCache);
     _metricsCache.clear();
-    _formatCache.clear();
-    _formats.clear();
+    {
+        QMutexLocker locker(&_formatMutex);
+        _formatCache.clear();
+        _formats.clear();
+    }
 
     UiStyleSettings s;
 
@@ -114,7 +118,11 @@ void UiStyle::loadStyleSheet()
         QApplication::setPalette(parser.palette());
 
         _uiStylePalette = parser.uiStylePalette();
-        _formats = parser.formats();
+        {
+            QMutexLocker locker(&_formatMutex);
+            _formatCache.clear();
+            _formats = parser.formats();
+        }
         _listItemFormats = parser.listItemFormats();
 
         styleSheet = styleSheet.trimmed();
@@ -352,6 +360,8 @@ QTextCharFormat UiStyle::format(quint32 ftype, quint32 label_) const
 
     quint64 label = (quint64)label_ << 32;
 
+    QMutexLocker locker(&_formatMutex);
+
     // check if we have exactly this format readily cached already
     QTextCharFormat fmt = cachedFormat(ftype, label_);
     if (fmt.properties().count())
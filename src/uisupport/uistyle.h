@@ -24,6 +24,7 @@
 #include <QDataStream>
 #include <QFontMetricsF>
 #include <QHash>
+#include <QMutex>
 #include <QTextCharFormat>
 #include <QTextLayout>
 #include <QPalette>
@@ -180,6 +181,7 @@ private:
     QBrush _markerLineBrush;
     QHash<quint64, QTextCharFormat> _formats;
     mutable QHash<quint64, QTextCharFormat> _formatCache;
+    mutable QMutex _formatMutex; // format() is also used from the chat line precomputation threads
     mutable QHash<quint64, QFontMetricsF *> _metricsCache;
     QHash<quint32, QTextCharFormat> _listItemFormats;
     static QHash<QString, FormatType> _formatCodes;